@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include "AudioLatencyController.h"
+
+void CAudioLatencyController::Reset(unsigned int blockCount, unsigned int maxBlockCount)
+{
+	assert(blockCount <= maxBlockCount);
+	m_maxBlockCount = maxBlockCount;
+	m_minBlockCount = std::min<unsigned int>(MIN_BLOCK_COUNT, blockCount);
+	m_blockCount = blockCount;
+	m_stableSampleCount = 0;
+	m_hasStatus = false;
+	m_smoothedQueuedSamples = 0;
+	m_step = STEP_ONE;
+	m_phase = 0;
+	m_lastFrame[0] = 0;
+	m_lastFrame[1] = 0;
+}
+
+unsigned int CAudioLatencyController::GetBlockCount() const
+{
+	return m_blockCount;
+}
+
+void CAudioLatencyController::Update(const CSoundHandler::QUEUE_STATUS& status, unsigned int sampleCount)
+{
+	if(!m_hasStatus)
+	{
+		//First status only gives us a reference for the underrun counter
+		m_hasStatus = true;
+		m_underrunCount = status.underrunCount;
+		m_smoothedQueuedSamples = static_cast<float>(status.queuedSamples);
+		return;
+	}
+
+	if(status.underrunCount != m_underrunCount)
+	{
+		m_underrunCount = status.underrunCount;
+		m_blockCount = std::min(m_blockCount + std::max(m_blockCount / 2, 1U), m_maxBlockCount);
+		m_stableSampleCount = 0;
+	}
+	else
+	{
+		m_stableSampleCount += sampleCount;
+		if(m_stableSampleCount >= SHRINK_DELAY_SAMPLES)
+		{
+			unsigned int shrink = std::max(m_blockCount / 8, 1U);
+			m_blockCount = std::max(m_blockCount - std::min(shrink, m_blockCount), m_minBlockCount);
+			m_stableSampleCount = 0;
+		}
+	}
+
+	//Queue level only changes a whole buffer at a time, smooth it out before steering the rate
+	m_smoothedQueuedSamples += (static_cast<float>(status.queuedSamples) - m_smoothedQueuedSamples) * QUEUE_SMOOTHING;
+	float targetQueuedSamples = static_cast<float>(sampleCount * TARGET_QUEUED_WRITES);
+	float queueError = (m_smoothedQueuedSamples - targetQueuedSamples) / targetQueuedSamples;
+	float rateAdjust = std::clamp(queueError, -1.0f, 1.0f) * MAX_RATE_ADJUST;
+	//Too much audio queued: produce fewer samples than we get
+	m_step = static_cast<uint32>(std::lround(static_cast<float>(STEP_ONE) / (1.0f - rateAdjust)));
+}
+
+unsigned int CAudioLatencyController::Stretch(const int16* input, unsigned int sampleCount, int16* output)
+{
+	assert((sampleCount % 2) == 0);
+	unsigned int frameCount = sampleCount / 2;
+	if(frameCount == 0) return 0;
+
+	//Output lags input by one frame so that we can interpolate across writes
+	uint32 endPhase = frameCount << STEP_PRECISION;
+	unsigned int outputSampleCount = 0;
+	for(; m_phase < endPhase; m_phase += m_step)
+	{
+		unsigned int frameIndex = m_phase >> STEP_PRECISION;
+		int64 alpha = m_phase & (STEP_ONE - 1);
+		const int16* frame0 = (frameIndex == 0) ? m_lastFrame : input + ((frameIndex - 1) * 2);
+		const int16* frame1 = input + (frameIndex * 2);
+		for(unsigned int channel = 0; channel < 2; channel++)
+		{
+			int64 sample0 = frame0[channel];
+			int64 sample1 = frame1[channel];
+			output[outputSampleCount++] = static_cast<int16>(sample0 + (((sample1 - sample0) * alpha) >> STEP_PRECISION));
+		}
+	}
+	m_phase -= endPhase;
+	m_lastFrame[0] = input[sampleCount - 2];
+	m_lastFrame[1] = input[sampleCount - 1];
+	assert(outputSampleCount <= GetMaxStretchedSampleCount(sampleCount));
+	return outputSampleCount;
+}
+
+unsigned int CAudioLatencyController::GetMaxStretchedSampleCount(unsigned int sampleCount)
+{
+	//Rate never goes more than MAX_RATE_ADJUST over, keep a bit of margin
+	return sampleCount + (sampleCount / 64) + 4;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Types.h"
+#include "sound/SoundHandler.h"
+
+//Picks how many SPU blocks go in each sound handler write using the handler's queue feedback.
+//Block count grows quickly when playback runs dry and shrinks back slowly once it has been stable
+//for a while. Writes are also stretched or squeezed by a small amount to keep the queue close to
+//its target without audible pitch changes.
+class CAudioLatencyController
+{
+public:
+	void Reset(unsigned int, unsigned int);
+
+	unsigned int GetBlockCount() const;
+
+	//Called before each write with the handler's status and the number of samples about to be written
+	void Update(const CSoundHandler::QUEUE_STATUS&, unsigned int);
+
+	//Resamples interleaved stereo samples at the current rate, returns the number of samples produced
+	unsigned int Stretch(const int16*, unsigned int, int16*);
+
+	static unsigned int GetMaxStretchedSampleCount(unsigned int);
+
+private:
+	enum
+	{
+		MIN_BLOCK_COUNT = 4,
+		TARGET_QUEUED_WRITES = 2,
+		SHRINK_DELAY_SAMPLES = 44100 * 2 * 10,
+		STEP_PRECISION = 16,
+		STEP_ONE = 1 << STEP_PRECISION,
+	};
+
+	static constexpr float MAX_RATE_ADJUST = 0.01f;
+	static constexpr float QUEUE_SMOOTHING = 0.125f;
+
+	unsigned int m_blockCount = 0;
+	unsigned int m_minBlockCount = 0;
+	unsigned int m_maxBlockCount = 0;
+	unsigned int m_underrunCount = 0;
+	unsigned int m_stableSampleCount = 0;
+	bool m_hasStatus = false;
+	float m_smoothedQueuedSamples = 0;
+
+	//Input frames advanced for each output frame, in fixed point
+	uint32 m_step = STEP_ONE;
+	uint32 m_phase = 0;
+	int16 m_lastFrame[2] = {};
+};
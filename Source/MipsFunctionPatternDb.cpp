@@ -102,8 +102,7 @@ bool CMipsFunctionPatternDb::ParsePatternItem(const char* source, PATTERNITEM& r
 	{
 		result.mask = 0xFFFFFFFF;
 		result.value = 0;
-		sscanf(source, "%x", &result.value);
-		if(result.value == 0)
+		if(sscanf(source, "%x", &result.value) != 1)
 		{
 			return false;
 		}
@@ -111,6 +110,40 @@ bool CMipsFunctionPatternDb::ParsePatternItem(const char* source, PATTERNITEM& r
 	return true;
 }
 
+static bool IsNopItem(const CMipsFunctionPatternDb::PATTERNITEM& item)
+{
+	return (item.mask == 0xFFFFFFFF) && (item.value == 0);
+}
+
+static bool IsBranchWithOffset(uint32 opcode)
+{
+	switch(opcode >> 26)
+	{
+	case 0x01:
+	{
+		//REGIMM: BLTZ, BGEZ, BLTZL, BGEZL and their AL versions
+		uint32 rt = (opcode >> 16) & 0x1F;
+		return (rt <= 0x03) || ((rt >= 0x10) && (rt <= 0x13));
+	}
+	case 0x04: //BEQ
+	case 0x05: //BNE
+	case 0x06: //BLEZ
+	case 0x07: //BGTZ
+	case 0x14: //BEQL
+	case 0x15: //BNEL
+	case 0x16: //BLEZL
+	case 0x17: //BGTZL
+		return true;
+	case 0x10:
+	case 0x11:
+	case 0x12:
+		//BCzF, BCzT and their likely versions
+		return ((opcode >> 21) & 0x1F) == 0x08;
+	default:
+		return false;
+	}
+}
+
 bool CMipsFunctionPatternDb::Pattern::Matches(uint32* text, uint32 textSize) const
 {
 	textSize /= 4;
@@ -118,18 +151,40 @@ bool CMipsFunctionPatternDb::Pattern::Matches(uint32* text, uint32 textSize) con
 
 	unsigned int itemIndex = 0;
 	unsigned int textIndex = 0;
-	unsigned int matchCount = 0;
 	while(1)
 	{
+		while((itemIndex != items.size()) && IsNopItem(items[itemIndex]))
+		{
+			itemIndex++;
+		}
 		if(itemIndex == items.size()) break;
-		if(textIndex == textSize) break;
+		if(textIndex == textSize) return false;
 		uint32 srcValue = text[textIndex++];
 		if(textIndex != 1 && srcValue == 0) continue;
 		const PATTERNITEM& item(items[itemIndex++]);
 		srcValue &= item.mask;
 		if(srcValue != item.value) return false;
-		matchCount++;
 	}
 
-	return (matchCount == items.size());
+	return true;
+}
+
+bool CMipsFunctionPatternDb::Pattern::MatchesExactly(uint32* text, uint32 textSize) const
+{
+	textSize /= 4;
+	if(textSize < items.size()) return false;
+
+	for(uint32 itemIndex = 0; itemIndex < items.size(); itemIndex++)
+	{
+		const PATTERNITEM& item(items[itemIndex]);
+		uint32 srcValue = text[itemIndex];
+		if((srcValue & item.mask) != item.value) return false;
+		if(((item.mask & 0xFFFF) == 0) && IsBranchWithOffset(srcValue))
+		{
+			int32 target = static_cast<int32>(itemIndex + 1) + static_cast<int16>(srcValue & 0xFFFF);
+			if((target < 0) || (target >= static_cast<int32>(items.size()))) return false;
+		}
+	}
+
+	return true;
 }
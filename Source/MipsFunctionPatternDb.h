@@ -20,8 +20,13 @@ public:
 	public:
 		typedef std::vector<PATTERNITEM> ItemArray;
 
+		//Ignores NOPs, in the pattern as well as in the text
 		bool Matches(uint32*, uint32) const;
 
+		//Every item must match the instruction at the same position, NOPs included.
+		//Branch offsets left out of the pattern must still land inside the function.
+		bool MatchesExactly(uint32*, uint32) const;
+
 		std::string name;
 		ItemArray items;
 	};
@@ -94,7 +94,11 @@ CPS2VM::CPS2VM()
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE, true);
 	ReloadFrameRateLimit();
 
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_IPU_REFERENCEIDCT, false);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_EE_HLEFUNCTIONS, true);
+
 	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_AUDIO_SPUBLOCKCOUNT, 100);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_AUDIO_ADAPTIVELATENCY, false);
 	ReloadSpuBlockCountImpl();
 
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_ARCADE_IO_SERVER_ENABLED, false);
@@ -454,6 +458,32 @@ void CPS2VM::SaveDebugTags(const char* packageName)
 	}
 }
 
+void CPS2VM::StartSpuCapture()
+{
+	m_mailBox.SendCall([this]() { m_iop->m_spu2.StartCapture(); }, true);
+}
+
+void CPS2VM::StopSpuCapture(const fs::path& capturePath)
+{
+	std::exception_ptr exception;
+	m_mailBox.SendCall([this, &capturePath, &exception]() {
+		if(!m_iop->m_spu2.IsCapturing()) return;
+		try
+		{
+			m_iop->m_spu2.StopCapture(capturePath, m_iop->m_spuRam, PS2::SPU_RAM_SIZE);
+		}
+		catch(...)
+		{
+			exception = std::current_exception();
+		}
+	},
+	                   true);
+	if(exception)
+	{
+		std::rethrow_exception(exception);
+	}
+}
+
 #endif
 
 //////////////////////////////////////////////////
@@ -490,6 +520,10 @@ void CPS2VM::ResetVM()
 	m_ee->Reset(m_eeRamSize);
 	m_iop->Reset();
 
+	bool useReferenceIdct = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_IPU_REFERENCEIDCT);
+	m_ee->m_ipu.SetIdctImplementation(useReferenceIdct ? CIPU::IDCT_IMPLEMENTATION_REFERENCE : CIPU::IDCT_IMPLEMENTATION_FAST);
+	m_ee->m_os->SetHleFunctionsEnabled(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_EE_HLEFUNCTIONS));
+
 	if(m_ee->m_gs != NULL)
 	{
 		m_ee->m_gs->Reset();
@@ -640,6 +674,11 @@ void CPS2VM::ResumeImpl()
 	m_iop->m_cpu.m_executor->DisableBreakpointsOnce();
 	m_ee->m_VU1.m_executor->DisableBreakpointsOnce();
 #endif
+	if(m_soundHandler && m_adaptiveAudioLatency)
+	{
+		//Playback ran dry while paused, start over so that it doesn't count as an underrun
+		m_soundHandler->Reset();
+	}
 	m_nStatus = RUNNING;
 }
 
@@ -702,6 +741,12 @@ void CPS2VM::ReloadSpuBlockCountImpl()
 	assert(spuBlockCount <= MAX_BLOCK_COUNT);
 	spuBlockCount = std::min<int>(spuBlockCount, MAX_BLOCK_COUNT);
 	m_spuBlockCount = spuBlockCount;
+	m_adaptiveAudioLatency = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_AUDIO_ADAPTIVELATENCY);
+	m_audioLatencyController.Reset(m_spuBlockCount, MAX_BLOCK_COUNT);
+	if(m_adaptiveAudioLatency && m_stretchedSamples.empty())
+	{
+		m_stretchedSamples.resize(CAudioLatencyController::GetMaxStretchedSampleCount(BLOCK_SIZE * MAX_BLOCK_COUNT));
+	}
 }
 
 void CPS2VM::DestroySoundHandlerImpl()
@@ -779,6 +824,9 @@ void CPS2VM::UpdateSpu()
 	int16* samplesSpu0 = m_samples + blockOffset;
 
 	m_iop->m_spuCore0.Render(samplesSpu0, BLOCK_SIZE);
+#ifdef DEBUGGER_INCLUDED
+	m_iop->m_spu2.AdvanceCapture(BLOCK_SIZE / 2);
+#endif
 
 	if(m_iop->m_spuCore1.IsEnabled())
 	{
@@ -801,7 +849,20 @@ void CPS2VM::UpdateSpu()
 		if(m_soundHandler)
 		{
 			m_soundHandler->RecycleBuffers();
-			m_soundHandler->Write(m_samples, BLOCK_SIZE * m_spuBlockCount, DST_SAMPLE_RATE);
+			CSoundHandler::QUEUE_STATUS queueStatus;
+			unsigned int sampleCount = BLOCK_SIZE * m_spuBlockCount;
+			if(m_adaptiveAudioLatency && m_soundHandler->GetQueueStatus(queueStatus))
+			{
+				m_audioLatencyController.Update(queueStatus, sampleCount);
+				unsigned int stretchedSampleCount = m_audioLatencyController.Stretch(m_samples, sampleCount, m_stretchedSamples.data());
+				m_soundHandler->Write(m_stretchedSamples.data(), stretchedSampleCount, DST_SAMPLE_RATE);
+				//New block count applies to the next write
+				m_spuBlockCount = m_audioLatencyController.GetBlockCount();
+			}
+			else
+			{
+				m_soundHandler->Write(m_samples, sampleCount, DST_SAMPLE_RATE);
+			}
 		}
 		m_currentSpuBlock = 0;
 	}
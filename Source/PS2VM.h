@@ -2,6 +2,7 @@
 
 #include <thread>
 #include <future>
+#include <vector>
 #include "filesystem_def.h"
 #include "Types.h"
 #include "MIPS.h"
@@ -14,6 +15,7 @@
 #include "iop/Iop_SubSystem.h"
 #include "sound/SoundHandler.h"
 #include "FrameLimiter.h"
+#include "AudioLatencyController.h"
 #include "Profiler.h"
 
 class CPS2VM : public CVirtualMachine
@@ -83,6 +85,9 @@ public:
 	fs::path MakeDebugTagsPackagePath(const char*);
 	void LoadDebugTags(const char*);
 	void SaveDebugTags(const char*);
+
+	void StartSpuCapture();
+	void StopSpuCapture(const fs::path&);
 #endif
 
 	void ReportGunPosition(float, float);
@@ -191,6 +196,9 @@ private:
 	int16 m_samples[BLOCK_SIZE * MAX_BLOCK_COUNT];
 	int m_currentSpuBlock = 0;
 	int m_spuBlockCount = 0;
+	bool m_adaptiveAudioLatency = false;
+	CAudioLatencyController m_audioLatencyController;
+	std::vector<int16> m_stretchedSamples;
 	CSoundHandler* m_soundHandler = nullptr;
 
 	CScreenPositionListener* m_gunListener = nullptr;
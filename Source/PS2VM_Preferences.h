@@ -13,7 +13,10 @@
 #define PREF_PS2_ARCADE_IO_SERVER_PORT ("ps2.arcade.ioserver.port")
 
 #define PREF_PS2_LIMIT_FRAMERATE ("ps2.limitframerate")
+#define PREF_PS2_IPU_REFERENCEIDCT ("ps2.ipu.referenceidct")
+#define PREF_PS2_EE_HLEFUNCTIONS ("ps2.ee.hlefunctions")
 
 #define PREF_AUDIO_SPUBLOCKCOUNT ("audio.spublockcount")
+#define PREF_AUDIO_ADAPTIVELATENCY ("audio.adaptivelatency")
 
 #define PREF_SYSTEM_LANGUAGE ("system.language")
@@ -0,0 +1,139 @@
+#include <cassert>
+#include <algorithm>
+#include "ThreadPriorityIndex.h"
+#include "BitManip.h"
+
+CThreadPriorityIndex::CThreadPriorityIndex(uint32 maxThreadId, const LinkAccessor& getLink, const PriorityAccessor& getPriority)
+    : m_getLink(getLink)
+    , m_getPriority(getPriority)
+    , m_prev(maxThreadId + 1, THREAD_NONE)
+    , m_priority(maxThreadId + 1, 0)
+{
+	std::fill(std::begin(m_priorityTail), std::end(m_priorityTail), 0);
+	std::fill(std::begin(m_priorityBitmap), std::end(m_priorityBitmap), 0);
+}
+
+void CThreadPriorityIndex::Rebuild()
+{
+	std::fill(std::begin(m_prev), std::end(m_prev), THREAD_NONE);
+	std::fill(std::begin(m_priority), std::end(m_priority), 0);
+	std::fill(std::begin(m_priorityTail), std::end(m_priorityTail), 0);
+	std::fill(std::begin(m_priorityBitmap), std::end(m_priorityBitmap), 0);
+
+	uint32 prevThreadId = 0;
+	for(uint32 threadId = m_getLink(0); threadId != 0; threadId = m_getLink(threadId))
+	{
+		assert(threadId < m_prev.size());
+		AddToIndex(threadId, prevThreadId, ClampPriority(m_getPriority(threadId)));
+		prevThreadId = threadId;
+	}
+}
+
+bool CThreadPriorityIndex::IsLinked(uint32 threadId) const
+{
+	assert(threadId < m_prev.size());
+	return m_prev[threadId] != THREAD_NONE;
+}
+
+void CThreadPriorityIndex::Link(uint32 threadId)
+{
+	assert((threadId != 0) && (threadId < m_prev.size()));
+	assert(!IsLinked(threadId));
+	assert(m_getPriority(threadId) < PRIORITY_COUNT);
+	uint32 priority = ClampPriority(m_getPriority(threadId));
+
+	uint32 prevThreadId = FindPredecessor(priority);
+	uint32& prevLink = m_getLink(prevThreadId);
+	uint32 nextThreadId = prevLink;
+	m_getLink(threadId) = nextThreadId;
+	prevLink = threadId;
+	if(nextThreadId != 0)
+	{
+		m_prev[nextThreadId] = threadId;
+	}
+
+	AddToIndex(threadId, prevThreadId, priority);
+}
+
+void CThreadPriorityIndex::Unlink(uint32 threadId)
+{
+	assert((threadId != 0) && (threadId < m_prev.size()));
+	uint32 prevThreadId = m_prev[threadId];
+	if(prevThreadId == THREAD_NONE)
+	{
+		return;
+	}
+
+	uint32& threadLink = m_getLink(threadId);
+	uint32 nextThreadId = threadLink;
+	uint32& prevLink = m_getLink(prevThreadId);
+	assert(prevLink == threadId);
+	prevLink = nextThreadId;
+	if(nextThreadId != 0)
+	{
+		m_prev[nextThreadId] = prevThreadId;
+	}
+
+	uint32 priority = m_priority[threadId];
+	if(m_priorityTail[priority] == threadId)
+	{
+		if((prevThreadId != 0) && (m_priority[prevThreadId] == priority))
+		{
+			m_priorityTail[priority] = prevThreadId;
+		}
+		else
+		{
+			m_priorityTail[priority] = 0;
+			m_priorityBitmap[priority / BITMAP_WORD_BITS] &= ~(1U << (priority % BITMAP_WORD_BITS));
+		}
+	}
+
+	threadLink = 0;
+	m_prev[threadId] = THREAD_NONE;
+}
+
+uint32 CThreadPriorityIndex::FindFirst(uint32 priority) const
+{
+	if(priority >= PRIORITY_COUNT) return 0;
+	if((m_priorityBitmap[priority / BITMAP_WORD_BITS] & (1U << (priority % BITMAP_WORD_BITS))) == 0) return 0;
+
+	//First thread of that priority follows the last thread of a lower priority
+	uint32 prevThreadId = (priority == 0) ? 0 : FindPredecessor(priority - 1);
+	uint32 threadId = m_getLink(prevThreadId);
+	assert(m_priority[threadId] == priority);
+	return threadId;
+}
+
+void CThreadPriorityIndex::AddToIndex(uint32 threadId, uint32 prevThreadId, uint32 priority)
+{
+	m_prev[threadId] = prevThreadId;
+	m_priority[threadId] = priority;
+	m_priorityTail[priority] = threadId;
+	m_priorityBitmap[priority / BITMAP_WORD_BITS] |= (1U << (priority % BITMAP_WORD_BITS));
+}
+
+uint32 CThreadPriorityIndex::FindPredecessor(uint32 priority) const
+{
+	//Returns the last linked thread with a priority lower or equal to the one specified, 0 if there's none
+	assert(priority < PRIORITY_COUNT);
+	for(int word = priority / BITMAP_WORD_BITS; word >= 0; word--)
+	{
+		uint32 bits = m_priorityBitmap[word];
+		if(word == static_cast<int>(priority / BITMAP_WORD_BITS))
+		{
+			uint32 shift = (BITMAP_WORD_BITS - 1) - (priority % BITMAP_WORD_BITS);
+			bits = (bits << shift) >> shift;
+		}
+		if(bits != 0)
+		{
+			uint32 foundPriority = (word * BITMAP_WORD_BITS) + ((BITMAP_WORD_BITS - 1) - __builtin_clz(bits));
+			return m_priorityTail[foundPriority];
+		}
+	}
+	return 0;
+}
+
+uint32 CThreadPriorityIndex::ClampPriority(uint32 priority)
+{
+	return std::min<uint32>(priority, PRIORITY_COUNT - 1);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "Types.h"
+
+//Host side index over a thread list kept in guest memory and sorted by priority (lower values first).
+//Keeps a back link per thread and the last linked thread of every priority so that linking and
+//unlinking don't need to walk the list. The list in guest memory stays the source of truth, the
+//index must be rebuilt when that memory is replaced (ie.: state load).
+class CThreadPriorityIndex
+{
+public:
+	//Returns a reference to the next thread id stored in a thread, thread 0 is the list head
+	typedef std::function<uint32&(uint32)> LinkAccessor;
+	typedef std::function<uint32(uint32)> PriorityAccessor;
+
+	enum
+	{
+		PRIORITY_COUNT = 128,
+	};
+
+	CThreadPriorityIndex(uint32, const LinkAccessor&, const PriorityAccessor&);
+
+	void Rebuild();
+
+	bool IsLinked(uint32) const;
+
+	//Thread goes after every linked thread with the same or a lower priority value
+	void Link(uint32);
+	void Unlink(uint32);
+
+	//Returns the first linked thread with the specified priority, 0 if there's none
+	uint32 FindFirst(uint32) const;
+
+private:
+	enum
+	{
+		THREAD_NONE = 0xFFFFFFFF,
+		BITMAP_WORD_BITS = 32,
+	};
+
+	void AddToIndex(uint32, uint32, uint32);
+	uint32 FindPredecessor(uint32) const;
+	static uint32 ClampPriority(uint32);
+
+	LinkAccessor m_getLink;
+	PriorityAccessor m_getPriority;
+
+	std::vector<uint32> m_prev;
+	std::vector<uint32> m_priority;
+	uint32 m_priorityTail[PRIORITY_COUNT];
+	uint32 m_priorityBitmap[PRIORITY_COUNT / BITMAP_WORD_BITS];
+};
@@ -11,6 +11,48 @@ void CEeBasicBlock::SetIsIdleLoopBlock()
 	m_isIdleLoopBlock = true;
 }
 
+void CEeBasicBlock::SetHleFunction(Ee::CHleFunctions::Function hleFunction)
+{
+	m_hleFunction = hleFunction;
+}
+
+void CEeBasicBlock::CompileRange(CMipsJitter* jitter)
+{
+	if(!m_hleFunction)
+	{
+		CBasicBlock::CompileRange(jitter);
+		return;
+	}
+
+	//Run the native implementation, it returns to the caller by itself.
+	//If it can't handle the call, fall back to the guest code.
+	m_context.m_pArch->SetCompileHints(m_blockCompileHints);
+
+	CompileProlog(jitter);
+	jitter->MarkFirstBlockLabel();
+
+	jitter->PushCtx();
+	jitter->Call(reinterpret_cast<void*>(m_hleFunction), 1, Jitter::CJitter::RETURN_VALUE_32);
+
+	jitter->PushCst(0);
+	jitter->BeginIf(Jitter::CONDITION_EQ);
+	{
+		for(uint32 address = m_begin; address <= m_end; address += 4)
+		{
+			m_context.m_pArch->CompileInstruction(
+			    address,
+			    jitter,
+			    &m_context, address - m_begin);
+			//Sanity check
+			assert(jitter->IsStackEmpty());
+		}
+	}
+	jitter->EndIf();
+
+	jitter->MarkLastBlockLabel();
+	CompileEpilog(jitter, false);
+}
+
 void CEeBasicBlock::CompileProlog(CMipsJitter* jitter)
 {
 	if(m_fpRoundingMode != DEFAULT_FP_ROUNDING_MODE)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "BasicBlock.h"
+#include "Ee_HleFunctions.h"
 
 class CEeBasicBlock : public CBasicBlock
 {
@@ -9,6 +10,9 @@ public:
 
 	void SetFpRoundingMode(Jitter::CJitter::ROUNDINGMODE);
 	void SetIsIdleLoopBlock();
+	void SetHleFunction(Ee::CHleFunctions::Function);
+
+	void CompileRange(CMipsJitter*) override;
 
 protected:
 	void CompileProlog(CMipsJitter*) override;
@@ -21,4 +25,5 @@ private:
 	Jitter::CJitter::ROUNDINGMODE m_fpRoundingMode = DEFAULT_FP_ROUNDING_MODE;
 
 	bool m_isIdleLoopBlock = false;
+	Ee::CHleFunctions::Function m_hleFunction = nullptr;
 };
@@ -60,6 +60,11 @@ void CEeExecutor::SetIdleLoopBlocks(IdleLoopBlockMap idleLoopBlocks)
 	m_idleLoopBlocks = std::move(idleLoopBlocks);
 }
 
+void CEeExecutor::SetHleFunctionBlocks(HleFunctionBlockMap hleFunctionBlocks)
+{
+	m_hleFunctionBlocks = std::move(hleFunctionBlocks);
+}
+
 void CEeExecutor::AddExceptionHandler()
 {
 	assert(g_eeExecutor == nullptr);
@@ -133,6 +138,7 @@ void CEeExecutor::Reset()
 	m_cachedBlocks.clear();
 	m_blockFpRoundingModes.clear();
 	m_idleLoopBlocks.clear();
+	m_hleFunctionBlocks.clear();
 	CGenericMipsExecutor::Reset();
 }
 
@@ -191,7 +197,18 @@ BasicBlockPtr CEeExecutor::BlockFactory(CMIPS& context, uint32 start, uint32 end
 
 	bool fpUseAccurateAddSub = (m_blockFpUseAccurateAddSub.count(start) != 0);
 
-	bool isCacheableBlock = !hasBreakpoint && !blockFpRoundingModeOverride.has_value() && !isIdleLoopBlockOverride && !fpUseAccurateAddSub;
+	//Make sure the function is still there, the executable might have been replaced since it was found
+	Ee::CHleFunctions::Function hleFunction = nullptr;
+	if(auto hleFunctionIterator = m_hleFunctionBlocks.find(start);
+	   (hleFunctionIterator != std::end(m_hleFunctionBlocks)) && !hasBreakpoint)
+	{
+		if(Ee::CHleFunctions::IsFunctionAt(hleFunctionIterator->second, m_ram, PS2::EE_RAM_SIZE, start))
+		{
+			hleFunction = hleFunctionIterator->second.function;
+		}
+	}
+
+	bool isCacheableBlock = !hasBreakpoint && !blockFpRoundingModeOverride.has_value() && !isIdleLoopBlockOverride && !fpUseAccurateAddSub && !hleFunction;
 	if(isCacheableBlock)
 	{
 		auto blockIterator = m_cachedBlocks.find(blockKey);
@@ -226,6 +243,12 @@ BasicBlockPtr CEeExecutor::BlockFactory(CMIPS& context, uint32 start, uint32 end
 	{
 		result->AddBlockCompileHints(CMA_EE::COMPILEHINT_FPU_USE_ACCURATE_ADD_SUB);
 	}
+	if(hleFunction)
+	{
+		result->SetHleFunction(hleFunction);
+		//Native function returns to its caller, links to the guest code's successors would be wrong
+		result->SetRecycleCount(RECYCLE_NOLINK_THRESHOLD);
+	}
 
 	result->Compile();
 	if(isCacheableBlock)
@@ -14,6 +14,7 @@
 #include <optional>
 
 #include "../GenericMipsExecutor.h"
+#include "Ee_HleFunctions.h"
 
 class CEeExecutor : public CGenericMipsExecutor<BlockLookupTwoWay>
 {
@@ -22,6 +23,7 @@ public:
 	using IdleLoopBlockMap = std::map<uint32, std::optional<CachedBlockKey>>;
 	using BlockFpUseAccurateAddSubSet = std::set<uint32>;
 	using BlockFpRoundingModeMap = std::map<uint32, Jitter::CJitter::ROUNDINGMODE>;
+	using HleFunctionBlockMap = Ee::CHleFunctions::FunctionMap;
 
 	CEeExecutor(CMIPS&, uint8*);
 	virtual ~CEeExecutor() = default;
@@ -29,6 +31,7 @@ public:
 	void SetBlockFpRoundingModes(BlockFpRoundingModeMap);
 	void SetBlockFpUseAccurateAddSub(BlockFpUseAccurateAddSubSet);
 	void SetIdleLoopBlocks(IdleLoopBlockMap);
+	void SetHleFunctionBlocks(HleFunctionBlockMap);
 
 	void AddExceptionHandler();
 	void RemoveExceptionHandler();
@@ -47,6 +50,7 @@ private:
 	IdleLoopBlockMap m_idleLoopBlocks;
 	BlockFpUseAccurateAddSubSet m_blockFpUseAccurateAddSub;
 	BlockFpRoundingModeMap m_blockFpRoundingModes;
+	HleFunctionBlockMap m_hleFunctionBlocks;
 
 	uint8* m_ram = nullptr;
 	size_t m_pageSize = 0;
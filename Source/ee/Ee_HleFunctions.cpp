@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "Ee_HleFunctions.h"
+#include "MIPS.h"
+#include "PtrStream.h"
+#include "xml/Parser.h"
+#include "EeFunctionsXml.h"
+
+using namespace Ee;
+
+const CMipsFunctionPatternDb& CHleFunctions::GetPatternDb()
+{
+	static const CMipsFunctionPatternDb patternDb = []() {
+		Framework::CPtrStream stream(g_eeFunctionsXml, sizeof(g_eeFunctionsXml));
+		auto document = Framework::Xml::CParser::ParseDocument(stream);
+		assert(document);
+		return CMipsFunctionPatternDb(document->Select("Functions"));
+	}();
+	return patternDb;
+}
+
+CHleFunctions::Function CHleFunctions::GetFunction(const std::string& name)
+{
+	if(name == "memcpy") return &Memcpy;
+	if(name == "memset") return &Memset;
+	return nullptr;
+}
+
+CHleFunctions::FunctionMap CHleFunctions::FindFunctions(uint8* ram, uint32 ramSize, uint32 start, uint32 end)
+{
+	FunctionMap result;
+	end = std::min<uint32>(end, ramSize);
+	for(const auto& pattern : GetPatternDb().GetPatterns())
+	{
+		//Only some of the patterns have a native implementation
+		auto function = GetFunction(pattern.name);
+		if(!function) continue;
+		for(uint32 address = (start & ~0x03); (address + 4) <= end; address += 4)
+		{
+			auto text = reinterpret_cast<uint32*>(ram + address);
+			if(!pattern.MatchesExactly(text, end - address)) continue;
+			result.emplace(address, HLE_FUNCTION{function, &pattern});
+		}
+	}
+	return result;
+}
+
+bool CHleFunctions::IsFunctionAt(const HLE_FUNCTION& hleFunction, uint8* ram, uint32 ramSize, uint32 address)
+{
+	assert(hleFunction.pattern);
+	if(address >= ramSize) return false;
+	auto text = reinterpret_cast<uint32*>(ram + address);
+	return hleFunction.pattern->MatchesExactly(text, ramSize - address);
+}
+
+uint8* CHleFunctions::GetContiguousMemory(CMIPS* context, uint32 address, uint32 size)
+{
+	assert(size != 0);
+
+	//Only handle memory the JIT would access directly. Also leave TLB checks to the guest code.
+	if(context->m_pageLookup == nullptr) return nullptr;
+	if(context->m_TLBExceptionChecker != nullptr) return nullptr;
+
+	uint64 endAddress = static_cast<uint64>(address) + size;
+	if(endAddress > 0x100000000ULL) return nullptr;
+
+	uint32 firstPage = address / MIPS_PAGE_SIZE;
+	uint32 lastPage = static_cast<uint32>((endAddress - 1) / MIPS_PAGE_SIZE);
+	auto firstPageMemory = reinterpret_cast<uint8*>(context->m_pageLookup[firstPage]);
+	if(firstPageMemory == nullptr) return nullptr;
+	for(uint32 page = firstPage + 1; page <= lastPage; page++)
+	{
+		if(context->m_pageLookup[page] != (firstPageMemory + ((page - firstPage) * MIPS_PAGE_SIZE)))
+		{
+			return nullptr;
+		}
+	}
+	return firstPageMemory + (address % MIPS_PAGE_SIZE);
+}
+
+bool CHleFunctions::HasSimpleSize(CMIPS* context)
+{
+	//Guest code compares the whole 64-bits register against its thresholds
+	return (context->m_State.nGPR[CMIPS::A2].nV[1] == 0);
+}
+
+void CHleFunctions::ReturnToCaller(CMIPS* context, uint32 cycles)
+{
+	//Both functions return their first argument
+	context->m_State.nGPR[CMIPS::V0].nD0 = context->m_State.nGPR[CMIPS::A0].nD0;
+	context->m_State.nDelayedJumpAddr = context->m_State.nGPR[CMIPS::RA].nV0;
+	context->m_State.cycleQuota -= cycles;
+}
+
+uint32 CHleFunctions::Memcpy(CMIPS* context)
+{
+	if(!HasSimpleSize(context)) return 0;
+
+	uint32 dstAddress = context->m_State.nGPR[CMIPS::A0].nV0;
+	uint32 srcAddress = context->m_State.nGPR[CMIPS::A1].nV0;
+	uint32 size = context->m_State.nGPR[CMIPS::A2].nV0;
+
+	if(size != 0)
+	{
+		auto dst = GetContiguousMemory(context, dstAddress, size);
+		auto src = GetContiguousMemory(context, srcAddress, size);
+		if((dst == nullptr) || (src == nullptr)) return 0;
+
+		//Guest code copies forward with different access sizes, its result on overlapping buffers is specific to it
+		if((dst < (src + size)) && (src < (dst + size))) return 0;
+
+		memcpy(dst, src, size);
+	}
+
+	//Charge roughly the amount of instructions the guest loops would have executed
+	bool isAligned = ((dstAddress | srcAddress) & 0x0F) == 0;
+	uint32 cycles = isAligned ? (((size / 0x20) * 10) + (((size % 0x20) / 8) * 6) + ((size % 8) * 6)) : (size * 6);
+	ReturnToCaller(context, cycles);
+	return 1;
+}
+
+uint32 CHleFunctions::Memset(CMIPS* context)
+{
+	if(!HasSimpleSize(context)) return 0;
+
+	uint32 dstAddress = context->m_State.nGPR[CMIPS::A0].nV0;
+	uint8 value = static_cast<uint8>(context->m_State.nGPR[CMIPS::A1].nV0);
+	uint32 size = context->m_State.nGPR[CMIPS::A2].nV0;
+
+	if(size != 0)
+	{
+		auto dst = GetContiguousMemory(context, dstAddress, size);
+		if(dst == nullptr) return 0;
+
+		memset(dst, value, size);
+	}
+
+	//Charge roughly the amount of instructions the guest loops would have executed
+	bool isAligned = (dstAddress & 0x0F) == 0;
+	uint32 cycles = isAligned ? (((size / 0x20) * 6) + (((size % 0x20) / 8) * 5) + ((size % 8) * 5)) : (size * 5);
+	ReturnToCaller(context, cycles);
+	return 1;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <map>
+#include "Types.h"
+#include "../MipsFunctionPatternDb.h"
+
+class CMIPS;
+
+namespace Ee
+{
+	//Native implementations of hot library functions statically linked in executables (memcpy, memset).
+	//Functions are recognized with the patterns from ee_functions.xml, matched exactly.
+	class CHleFunctions
+	{
+	public:
+		//Returns 0 if the call can't be handled natively (ie.: memory that isn't RAM or scratchpad,
+		//overlapping buffers), the guest code must be executed instead.
+		typedef uint32 (*Function)(CMIPS*);
+
+		struct HLE_FUNCTION
+		{
+			Function function = nullptr;
+			const CMipsFunctionPatternDb::Pattern* pattern = nullptr;
+		};
+
+		typedef std::map<uint32, HLE_FUNCTION> FunctionMap;
+
+		static FunctionMap FindFunctions(uint8*, uint32, uint32, uint32);
+		static bool IsFunctionAt(const HLE_FUNCTION&, uint8*, uint32, uint32);
+
+	private:
+		static const CMipsFunctionPatternDb& GetPatternDb();
+		static Function GetFunction(const std::string&);
+
+		static uint8* GetContiguousMemory(CMIPS*, uint32, uint32);
+		static bool HasSimpleSize(CMIPS*);
+		static void ReturnToCaller(CMIPS*, uint32);
+
+		static uint32 Memcpy(CMIPS*);
+		static uint32 Memset(CMIPS*);
+	};
+}
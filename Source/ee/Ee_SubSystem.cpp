@@ -414,6 +414,7 @@ void CSubSystem::LoadState(Framework::CZipArchiveReader& archive)
 	m_gif.LoadState(archive);
 	m_ipu.LoadState(archive);
 	m_os->GetLibMc2().LoadState(archive);
+	m_os->RebuildThreadScheduleIndex();
 }
 
 void CSubSystem::SetupEePageTable()
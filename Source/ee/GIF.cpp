@@ -9,6 +9,11 @@
 #include "../states/MemoryStateFile.h"
 #include "GIF.h"
 #include "DMAC.h"
+#include "SimdDefs.h"
+
+#ifdef FRAMEWORK_SIMD_USE_SSE
+#include <emmintrin.h>
+#endif
 
 #define QTEMP_INIT (0x3F800000)
 
@@ -50,6 +55,7 @@ void CGIF::Reset()
 	m_regs = 0;
 	m_regsTemp = 0;
 	m_regList = 0;
+	m_packedLayout = PACKED_LAYOUT_GENERIC;
 	m_eop = false;
 	m_qtemp = QTEMP_INIT;
 	m_signalState = SIGNAL_STATE_NONE;
@@ -75,6 +81,7 @@ void CGIF::LoadState(Framework::CZipArchiveReader& archive)
 		m_qtemp = registerFile.GetRegister32(STATE_REGS_QTEMP);
 		m_path3XferActiveTicks = registerFile.GetRegister32(STATE_REGS_PATH3_XFER_ACTIVE_TICKS);
 		m_fifoIndex = registerFile.GetRegister32(STATE_REGS_FIFO_INDEX);
+		m_packedLayout = GetPackedLayout(m_regs, m_regList);
 	}
 
 	archive.BeginReadFile(STATE_FIFO_BUFFER)->Read(m_fifoBuffer, FIFO_SIZE);
@@ -102,10 +109,194 @@ void CGIF::SaveState(Framework::CZipArchiveWriter& archive)
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_FIFO_BUFFER, m_fifoBuffer, FIFO_SIZE));
 }
 
+static inline uint64 DecodePackedRgbaq(const uint8* packet, uint32 q)
+{
+#ifdef FRAMEWORK_SIMD_USE_SSE
+	__m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packet));
+	rgba = _mm_and_si128(rgba, _mm_set1_epi32(0xFF));
+	rgba = _mm_packs_epi32(rgba, rgba);
+	rgba = _mm_packus_epi16(rgba, rgba);
+	return static_cast<uint32>(_mm_cvtsi128_si32(rgba)) | (static_cast<uint64>(q) << 32);
+#else
+	auto values = reinterpret_cast<const uint32*>(packet);
+	uint64 result = (values[0] & 0xFF);
+	result |= (values[1] & 0xFF) << 8;
+	result |= (values[2] & 0xFF) << 16;
+	result |= (values[3] & 0xFF) << 24;
+	result |= (static_cast<uint64>(q) << 32);
+	return result;
+#endif
+}
+
+static inline uint64 DecodePackedXyz(const uint8* packet)
+{
+#ifdef FRAMEWORK_SIMD_USE_SSE
+	__m128i xyz = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packet));
+	//Low dword becomes (X & 0xFFFF) | (Y << 16)
+	__m128i xy = _mm_shufflelo_epi16(xyz, _MM_SHUFFLE(3, 3, 2, 0));
+	__m128i z = _mm_srli_si128(xyz, 8);
+	uint64 result = 0;
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(&result), _mm_unpacklo_epi32(xy, z));
+	return result;
+#else
+	auto values = reinterpret_cast<const uint32*>(packet);
+	uint64 result = (values[0] & 0xFFFF);
+	result |= (values[1] & 0xFFFF) << 16;
+	result |= static_cast<uint64>(values[2]) << 32;
+	return result;
+#endif
+}
+
+static inline uint64 DecodePackedXyzf(const uint8* packet)
+{
+#ifdef FRAMEWORK_SIMD_USE_SSE
+	__m128i xyzf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packet));
+	__m128i xy = _mm_shufflelo_epi16(xyzf, _MM_SHUFFLE(3, 3, 2, 0));
+	//Z is in bits 4-27 and F is in bits 4-11
+	__m128i zf = _mm_srli_epi32(xyzf, 4);
+	__m128i z = _mm_and_si128(zf, _mm_set1_epi32(0x00FFFFFF));
+	__m128i f = _mm_srli_si128(_mm_slli_epi32(zf, 24), 4);
+	__m128i hi = _mm_srli_si128(_mm_or_si128(z, f), 8);
+	uint64 result = 0;
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(&result), _mm_unpacklo_epi32(xy, hi));
+	return result;
+#else
+	auto values = reinterpret_cast<const uint32*>(packet);
+	uint64 result = (values[0] & 0xFFFF);
+	result |= (values[1] & 0xFFFF) << 16;
+	result |= static_cast<uint64>(values[2] & 0x0FFFFFF0) << 28;
+	result |= static_cast<uint64>(values[3] & 0x00000FF0) << 52;
+	return result;
+#endif
+}
+
+CGIF::PACKED_LAYOUT CGIF::GetPackedLayout(uint32 regs, uint64 regList)
+{
+	switch(regs)
+	{
+	case 2:
+		switch(regList & 0xFF)
+		{
+		case 0x51:
+			return PACKED_LAYOUT_RGBAQ_XYZ2;
+		case 0x41:
+			return PACKED_LAYOUT_RGBAQ_XYZF2;
+		}
+		break;
+	case 3:
+		switch(regList & 0xFFF)
+		{
+		case 0x512:
+			return PACKED_LAYOUT_ST_RGBAQ_XYZ2;
+		case 0x412:
+			return PACKED_LAYOUT_ST_RGBAQ_XYZF2;
+		case 0x513:
+			return PACKED_LAYOUT_UV_RGBAQ_XYZ2;
+		case 0x413:
+			return PACKED_LAYOUT_UV_RGBAQ_XYZF2;
+		}
+		break;
+	}
+	return PACKED_LAYOUT_GENERIC;
+}
+
+template <CGIF::PACKED_LAYOUT layout>
+void CGIF::DecodePackedVertices(const uint8* packet, uint32 vertexCount, CGSHandler::RegisterWrite* writes)
+{
+	static constexpr bool hasSt = (layout == PACKED_LAYOUT_ST_RGBAQ_XYZ2) || (layout == PACKED_LAYOUT_ST_RGBAQ_XYZF2);
+	static constexpr bool hasUv = (layout == PACKED_LAYOUT_UV_RGBAQ_XYZ2) || (layout == PACKED_LAYOUT_UV_RGBAQ_XYZF2);
+	static constexpr bool hasFog = (layout == PACKED_LAYOUT_RGBAQ_XYZF2) || (layout == PACKED_LAYOUT_ST_RGBAQ_XYZF2) || (layout == PACKED_LAYOUT_UV_RGBAQ_XYZF2);
+
+	uint32 qtemp = m_qtemp;
+	for(uint32 i = 0; i < vertexCount; i++)
+	{
+		auto values = reinterpret_cast<const uint32*>(packet);
+		if(hasSt)
+		{
+			qtemp = values[2];
+			(*writes++) = CGSHandler::RegisterWrite(GS_REG_ST, *reinterpret_cast<const uint64*>(packet));
+			packet += 0x10;
+		}
+		else if(hasUv)
+		{
+			uint64 uv = (values[0] & 0x7FFF);
+			uv |= (values[1] & 0x7FFF) << 16;
+			(*writes++) = CGSHandler::RegisterWrite(GS_REG_UV, uv);
+			packet += 0x10;
+		}
+
+		(*writes++) = CGSHandler::RegisterWrite(GS_REG_RGBAQ, DecodePackedRgbaq(packet, qtemp));
+		packet += 0x10;
+
+		values = reinterpret_cast<const uint32*>(packet);
+		bool disableDrawing = (values[3] & 0x8000) != 0;
+		if(hasFog)
+		{
+			(*writes++) = CGSHandler::RegisterWrite(disableDrawing ? GS_REG_XYZF3 : GS_REG_XYZF2, DecodePackedXyzf(packet));
+		}
+		else
+		{
+			(*writes++) = CGSHandler::RegisterWrite(disableDrawing ? GS_REG_XYZ3 : GS_REG_XYZ2, DecodePackedXyz(packet));
+		}
+		packet += 0x10;
+	}
+	m_qtemp = qtemp;
+}
+
+uint32 CGIF::ProcessPackedVertices(const uint8* memory, uint32 address, uint32 end)
+{
+	//Decodes as many complete loops as possible in one go, writing straight
+	//into the GS write buffer without going through the register dispatch
+	assert(m_regsTemp == m_regs);
+
+	uint32 loopSize = m_regs * 0x10;
+	uint32 loopCount = std::min<uint32>(m_loops, (end - address) / loopSize);
+	if(loopCount == 0) return 0;
+
+	uint32 writeCount = loopCount * m_regs;
+	auto writes = m_gs->ReserveRegisterWrites(writeCount);
+	if(!writes) return 0;
+
+	const uint8* packet = memory + address;
+	switch(m_packedLayout)
+	{
+	case PACKED_LAYOUT_RGBAQ_XYZ2:
+		DecodePackedVertices<PACKED_LAYOUT_RGBAQ_XYZ2>(packet, loopCount, writes);
+		break;
+	case PACKED_LAYOUT_RGBAQ_XYZF2:
+		DecodePackedVertices<PACKED_LAYOUT_RGBAQ_XYZF2>(packet, loopCount, writes);
+		break;
+	case PACKED_LAYOUT_ST_RGBAQ_XYZ2:
+		DecodePackedVertices<PACKED_LAYOUT_ST_RGBAQ_XYZ2>(packet, loopCount, writes);
+		break;
+	case PACKED_LAYOUT_ST_RGBAQ_XYZF2:
+		DecodePackedVertices<PACKED_LAYOUT_ST_RGBAQ_XYZF2>(packet, loopCount, writes);
+		break;
+	case PACKED_LAYOUT_UV_RGBAQ_XYZ2:
+		DecodePackedVertices<PACKED_LAYOUT_UV_RGBAQ_XYZ2>(packet, loopCount, writes);
+		break;
+	case PACKED_LAYOUT_UV_RGBAQ_XYZF2:
+		DecodePackedVertices<PACKED_LAYOUT_UV_RGBAQ_XYZF2>(packet, loopCount, writes);
+		break;
+	default:
+		assert(false);
+		return 0;
+	}
+	m_gs->CommitRegisterWrites(writeCount);
+
+	m_loops -= loopCount;
+	return loopCount * loopSize;
+}
+
 uint32 CGIF::ProcessPacked(const uint8* memory, uint32 address, uint32 end)
 {
 	uint32 start = address;
 
+	if((m_packedLayout != PACKED_LAYOUT_GENERIC) && (m_regsTemp == m_regs))
+	{
+		address += ProcessPackedVertices(memory, address, end);
+	}
+
 	while((m_loops != 0) && (address < end))
 	{
 		while((m_regsTemp != 0) && (address < end))
@@ -235,10 +426,56 @@ uint32 CGIF::ProcessPacked(const uint8* memory, uint32 address, uint32 end)
 	return address - start;
 }
 
+uint32 CGIF::ProcessRegListLoops(const uint8* memory, uint32 address, uint32 end)
+{
+	//Decodes as many complete loops as possible in one go, writing straight
+	//into the GS write buffer instead of going through WriteRegister for every register
+	assert(m_regsTemp == m_regs);
+
+	uint32 loopSize = m_regs * 0x08;
+	uint32 loopCount = std::min<uint32>(m_loops, (end - address) / loopSize);
+	if(loopCount == 0) return 0;
+
+	uint8 writeRegs[0x10];
+	uint8 writeRegOffsets[0x10];
+	uint32 writeRegCount = 0;
+	for(uint32 i = 0; i < m_regs; i++)
+	{
+		uint8 regDesc = static_cast<uint8>((m_regList >> (i * 4)) & 0x0F);
+		if(regDesc == 0x0F) continue;
+		writeRegs[writeRegCount] = regDesc;
+		writeRegOffsets[writeRegCount] = static_cast<uint8>(i);
+		writeRegCount++;
+	}
+
+	uint32 writeCount = loopCount * writeRegCount;
+	auto writes = m_gs->ReserveRegisterWrites(writeCount);
+	if(!writes) return 0;
+
+	auto packet = reinterpret_cast<const uint64*>(memory + address);
+	for(uint32 loop = 0; loop < loopCount; loop++)
+	{
+		for(uint32 i = 0; i < writeRegCount; i++)
+		{
+			(*writes++) = CGSHandler::RegisterWrite(writeRegs[i], packet[writeRegOffsets[i]]);
+		}
+		packet += m_regs;
+	}
+	m_gs->CommitRegisterWrites(writeCount);
+
+	m_loops -= loopCount;
+	return loopCount * loopSize;
+}
+
 uint32 CGIF::ProcessRegList(const uint8* memory, uint32 address, uint32 end)
 {
 	uint32 start = address;
 
+	if(m_regsTemp == m_regs)
+	{
+		address += ProcessRegListLoops(memory, address, end);
+	}
+
 	while((m_loops != 0) && (address < end))
 	{
 		while((m_regsTemp != 0) && (address < end))
@@ -344,6 +581,7 @@ uint32 CGIF::ProcessSinglePacket(const uint8* memory, uint32 memorySize, uint32
 
 			if(m_regs == 0) m_regs = 0x10;
 			m_regsTemp = m_regs;
+			m_packedLayout = (m_cmd == 0) ? GetPackedLayout(m_regs, m_regList) : PACKED_LAYOUT_GENERIC;
 			m_activePath = packetMetadata.pathIndex;
 			continue;
 		}
@@ -90,8 +90,26 @@ private:
 		MASKED_PATH3_XFER_DONE,
 	};
 
+	//Common REGS descriptors used to send vertices in PACKED mode
+	enum PACKED_LAYOUT
+	{
+		PACKED_LAYOUT_GENERIC,
+		PACKED_LAYOUT_RGBAQ_XYZ2,
+		PACKED_LAYOUT_RGBAQ_XYZF2,
+		PACKED_LAYOUT_ST_RGBAQ_XYZ2,
+		PACKED_LAYOUT_ST_RGBAQ_XYZF2,
+		PACKED_LAYOUT_UV_RGBAQ_XYZ2,
+		PACKED_LAYOUT_UV_RGBAQ_XYZF2,
+	};
+
+	static PACKED_LAYOUT GetPackedLayout(uint32, uint64);
+
 	uint32 ProcessPacked(const uint8*, uint32, uint32);
+	uint32 ProcessPackedVertices(const uint8*, uint32, uint32);
+	template <PACKED_LAYOUT>
+	void DecodePackedVertices(const uint8*, uint32, CGSHandler::RegisterWrite*);
 	uint32 ProcessRegList(const uint8*, uint32, uint32);
+	uint32 ProcessRegListLoops(const uint8*, uint32, uint32);
 	uint32 ProcessImage(const uint8*, uint32, uint32, uint32);
 
 	void ProcessFifoWrite(uint32, uint32);
@@ -109,6 +127,7 @@ private:
 	uint8 m_regs = 0;
 	uint8 m_regsTemp = 0;
 	uint64 m_regList = 0;
+	PACKED_LAYOUT m_packedLayout = PACKED_LAYOUT_GENERIC;
 	bool m_eop = false;
 	uint32 m_qtemp;
 	SIGNAL_STATE m_signalState = SIGNAL_STATE_NONE;
@@ -13,6 +13,10 @@
 #include "IPU_MacroblockTypeBTable.h"
 #include "IPU_MotionCodeTable.h"
 #include "IPU_DmVectorTable.h"
+#include "IPU_FastIdct.h"
+#include "IPU_Csc.h"
+#include "IPU_DctCoefficientLookup.h"
+#include "IPU_SymbolLookup.h"
 #include "mpeg2/DcSizeLuminanceTable.h"
 #include "mpeg2/DcSizeChrominanceTable.h"
 #include "mpeg2/DctCoefficientTable0.h"
@@ -102,6 +106,7 @@ static CVLCTable::DECODE_STATUS FilterSymbolError(CVLCTable::DECODE_STATUS resul
 
 CIPU::CIPU(CINTC& intc)
     : m_intc(intc)
+    , m_idct(&IPU::CFastIdct::Transform)
 {
 	m_commands[IPU_CMD_BCLR] = &m_BCLRCommand;
 	m_commands[IPU_CMD_IDEC] = &m_IDECCommand;
@@ -464,6 +469,22 @@ void CIPU::SetDMA3ReceiveHandler(const Dma3ReceiveHandler& receiveHandler)
 	m_OUT_FIFO.SetReceiveHandler(receiveHandler);
 }
 
+void CIPU::SetIdctImplementation(IDCT_IMPLEMENTATION implementation)
+{
+	switch(implementation)
+	{
+	case IDCT_IMPLEMENTATION_FAST:
+		m_idct = &IPU::CFastIdct::Transform;
+		break;
+	case IDCT_IMPLEMENTATION_REFERENCE:
+		m_idct = &CIPU::ReferenceIdct;
+		break;
+	default:
+		assert(false);
+		break;
+	}
+}
+
 uint32 CIPU::ReceiveDMA4(uint32 address, uint32 nQWC, bool nTagIncluded, uint8* ram, uint8* spr)
 {
 	assert(nTagIncluded == false);
@@ -504,6 +525,7 @@ CIPU::DECODER_CONTEXT CIPU::GetDecoderContext()
 	context.intraIq = m_nIntraIQ;
 	context.nonIntraIq = m_nNonIntraIQ;
 	context.dcPredictor = m_nDcPredictor;
+	context.idct = m_idct;
 	return context;
 }
 
@@ -654,6 +676,11 @@ void CIPU::InverseScan(int16* pBlock, bool isZigZag)
 	}
 }
 
+void CIPU::ReferenceIdct(const int16* input, int16* output)
+{
+	IDCT::CIEEE1180::GetInstance()->Transform(input, output);
+}
+
 uint32 CIPU::GetBusyBit(bool condition) const
 {
 	return condition ? 0x80000000 : 0x00000000;
@@ -808,9 +835,9 @@ void CIPU::DisassembleCommand(uint32 nValue)
 //OUT FIFO class implementation
 /////////////////////////////////////////////
 
-CIPU::COUTFIFO::~COUTFIFO()
+CIPU::COUTFIFO::COUTFIFO()
+    : m_buffer(INITIAL_BUFFERSIZE)
 {
-	free(m_buffer);
 }
 
 void CIPU::COUTFIFO::SetReceiveHandler(const Dma3ReceiveHandler& handler)
@@ -825,37 +852,96 @@ uint32 CIPU::COUTFIFO::GetSize() const
 
 void CIPU::COUTFIFO::Write(const void* data, unsigned int size)
 {
-	RequestGrow(size);
+	assert(!m_writeStaged);
+	EnsureCapacity(size);
+	CopyIn(reinterpret_cast<const uint8*>(data), size);
+}
 
-	memcpy(m_buffer + m_size, data, size);
-	m_size += size;
+uint8* CIPU::COUTFIFO::ReserveWrite(unsigned int size)
+{
+	assert(!m_writeStaged);
+	EnsureCapacity(size);
+	if(m_size == 0)
+	{
+		m_readPosition = 0;
+	}
+	unsigned int writePosition = (m_readPosition + m_size) & (m_buffer.size() - 1);
+	if((writePosition + size) <= m_buffer.size())
+	{
+		return m_buffer.data() + writePosition;
+	}
+	//Not enough contiguous space before the end of the ring, go through a temporary buffer
+	m_stagingBuffer.resize(size);
+	m_writeStaged = true;
+	return m_stagingBuffer.data();
+}
+
+void CIPU::COUTFIFO::CommitWrite(unsigned int size)
+{
+	if(m_writeStaged)
+	{
+		assert(size <= m_stagingBuffer.size());
+		m_writeStaged = false;
+		CopyIn(m_stagingBuffer.data(), size);
+	}
+	else
+	{
+		assert((m_size + size) <= m_buffer.size());
+		m_size += size;
+	}
 }
 
 void CIPU::COUTFIFO::Flush()
 {
 	//Write to memory through DMA channel 3
 	assert((m_size & 0x0F) == 0);
-	uint32 copied = m_receiveHandler(m_buffer, m_size / 0x10);
-	copied *= 0x10;
+	while(m_size != 0)
+	{
+		//Hand out the part that's contiguous in the ring
+		unsigned int spanSize = std::min<unsigned int>(m_size, m_buffer.size() - m_readPosition);
+		assert((spanSize & 0x0F) == 0);
+		uint32 copied = m_receiveHandler(m_buffer.data() + m_readPosition, spanSize / 0x10);
+		copied *= 0x10;
+		assert(copied <= spanSize);
 
-	if(copied == 0) return;
+		m_readPosition = (m_readPosition + copied) & (m_buffer.size() - 1);
+		m_size -= copied;
 
-	memmove(m_buffer, m_buffer + copied, m_size - copied);
-	m_size -= copied;
+		if(copied != spanSize) break;
+	}
 }
 
 void CIPU::COUTFIFO::Reset()
 {
+	m_readPosition = 0;
 	m_size = 0;
+	m_writeStaged = false;
 }
 
-void CIPU::COUTFIFO::RequestGrow(unsigned int size)
+void CIPU::COUTFIFO::EnsureCapacity(unsigned int size)
 {
-	while(m_alloc <= (size + m_size))
+	unsigned int capacity = m_buffer.size();
+	if((m_size + size) <= capacity) return;
+	while(capacity < (m_size + size))
 	{
-		m_alloc += GROWSIZE;
-		m_buffer = reinterpret_cast<uint8*>(realloc(m_buffer, m_alloc));
+		capacity *= 2;
 	}
+	std::vector<uint8> buffer(capacity);
+	unsigned int firstSize = std::min<unsigned int>(m_size, m_buffer.size() - m_readPosition);
+	memcpy(buffer.data(), m_buffer.data() + m_readPosition, firstSize);
+	memcpy(buffer.data() + firstSize, m_buffer.data(), m_size - firstSize);
+	m_buffer = std::move(buffer);
+	m_readPosition = 0;
+}
+
+void CIPU::COUTFIFO::CopyIn(const uint8* data, unsigned int size)
+{
+	assert((m_size + size) <= m_buffer.size());
+	unsigned int writePosition = (m_readPosition + m_size) & (m_buffer.size() - 1);
+	unsigned int firstSize = std::min<unsigned int>(size, m_buffer.size() - writePosition);
+	memcpy(m_buffer.data() + writePosition, data, firstSize);
+	memcpy(m_buffer.data(), data + firstSize, size - firstSize);
+	m_size += size;
 }
 
 /////////////////////////////////////////////
@@ -876,7 +962,12 @@ void CIPU::CINFIFO::Write(void* data, unsigned int size)
 		return;
 	}
 
-	memcpy(m_buffer + m_size, data, size);
+	auto input = reinterpret_cast<const uint8*>(data);
+	unsigned int writePosition = (m_readPosition + m_size) & RINGMASK;
+	unsigned int firstSize = std::min<unsigned int>(size, RINGSIZE - writePosition);
+	memcpy(m_buffer + writePosition, input, firstSize);
+	memcpy(m_buffer, input + firstSize, size - firstSize);
+	memcpy(m_buffer + RINGSIZE, m_buffer, LOOKUPPADDING);
 	m_size += size;
 	m_lookupBitsDirty = true;
 }
@@ -943,7 +1034,7 @@ void CIPU::CINFIFO::Advance(uint8 bits)
 		}
 
 		//Discard the read bytes
-		memmove(m_buffer, m_buffer + 16, m_size - 16);
+		m_readPosition = (m_readPosition + 16) & RINGMASK;
 		m_size -= 16;
 		m_bitPosition -= 128;
 		m_lookupBitsDirty = true;
@@ -972,6 +1063,7 @@ unsigned int CIPU::CINFIFO::GetAvailableBits() const
 
 void CIPU::CINFIFO::Reset()
 {
+	m_readPosition = 0;
 	m_bitPosition = 0;
 	m_size = 0;
 	m_lookupBits = 0;
@@ -983,7 +1075,13 @@ void CIPU::CINFIFO::SaveState(const char* regsFileName, Framework::CZipArchiveWr
 	auto registerFile = std::make_unique<CRegisterStateFile>(regsFileName);
 	registerFile->SetRegister32(STATE_INFIFO_REGS_SIZE, m_size);
 	registerFile->SetRegister32(STATE_INFIFO_REGS_BITPOSITION, m_bitPosition);
-	RegisterStateUtils::WriteArray(*registerFile.get(), m_buffer, STATE_INFIFO_REGS_BUFFER_FORMAT);
+	//Saved linearly, starting at the read position
+	uint8 buffer[BUFFERSIZE];
+	for(unsigned int i = 0; i < BUFFERSIZE; i++)
+	{
+		buffer[i] = m_buffer[(m_readPosition + i) & RINGMASK];
+	}
+	RegisterStateUtils::WriteArray(*registerFile.get(), buffer, STATE_INFIFO_REGS_BUFFER_FORMAT);
 	archive.InsertFile(std::move(registerFile));
 }
 
@@ -992,13 +1090,17 @@ void CIPU::CINFIFO::LoadState(const char* regsFileName, Framework::CZipArchiveRe
 	auto registerFile = CRegisterStateFile(*archive.BeginReadFile(regsFileName));
 	m_size = registerFile.GetRegister32(STATE_INFIFO_REGS_SIZE);
 	m_bitPosition = registerFile.GetRegister32(STATE_INFIFO_REGS_BITPOSITION);
-	RegisterStateUtils::ReadArray(registerFile, m_buffer, STATE_INFIFO_REGS_BUFFER_FORMAT);
+	uint8 buffer[BUFFERSIZE];
+	RegisterStateUtils::ReadArray(registerFile, buffer, STATE_INFIFO_REGS_BUFFER_FORMAT);
+	memcpy(m_buffer, buffer, BUFFERSIZE);
+	memcpy(m_buffer + RINGSIZE, m_buffer, LOOKUPPADDING);
+	m_readPosition = 0;
 	m_lookupBitsDirty = true;
 }
 
 void CIPU::CINFIFO::SyncLookupBits()
 {
-	unsigned int lookupPosition = (m_bitPosition & ~0x1F) / 8;
+	unsigned int lookupPosition = (m_readPosition + ((m_bitPosition & ~0x1F) / 8)) & RINGMASK;
 	m_lookupBits = Framework::CEndian::FromMSBF64(*reinterpret_cast<const uint64*>(m_buffer + lookupPosition));
 }
 
@@ -1085,9 +1187,12 @@ bool CIPU::CIDECCommand::Execute()
 		break;
 		case STATE_READMBTYPE:
 		{
-			if(FilterSymbolError(CMacroblockTypeITable::GetInstance()->TryGetSymbol(m_IN_FIFO, m_mbType)) != CVLCTable::DECODE_STATUS_SUCCESS)
+			if(!IPU::CSymbolLookup::GetInstance(IPU::CSymbolLookup::TABLE_MBTYPE_I).TryGetSymbol(m_IN_FIFO, m_mbType))
 			{
-				return false;
+				if(FilterSymbolError(CMacroblockTypeITable::GetInstance()->TryGetSymbol(m_IN_FIFO, m_mbType)) != CVLCTable::DECODE_STATUS_SUCCESS)
+				{
+					return false;
+				}
 			}
 			assert(m_mbType & 0x1); //Must always be intra block
 			m_state = STATE_READDCTTYPE;
@@ -1227,9 +1332,12 @@ bool CIPU::CIDECCommand::Execute()
 		case STATE_READMBINCREMENT:
 		{
 			uint32 mbIncrement = 0;
-			if(CMacroblockAddressIncrementTable::GetInstance()->TryGetSymbol(m_IN_FIFO, mbIncrement) != CVLCTable::DECODE_STATUS_SUCCESS)
+			if(!IPU::CSymbolLookup::GetInstance(IPU::CSymbolLookup::TABLE_MBADDRESSINCREMENT).TryGetSymbol(m_IN_FIFO, mbIncrement))
 			{
-				return false;
+				if(CMacroblockAddressIncrementTable::GetInstance()->TryGetSymbol(m_IN_FIFO, mbIncrement) != CVLCTable::DECODE_STATUS_SUCCESS)
+				{
+					return false;
+				}
 			}
 			assert((mbIncrement & 0xFFFF) == 1);
 			m_state = STATE_READMBTYPE;
@@ -1263,13 +1371,7 @@ void CIPU::CIDECCommand::ConvertRawBlock()
 	uint8 outBlockData[CCSCCommand::BLOCK_SIZE];
 	m_blockStream.Seek(0, Framework::STREAM_SEEK_SET);
 	m_blockStream.Read(inBlockData, CCSCCommand::BLOCK_SIZE * sizeof(int16));
-	for(uint32 i = 0; i < CCSCCommand::BLOCK_SIZE; i++)
-	{
-		int16 blockValue = inBlockData[i];
-		blockValue = std::max<int16>(blockValue, 0);
-		blockValue = std::min<int16>(blockValue, 255);
-		outBlockData[i] = static_cast<uint8>(blockValue);
-	}
+	IPU::CCsc::ClampToRaw8(inBlockData, outBlockData, CCSCCommand::BLOCK_SIZE);
 	m_blockStream.ResetBuffer();
 	m_blockStream.Write(outBlockData, CCSCCommand::BLOCK_SIZE * sizeof(uint8));
 }
@@ -1408,7 +1510,7 @@ bool CIPU::CBDECCommand::Execute()
 
 			memcpy(blockTemp, blockInfo.block, sizeof(int16) * 0x40);
 
-			IDCT::CIEEE1180::GetInstance()->Transform(blockTemp, blockInfo.block);
+			m_context.idct(blockTemp, blockInfo.block);
 
 			m_state = STATE_DECODEBLOCK_GOTONEXT;
 		}
@@ -1486,11 +1588,34 @@ void CIPU::CBDECCommand_ReadDct::Initialize(CINFIFO* fifo, int16* block, unsigne
 	if(m_mbi && !m_isMpeg1CoeffVLCTable)
 	{
 		m_coeffTable = &CDctCoefficientTable1::GetInstance();
+		m_coeffLookup = &IPU::CDctCoefficientLookup::GetInstance(IPU::CDctCoefficientLookup::TABLE_1, false);
+		m_firstCoeffLookup = &IPU::CDctCoefficientLookup::GetInstance(IPU::CDctCoefficientLookup::TABLE_1, true);
 	}
 	else
 	{
 		m_coeffTable = &CDctCoefficientTable0::GetInstance();
+		m_coeffLookup = &IPU::CDctCoefficientLookup::GetInstance(IPU::CDctCoefficientLookup::TABLE_0, false);
+		m_firstCoeffLookup = &IPU::CDctCoefficientLookup::GetInstance(IPU::CDctCoefficientLookup::TABLE_0, true);
+	}
+}
+
+void CIPU::CBDECCommand_ReadDct::StoreCoefficient(unsigned int run, int32 level)
+{
+	m_blockIndex += run;
+
+	if(m_blockIndex < 0x40)
+	{
+		m_block[m_blockIndex] = static_cast<int16>(level);
+#ifdef _DECODE_LOGGING
+		CLog::GetInstance().Print(DECODE_LOG_NAME, "[%d]: %d ", m_blockIndex, level);
+#endif
 	}
+	else
+	{
+		throw CVLCTable::CVLCTableException();
+	}
+
+	m_blockIndex++;
 }
 
 bool CIPU::CBDECCommand_ReadDct::Execute()
@@ -1534,6 +1659,25 @@ bool CIPU::CBDECCommand_ReadDct::Execute()
 		break;
 		case STATE_CHECKEOB:
 		{
+			//Most codes are decoded through the lookup, others fall back to the bit-serial table
+			{
+				const auto& coeffLookup = (m_blockIndex == 0) ? *m_firstCoeffLookup : *m_coeffLookup;
+				MPEG2::RUNLEVELPAIR runLevelPair;
+				auto lookupResult = coeffLookup.TryDecode(m_IN_FIFO, m_isMpeg2, runLevelPair);
+				if(lookupResult == IPU::CDctCoefficientLookup::RESULT_ENDOFBLOCK)
+				{
+#ifdef _DECODE_LOGGING
+					CLog::GetInstance().Print(DECODE_LOG_NAME, "\r\n");
+#endif
+					return true;
+				}
+				if(lookupResult == IPU::CDctCoefficientLookup::RESULT_COEFFICIENT)
+				{
+					StoreCoefficient(runLevelPair.run, runLevelPair.level);
+					break;
+				}
+			}
+
 			bool isEob = false;
 			if(m_coeffTable->TryIsEndOfBlock(m_IN_FIFO, isEob) != CVLCTable::DECODE_STATUS_SUCCESS)
 			{
@@ -1566,21 +1710,7 @@ bool CIPU::CBDECCommand_ReadDct::Execute()
 					return false;
 				}
 			}
-			m_blockIndex += runLevelPair.run;
-
-			if(m_blockIndex < 0x40)
-			{
-				m_block[m_blockIndex] = static_cast<int16>(runLevelPair.level);
-#ifdef _DECODE_LOGGING
-				CLog::GetInstance().Print(DECODE_LOG_NAME, "[%d]: %d ", m_blockIndex, runLevelPair.level);
-#endif
-			}
-			else
-			{
-				throw CVLCTable::CVLCTableException();
-			}
-
-			m_blockIndex++;
+			StoreCoefficient(runLevelPair.run, runLevelPair.level);
 			m_state = STATE_CHECKEOB;
 		}
 		break;
@@ -1691,6 +1821,7 @@ void CIPU::CVDECCommand::Initialize(CINFIFO* fifo, uint32 commandCode, uint32 pi
 	case 0:
 		//Macroblock Address Increment
 		m_table = CMacroblockAddressIncrementTable::GetInstance();
+		m_lookup = &IPU::CSymbolLookup::GetInstance(IPU::CSymbolLookup::TABLE_MBADDRESSINCREMENT);
 		break;
 	case 1:
 		//Macroblock Type
@@ -1699,14 +1830,17 @@ void CIPU::CVDECCommand::Initialize(CINFIFO* fifo, uint32 commandCode, uint32 pi
 		case 1:
 			//I Picture
 			m_table = CMacroblockTypeITable::GetInstance();
+			m_lookup = &IPU::CSymbolLookup::GetInstance(IPU::CSymbolLookup::TABLE_MBTYPE_I);
 			break;
 		case 2:
 			//P Picture
 			m_table = CMacroblockTypePTable::GetInstance();
+			m_lookup = &IPU::CSymbolLookup::GetInstance(IPU::CSymbolLookup::TABLE_MBTYPE_P);
 			break;
 		case 3:
 			//B Picture
 			m_table = CMacroblockTypeBTable::GetInstance();
+			m_lookup = &IPU::CSymbolLookup::GetInstance(IPU::CSymbolLookup::TABLE_MBTYPE_B);
 			break;
 		default:
 			assert(0);
@@ -1716,9 +1850,11 @@ void CIPU::CVDECCommand::Initialize(CINFIFO* fifo, uint32 commandCode, uint32 pi
 		break;
 	case 2:
 		m_table = CMotionCodeTable::GetInstance();
+		m_lookup = &IPU::CSymbolLookup::GetInstance(IPU::CSymbolLookup::TABLE_MOTIONCODE);
 		break;
 	case 3:
 		m_table = CDmVectorTable::GetInstance();
+		m_lookup = &IPU::CSymbolLookup::GetInstance(IPU::CSymbolLookup::TABLE_DMVECTOR);
 		break;
 	default:
 		assert(0);
@@ -1741,7 +1877,10 @@ bool CIPU::CVDECCommand::Execute()
 		break;
 		case STATE_DECODE:
 		{
-			(*m_result) = m_table->GetSymbol(m_IN_FIFO);
+			if(!m_lookup->TryGetSymbol(m_IN_FIFO, *m_result))
+			{
+				(*m_result) = m_table->GetSymbol(m_IN_FIFO);
+			}
 			m_state = STATE_DONE;
 		}
 		break;
@@ -1877,11 +2016,6 @@ bool CIPU::CSETVQCommand::Execute()
 //CSC command implementation
 /////////////////////////////////////////////
 
-CIPU::CCSCCommand::CCSCCommand()
-{
-	GenerateCbCrMap();
-}
-
 void CIPU::CCSCCommand::Initialize(CINFIFO* input, COUTFIFO* output, uint32 commandCode, uint16 TH0, uint16 TH1)
 {
 	m_command <<= commandCode;
@@ -1937,80 +2071,22 @@ bool CIPU::CCSCCommand::Execute()
 		break;
 		case STATE_CONVERTBLOCK:
 		{
-			uint32 nPixel[0x100];
-
-			uint8* pY = m_block;
-			uint8* nBlockCb = m_block + 0x100;
-			uint8* nBlockCr = m_block + 0x140;
-
-			uint32* pPixel = nPixel;
-			unsigned int* pCbCrMap = m_nCbCrMap;
-
-			uint16 alphaTh0 = (m_TH0 & 0x1FF);
-			uint16 alphaTh1 = (m_TH1 & 0x1FF);
-
-			for(unsigned int i = 0; i < 16; i++)
-			{
-				for(unsigned int j = 0; j < 16; j++)
-				{
-					float nY = pY[j];
-					float nCb = nBlockCb[pCbCrMap[j]];
-					float nCr = nBlockCr[pCbCrMap[j]];
-
-					float nR = nY + 1.402f * (nCr - 128);
-					float nG = nY - 0.34414f * (nCb - 128) - 0.71414f * (nCr - 128);
-					float nB = nY + 1.772f * (nCb - 128);
-
-					nR = std::clamp(nR, 0.f, 255.f);
-					nG = std::clamp(nG, 0.f, 255.f);
-					nB = std::clamp(nB, 0.f, 255.f);
-
-					uint8 a = 0;
-					uint8 r = static_cast<uint8>(nR);
-					uint8 g = static_cast<uint8>(nG);
-					uint8 b = static_cast<uint8>(nB);
-
-					if(r < alphaTh0 && g < alphaTh0 && b < alphaTh0)
-					{
-						a = 0;
-					}
-					else if(r < alphaTh1 && g < alphaTh1 && b < alphaTh1)
-					{
-						a = 0x40;
-					}
-					else
-					{
-						a = 0x80;
-					}
-
-					pPixel[j] = (a << 24) | (b << 16) | (g << 8) | (r << 0);
-				}
-
-				pY += 0x10;
-				pCbCrMap += 0x10;
-				pPixel += 0x10;
-			}
-
+			static constexpr uint32 pixelCount = IPU::CCsc::MACROBLOCK_PIXELS;
 			if(m_command.ofm == 1)
 			{
 				//RGBA16 output
-				uint16 cvtPixels[0x100];
-				for(uint32 i = 0; i < 0x100; i++)
-				{
-					uint32 pixel = nPixel[i];
-					uint16 result = 0;
-					result |= ((pixel & 0x000000F8) >> (0 + 3)) << 0;
-					result |= ((pixel & 0x0000F800) >> (8 + 3)) << 5;
-					result |= ((pixel & 0x00F80000) >> (16 + 3)) << 10;
-					result |= ((pixel & 0x80000000) >> 31) << 15;
-					cvtPixels[i] = result;
-				}
-				m_OUT_FIFO->Write(cvtPixels, sizeof(uint16) * 0x100);
+				alignas(16) uint32 pixels[pixelCount];
+				IPU::CCsc::ConvertToRgba32(m_block, pixels, m_TH0, m_TH1);
+				auto output = reinterpret_cast<uint16*>(m_OUT_FIFO->ReserveWrite(sizeof(uint16) * pixelCount));
+				IPU::CCsc::ConvertToRgba16(pixels, output, m_command.dte != 0);
+				m_OUT_FIFO->CommitWrite(sizeof(uint16) * pixelCount);
 			}
 			else
 			{
 				//RGBA32 output
-				m_OUT_FIFO->Write(nPixel, sizeof(uint32) * 0x100);
+				auto output = reinterpret_cast<uint32*>(m_OUT_FIFO->ReserveWrite(sizeof(uint32) * pixelCount));
+				IPU::CCsc::ConvertToRgba32(m_block, output, m_TH0, m_TH1);
+				m_OUT_FIFO->CommitWrite(sizeof(uint32) * pixelCount);
 			}
 
 			m_mbCount--;
@@ -2034,24 +2110,6 @@ bool CIPU::CCSCCommand::Execute()
 	}
 }
 
-void CIPU::CCSCCommand::GenerateCbCrMap()
-{
-	unsigned int* pCbCrMap = m_nCbCrMap;
-	for(unsigned int i = 0; i < 0x40; i += 0x8)
-	{
-		for(unsigned int j = 0; j < 0x10; j += 2)
-		{
-			pCbCrMap[j + 0x00] = (j / 2) + i;
-			pCbCrMap[j + 0x01] = (j / 2) + i;
-
-			pCbCrMap[j + 0x10] = (j / 2) + i;
-			pCbCrMap[j + 0x11] = (j / 2) + i;
-		}
-
-		pCbCrMap += 0x20;
-	}
-}
-
 /////////////////////////////////////////////
 //SETTH command implementation
 /////////////////////////////////////////////
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <functional>
+#include <vector>
 #include "Types.h"
 #include "BitStream.h"
 #include "MemStream.h"
@@ -15,6 +16,12 @@
 
 class CINTC;
 
+namespace IPU
+{
+	class CDctCoefficientLookup;
+	class CSymbolLookup;
+}
+
 class CIPU
 {
 public:
@@ -33,6 +40,12 @@ public:
 		IPU_IN_FIFO = 0x10007010,
 	};
 
+	enum IDCT_IMPLEMENTATION
+	{
+		IDCT_IMPLEMENTATION_FAST,
+		IDCT_IMPLEMENTATION_REFERENCE,
+	};
+
 	void Reset();
 	uint32 GetRegister(uint32);
 	void SetRegister(uint32, uint32);
@@ -41,6 +54,7 @@ public:
 	void LoadState(Framework::CZipArchiveReader&);
 
 	void SetDMA3ReceiveHandler(const Dma3ReceiveHandler&);
+	void SetIdctImplementation(IDCT_IMPLEMENTATION);
 	uint32 ReceiveDMA4(uint32, uint32, bool, uint8*, uint8*);
 
 	void CountTicks(uint32);
@@ -118,6 +132,8 @@ private:
 	};
 	static_assert(sizeof(CMD_CSC) == 4, "Size of CMD_CSC must be 4.");
 
+	typedef void (*IdctFunction)(const int16*, int16*);
+
 	struct DECODER_CONTEXT
 	{
 		bool isMpeg1CoeffVLCTable = false;
@@ -128,31 +144,40 @@ private:
 		uint8* nonIntraIq = nullptr;
 		int16* dcPredictor = nullptr;
 		uint32 dcPrecision = 0;
+		IdctFunction idct = nullptr;
 	};
 
+	//Ring buffer, only grows if more data is pending than what the initial size allows
 	class COUTFIFO
 	{
 	public:
-		virtual ~COUTFIFO();
+		COUTFIFO();
+		virtual ~COUTFIFO() = default;
 
 		uint32 GetSize() const;
 		void Write(const void*, unsigned int);
+		//Returns a pointer where 'size' bytes can be written directly, must be followed by CommitWrite.
+		uint8* ReserveWrite(unsigned int);
+		void CommitWrite(unsigned int);
 		void Flush();
 		void SetReceiveHandler(const Dma3ReceiveHandler&);
 
 		void Reset();
 
 	private:
-		void RequestGrow(unsigned int);
+		void EnsureCapacity(unsigned int);
+		void CopyIn(const uint8*, unsigned int);
 
-		enum GROWSIZE
+		enum
 		{
-			GROWSIZE = 0x200,
+			INITIAL_BUFFERSIZE = 0x1000,
 		};
 
+		std::vector<uint8> m_buffer;
+		std::vector<uint8> m_stagingBuffer;
+		unsigned int m_readPosition = 0;
 		unsigned int m_size = 0;
-		unsigned int m_alloc = 0;
-		uint8* m_buffer = nullptr;
+		bool m_writeStaged = false;
 		Dma3ReceiveHandler m_receiveHandler;
 	};
 
@@ -184,11 +209,21 @@ private:
 		};
 
 	private:
+		enum
+		{
+			RINGSIZE = 0x100,
+			RINGMASK = RINGSIZE - 1,
+			//Start of the ring is mirrored after its end to allow lookups across the boundary
+			LOOKUPPADDING = 8,
+		};
+		static_assert(RINGSIZE >= BUFFERSIZE);
+
 		void SyncLookupBits();
 
-		uint8 m_buffer[BUFFERSIZE] = {};
+		uint8 m_buffer[RINGSIZE + LOOKUPPADDING] = {};
 		uint64 m_lookupBits;
 		bool m_lookupBitsDirty;
+		unsigned int m_readPosition = 0;
 		unsigned int m_size;
 		unsigned int m_bitPosition;
 	};
@@ -321,6 +356,8 @@ private:
 			STATE_SKIPEOB
 		};
 
+		void StoreCoefficient(unsigned int, int32);
+
 		CINFIFO* m_IN_FIFO = nullptr;
 		STATE m_state = STATE_INIT;
 		int16* m_block = nullptr;
@@ -330,6 +367,8 @@ private:
 		bool m_isMpeg2 = true;
 		unsigned int m_blockIndex = 0;
 		MPEG2::CDctCoefficientTable* m_coeffTable = nullptr;
+		const IPU::CDctCoefficientLookup* m_coeffLookup = nullptr;
+		const IPU::CDctCoefficientLookup* m_firstCoeffLookup = nullptr;
 		int16* m_dcPredictor = nullptr;
 		int16 m_dcDiff = 0;
 		CBDECCommand_ReadDcDiff m_readDcDiffCommand;
@@ -402,6 +441,7 @@ private:
 		CINFIFO* m_IN_FIFO = nullptr;
 		STATE m_state = STATE_ADVANCE;
 		MPEG2::CVLCTable* m_table = nullptr;
+		const IPU::CSymbolLookup* m_lookup = nullptr;
 	};
 
 	//0x04 ------------------------------------------------------------
@@ -464,8 +504,6 @@ private:
 			BLOCK_SIZE = 0x180,
 		};
 
-		CCSCCommand();
-
 		void Initialize(CINFIFO*, COUTFIFO*, uint32, uint16, uint16);
 		bool Execute() override;
 
@@ -479,8 +517,6 @@ private:
 			STATE_DONE,
 		};
 
-		void GenerateCbCrMap();
-
 		STATE m_state = STATE_DONE;
 		CMD_CSC m_command = make_convertible<CMD_CSC>(0);
 
@@ -492,8 +528,6 @@ private:
 		unsigned int m_currentIndex = 0;
 		unsigned int m_mbCount = 0;
 
-		unsigned int m_nCbCrMap[0x100];
-
 		uint8 m_block[BLOCK_SIZE];
 	};
 
@@ -524,6 +558,7 @@ private:
 
 	static void DequantiseBlock(int16*, uint8, uint8, bool isLinearQScale, uint32 dcPrecision, uint8* intraIq, uint8* nonIntraIq);
 	static void InverseScan(int16*, bool isZigZag);
+	static void ReferenceIdct(const int16*, int16*);
 
 	uint32 GetBusyBit(bool) const;
 	FIFO_STATE GetFifoState() const;
@@ -549,6 +584,7 @@ private:
 	uint32 m_currentCmdId;
 	uint32 m_lastCmdId;
 	bool m_isBusy;
+	IdctFunction m_idct;
 
 	CBCLRCommand m_BCLRCommand;
 	CIDECCommand m_IDECCommand;
@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cassert>
+#include "IPU_Csc.h"
+#include "SimdDefs.h"
+
+#ifdef FRAMEWORK_SIMD_USE_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace IPU;
+
+static const int16 g_ditherMatrix[4][4] = {
+	{-4, 0, -3, 1},
+	{2, -2, 3, -1},
+	{-3, 1, -4, 0},
+	{3, -1, 2, -2},
+};
+
+#ifdef FRAMEWORK_SIMD_USE_SSE
+
+//Same float operations as the scalar version, in the same order, results are identical
+static inline __m128i ConvertPixels(__m128i y, __m128i cb, __m128i cr, __m128i alphaTh0, __m128i alphaTh1)
+{
+	__m128 bias = _mm_set1_ps(128.f);
+	__m128 fy = _mm_cvtepi32_ps(y);
+	__m128 fcb = _mm_sub_ps(_mm_cvtepi32_ps(cb), bias);
+	__m128 fcr = _mm_sub_ps(_mm_cvtepi32_ps(cr), bias);
+
+	__m128 fr = _mm_add_ps(fy, _mm_mul_ps(_mm_set1_ps(1.402f), fcr));
+	__m128 fg = _mm_sub_ps(_mm_sub_ps(fy, _mm_mul_ps(_mm_set1_ps(0.34414f), fcb)), _mm_mul_ps(_mm_set1_ps(0.71414f), fcr));
+	__m128 fb = _mm_add_ps(fy, _mm_mul_ps(_mm_set1_ps(1.772f), fcb));
+
+	__m128 minValue = _mm_setzero_ps();
+	__m128 maxValue = _mm_set1_ps(255.f);
+	__m128i r = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(fr, minValue), maxValue));
+	__m128i g = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(fg, minValue), maxValue));
+	__m128i b = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(fb, minValue), maxValue));
+
+	//All components are below a threshold if the largest one is
+	__m128i maxRg = _mm_max_epi16(r, g);
+	__m128i maxRgb = _mm_max_epi16(maxRg, b);
+	__m128i belowTh0 = _mm_cmplt_epi32(maxRgb, alphaTh0);
+	__m128i belowTh1 = _mm_cmplt_epi32(maxRgb, alphaTh1);
+	__m128i a = _mm_sub_epi32(_mm_set1_epi32(0x80), _mm_and_si128(belowTh1, _mm_set1_epi32(0x40)));
+	a = _mm_andnot_si128(belowTh0, a);
+
+	__m128i result = r;
+	result = _mm_or_si128(result, _mm_slli_epi32(g, 8));
+	result = _mm_or_si128(result, _mm_slli_epi32(b, 16));
+	result = _mm_or_si128(result, _mm_slli_epi32(a, 24));
+	return result;
+}
+
+void CCsc::ConvertToRgba32(const uint8* block, uint32* output, uint16 alphaTh0, uint16 alphaTh1)
+{
+	const uint8* blockY = block;
+	const uint8* blockCb = block + 0x100;
+	const uint8* blockCr = block + 0x140;
+
+	__m128i zero = _mm_setzero_si128();
+	__m128i th0 = _mm_set1_epi32(alphaTh0 & 0x1FF);
+	__m128i th1 = _mm_set1_epi32(alphaTh1 & 0x1FF);
+
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		__m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(blockY + (i * 0x10)));
+		__m128i yLo = _mm_unpacklo_epi8(y, zero);
+		__m128i yHi = _mm_unpackhi_epi8(y, zero);
+
+		//Chroma is subsampled in both directions, each value covers 2 pixels on 2 rows
+		uint32 chromaOffset = (i / 2) * 8;
+		__m128i cb = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(blockCb + chromaOffset));
+		__m128i cr = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(blockCr + chromaOffset));
+		cb = _mm_unpacklo_epi8(cb, cb);
+		cr = _mm_unpacklo_epi8(cr, cr);
+		__m128i cbLo = _mm_unpacklo_epi8(cb, zero);
+		__m128i cbHi = _mm_unpackhi_epi8(cb, zero);
+		__m128i crLo = _mm_unpacklo_epi8(cr, zero);
+		__m128i crHi = _mm_unpackhi_epi8(cr, zero);
+
+		auto dst = reinterpret_cast<__m128i*>(output + (i * 0x10));
+		_mm_storeu_si128(dst + 0, ConvertPixels(_mm_unpacklo_epi16(yLo, zero), _mm_unpacklo_epi16(cbLo, zero), _mm_unpacklo_epi16(crLo, zero), th0, th1));
+		_mm_storeu_si128(dst + 1, ConvertPixels(_mm_unpackhi_epi16(yLo, zero), _mm_unpackhi_epi16(cbLo, zero), _mm_unpackhi_epi16(crLo, zero), th0, th1));
+		_mm_storeu_si128(dst + 2, ConvertPixels(_mm_unpacklo_epi16(yHi, zero), _mm_unpacklo_epi16(cbHi, zero), _mm_unpacklo_epi16(crHi, zero), th0, th1));
+		_mm_storeu_si128(dst + 3, ConvertPixels(_mm_unpackhi_epi16(yHi, zero), _mm_unpackhi_epi16(cbHi, zero), _mm_unpackhi_epi16(crHi, zero), th0, th1));
+	}
+}
+
+void CCsc::ConvertToRgba16(const uint32* input, uint16* output, bool dither)
+{
+	__m128i channelMask = _mm_set1_epi32(0xFF);
+	__m128i maxValue = _mm_set1_epi16(255);
+	__m128i zero = _mm_setzero_si128();
+
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		__m128i ditherRow = zero;
+		if(dither)
+		{
+			const auto& row = g_ditherMatrix[i & 3];
+			ditherRow = _mm_set_epi16(row[3], row[2], row[1], row[0], row[3], row[2], row[1], row[0]);
+		}
+
+		for(unsigned int j = 0; j < 16; j += 8)
+		{
+			__m128i p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * 0x10) + j + 0));
+			__m128i p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * 0x10) + j + 4));
+
+			__m128i r = _mm_packs_epi32(_mm_and_si128(p0, channelMask), _mm_and_si128(p1, channelMask));
+			__m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 8), channelMask), _mm_and_si128(_mm_srli_epi32(p1, 8), channelMask));
+			__m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(p0, 16), channelMask), _mm_and_si128(_mm_srli_epi32(p1, 16), channelMask));
+			__m128i a = _mm_packs_epi32(_mm_srli_epi32(p0, 31), _mm_srli_epi32(p1, 31));
+
+			r = _mm_srli_epi16(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(r, ditherRow), zero), maxValue), 3);
+			g = _mm_srli_epi16(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(g, ditherRow), zero), maxValue), 3);
+			b = _mm_srli_epi16(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(b, ditherRow), zero), maxValue), 3);
+
+			__m128i result = r;
+			result = _mm_or_si128(result, _mm_slli_epi16(g, 5));
+			result = _mm_or_si128(result, _mm_slli_epi16(b, 10));
+			result = _mm_or_si128(result, _mm_slli_epi16(a, 15));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * 0x10) + j), result);
+		}
+	}
+}
+
+void CCsc::ClampToRaw8(const int16* input, uint8* output, uint32 count)
+{
+	assert((count % 0x10) == 0);
+	for(uint32 i = 0; i < count; i += 0x10)
+	{
+		__m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 0));
+		__m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i + 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi16(lo, hi));
+	}
+}
+
+#else
+
+static inline uint8 ComputeAlpha(uint8 r, uint8 g, uint8 b, uint16 alphaTh0, uint16 alphaTh1)
+{
+	if(r < alphaTh0 && g < alphaTh0 && b < alphaTh0)
+	{
+		return 0;
+	}
+	else if(r < alphaTh1 && g < alphaTh1 && b < alphaTh1)
+	{
+		return 0x40;
+	}
+	else
+	{
+		return 0x80;
+	}
+}
+
+void CCsc::ConvertToRgba32(const uint8* block, uint32* output, uint16 alphaTh0, uint16 alphaTh1)
+{
+	const uint8* blockY = block;
+	const uint8* blockCb = block + 0x100;
+	const uint8* blockCr = block + 0x140;
+
+	alphaTh0 &= 0x1FF;
+	alphaTh1 &= 0x1FF;
+
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		for(unsigned int j = 0; j < 16; j++)
+		{
+			uint32 chromaIndex = ((i / 2) * 8) + (j / 2);
+			float nY = blockY[(i * 0x10) + j];
+			float nCb = blockCb[chromaIndex];
+			float nCr = blockCr[chromaIndex];
+
+			float nR = nY + 1.402f * (nCr - 128);
+			float nG = nY - 0.34414f * (nCb - 128) - 0.71414f * (nCr - 128);
+			float nB = nY + 1.772f * (nCb - 128);
+
+			nR = std::clamp(nR, 0.f, 255.f);
+			nG = std::clamp(nG, 0.f, 255.f);
+			nB = std::clamp(nB, 0.f, 255.f);
+
+			uint8 r = static_cast<uint8>(nR);
+			uint8 g = static_cast<uint8>(nG);
+			uint8 b = static_cast<uint8>(nB);
+			uint8 a = ComputeAlpha(r, g, b, alphaTh0, alphaTh1);
+
+			output[(i * 0x10) + j] = (a << 24) | (b << 16) | (g << 8) | (r << 0);
+		}
+	}
+}
+
+void CCsc::ConvertToRgba16(const uint32* input, uint16* output, bool dither)
+{
+	for(unsigned int i = 0; i < 16; i++)
+	{
+		for(unsigned int j = 0; j < 16; j++)
+		{
+			uint32 pixel = input[(i * 0x10) + j];
+			int16 ditherValue = dither ? g_ditherMatrix[i & 3][j & 3] : 0;
+			auto convertChannel = [&](uint32 shift) {
+				int16 value = static_cast<int16>((pixel >> shift) & 0xFF) + ditherValue;
+				return static_cast<uint16>(std::clamp<int16>(value, 0, 255) >> 3);
+			};
+			uint16 result = 0;
+			result |= convertChannel(0) << 0;
+			result |= convertChannel(8) << 5;
+			result |= convertChannel(16) << 10;
+			result |= ((pixel & 0x80000000) >> 31) << 15;
+			output[(i * 0x10) + j] = result;
+		}
+	}
+}
+
+void CCsc::ClampToRaw8(const int16* input, uint8* output, uint32 count)
+{
+	for(uint32 i = 0; i < count; i++)
+	{
+		output[i] = static_cast<uint8>(std::clamp<int16>(input[i], 0, 255));
+	}
+}
+
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Types.h"
+
+namespace IPU
+{
+	//Color space conversion kernels used by CSC and IDEC
+	class CCsc
+	{
+	public:
+		enum
+		{
+			MACROBLOCK_PIXELS = 0x100,
+		};
+
+		//Converts a 16x16 macroblock (Y followed by 8x8 Cb and 8x8 Cr) to RGBA32, alpha is set according to thresholds.
+		static void ConvertToRgba32(const uint8*, uint32*, uint16, uint16);
+
+		//Packs RGBA32 pixels of a macroblock to RGBA16, optionally applying the 4x4 ordered dither.
+		static void ConvertToRgba16(const uint32*, uint16*, bool);
+
+		//Clamps decoded values to [0, 255].
+		static void ClampToRaw8(const int16*, uint8*, uint32);
+	};
+}
@@ -0,0 +1,182 @@
+#include <cassert>
+#include <utility>
+#include "IPU_DctCoefficientLookup.h"
+#include "IPU_ProbeStream.h"
+#include "mpeg2/DctCoefficientTable0.h"
+#include "mpeg2/DctCoefficientTable1.h"
+
+using namespace IPU;
+
+CDctCoefficientLookup::CDctCoefficientLookup(MPEG2::CDctCoefficientTable& table, bool firstCoefficient)
+{
+	bool escapeSupported = IsEscapeSupported(table, firstCoefficient);
+	for(uint32 i = 0; i < m_entries.size(); i++)
+	{
+		auto& entry = m_entries[i];
+		if((i >> (LOOKUPBITS - LONGCODE_PREFIXBITS)) == 0)
+		{
+			entry.type = ENTRY_TYPE_LONGCODE;
+			continue;
+		}
+		if((i >> (LOOKUPBITS - ESCAPE_CODEBITS)) == 1)
+		{
+			if(escapeSupported)
+			{
+				entry.type = ENTRY_TYPE_ESCAPE;
+				entry.length = ESCAPE_CODEBITS;
+			}
+			continue;
+		}
+		entry = MakeCoefficientEntry(table, firstCoefficient, i << (32 - LOOKUPBITS), LOOKUPBITS);
+	}
+
+	for(uint32 i = 0; i < m_longCodeEntries.size(); i++)
+	{
+		//Prefix zeros are implied
+		m_longCodeEntries[i] = MakeCoefficientEntry(table, firstCoefficient, i << (32 - LONGCODE_BITS), LONGCODE_BITS);
+	}
+}
+
+const CDctCoefficientLookup& CDctCoefficientLookup::GetInstance(TABLE table, bool firstCoefficient)
+{
+	switch(table)
+	{
+	default:
+		assert(false);
+		[[fallthrough]];
+	case TABLE_0:
+		if(firstCoefficient)
+		{
+			static const CDctCoefficientLookup table0Dc(MPEG2::CDctCoefficientTable0::GetInstance(), true);
+			return table0Dc;
+		}
+		else
+		{
+			static const CDctCoefficientLookup table0(MPEG2::CDctCoefficientTable0::GetInstance(), false);
+			return table0;
+		}
+	case TABLE_1:
+		if(firstCoefficient)
+		{
+			static const CDctCoefficientLookup table1Dc(MPEG2::CDctCoefficientTable1::GetInstance(), true);
+			return table1Dc;
+		}
+		else
+		{
+			static const CDctCoefficientLookup table1(MPEG2::CDctCoefficientTable1::GetInstance(), false);
+			return table1;
+		}
+	}
+}
+
+CDctCoefficientLookup::RESULT CDctCoefficientLookup::TryDecode(Framework::CBitStream* stream, bool isMpeg2, MPEG2::RUNLEVELPAIR& runLevelPair) const
+{
+	uint32 bits = 0;
+	if(!stream->TryPeekBits_MSBF(LOOKUPBITS, bits)) return RESULT_MISS;
+	const auto* entry = &m_entries[bits];
+	if(entry->type == ENTRY_TYPE_LONGCODE)
+	{
+		if(!stream->TryPeekBits_MSBF(LONGCODE_BITS, bits)) return RESULT_MISS;
+		entry = &m_longCodeEntries[bits & ((1 << LONGCODE_LOOKUPBITS) - 1)];
+	}
+	switch(entry->type)
+	{
+	case ENTRY_TYPE_COEFFICIENT:
+		stream->Advance(entry->length);
+		runLevelPair.run = entry->run;
+		runLevelPair.level = entry->level;
+		return RESULT_COEFFICIENT;
+	case ENTRY_TYPE_ENDOFBLOCK:
+		stream->Advance(entry->length);
+		return RESULT_ENDOFBLOCK;
+	case ENTRY_TYPE_ESCAPE:
+	{
+		//MPEG-1 escapes have a variable length level, leave them to the table
+		if(!isMpeg2) return RESULT_MISS;
+		if(!stream->TryPeekBits_MSBF(ESCAPE_BITS, bits)) return RESULT_MISS;
+		int32 level = bits & ((1 << ESCAPE_LEVELBITS) - 1);
+		if(level & (1 << (ESCAPE_LEVELBITS - 1)))
+		{
+			level -= (1 << ESCAPE_LEVELBITS);
+		}
+		//Forbidden levels, let the table deal with them
+		if((level == 0) || (level == -(1 << (ESCAPE_LEVELBITS - 1)))) return RESULT_MISS;
+		stream->Advance(ESCAPE_BITS);
+		runLevelPair.run = (bits >> ESCAPE_LEVELBITS) & ((1 << ESCAPE_RUNBITS) - 1);
+		runLevelPair.level = level;
+		return RESULT_COEFFICIENT;
+	}
+	default:
+		return RESULT_MISS;
+	}
+}
+
+CDctCoefficientLookup::ENTRY CDctCoefficientLookup::MakeCoefficientEntry(MPEG2::CDctCoefficientTable& table, bool firstCoefficient, uint32 probeBits, uint8 maxLength)
+{
+	ENTRY entry;
+	try
+	{
+		if(!firstCoefficient)
+		{
+			bool isEob = false;
+			CProbeStream eobStream(probeBits);
+			if(table.TryIsEndOfBlock(&eobStream, isEob) != MPEG2::CVLCTable::DECODE_STATUS_SUCCESS)
+			{
+				return entry;
+			}
+			if(isEob)
+			{
+				CProbeStream skipStream(probeBits);
+				if(table.TrySkipEndOfBlock(&skipStream) != MPEG2::CVLCTable::DECODE_STATUS_SUCCESS) return entry;
+				if(skipStream.GetBitIndex() > maxLength) return entry;
+				entry.type = ENTRY_TYPE_ENDOFBLOCK;
+				entry.length = skipStream.GetBitIndex();
+				return entry;
+			}
+		}
+
+		MPEG2::RUNLEVELPAIR runLevelPair;
+		CProbeStream stream(probeBits);
+		auto result = firstCoefficient ? table.TryGetRunLevelPairDc(&stream, &runLevelPair, true)
+		                               : table.TryGetRunLevelPair(&stream, &runLevelPair, true);
+		if(result != MPEG2::CVLCTable::DECODE_STATUS_SUCCESS) return entry;
+		if(stream.GetBitIndex() > maxLength) return entry;
+		entry.type = ENTRY_TYPE_COEFFICIENT;
+		entry.length = stream.GetBitIndex();
+		entry.run = static_cast<uint8>(runLevelPair.run);
+		entry.level = static_cast<int16>(runLevelPair.level);
+	}
+	catch(...)
+	{
+		//Invalid or truncated pattern, leave it to the original table
+		entry = ENTRY();
+	}
+	return entry;
+}
+
+bool CDctCoefficientLookup::IsEscapeSupported(MPEG2::CDctCoefficientTable& table, bool firstCoefficient)
+{
+	//Only read escapes ourselves if the table agrees on their MPEG-2 layout
+	static const std::pair<uint32, int32> testLevels[] = {{0x001, 1}, {0x7FF, 2047}, {0x801, -2047}, {0xFFF, -1}};
+	static const uint32 testRun = 0x2A;
+	for(const auto& testLevel : testLevels)
+	{
+		uint32 probeBits = (1 << (ESCAPE_RUNBITS + ESCAPE_LEVELBITS)) | (testRun << ESCAPE_LEVELBITS) | testLevel.first;
+		probeBits <<= (32 - ESCAPE_BITS);
+		try
+		{
+			MPEG2::RUNLEVELPAIR runLevelPair;
+			CProbeStream stream(probeBits);
+			auto result = firstCoefficient ? table.TryGetRunLevelPairDc(&stream, &runLevelPair, true)
+			                               : table.TryGetRunLevelPair(&stream, &runLevelPair, true);
+			if(result != MPEG2::CVLCTable::DECODE_STATUS_SUCCESS) return false;
+			if(stream.GetBitIndex() != ESCAPE_BITS) return false;
+			if((runLevelPair.run != testRun) || (runLevelPair.level != testLevel.second)) return false;
+		}
+		catch(...)
+		{
+			return false;
+		}
+	}
+	return true;
+}
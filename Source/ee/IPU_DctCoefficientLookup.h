@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include "Types.h"
+#include "mpeg2/DctCoefficientTable.h"
+
+namespace IPU
+{
+	//Lookup decoder for DCT coefficient codes (B.14/B.15). Entries are derived from the bit-serial tables once.
+	//Short codes are indexed by the next LOOKUPBITS bits of the stream, codes starting with LONGCODE_PREFIXBITS
+	//zeros go through a secondary table indexed by the bits that follow the prefix and MPEG-2 escapes are read
+	//directly. Anything else (MPEG-1 escapes, invalid codes, not enough data) must go through the original table.
+	class CDctCoefficientLookup
+	{
+	public:
+		enum
+		{
+			LOOKUPBITS = 10,
+			LONGCODE_PREFIXBITS = 6,
+			LONGCODE_LOOKUPBITS = 11,
+			LONGCODE_BITS = LONGCODE_PREFIXBITS + LONGCODE_LOOKUPBITS,
+			ESCAPE_CODEBITS = 6,
+			ESCAPE_RUNBITS = 6,
+			ESCAPE_LEVELBITS = 12,
+			ESCAPE_BITS = ESCAPE_CODEBITS + ESCAPE_RUNBITS + ESCAPE_LEVELBITS,
+		};
+
+		enum TABLE
+		{
+			TABLE_0,
+			TABLE_1,
+		};
+
+		enum RESULT
+		{
+			RESULT_MISS,
+			RESULT_COEFFICIENT,
+			RESULT_ENDOFBLOCK,
+		};
+
+		CDctCoefficientLookup(MPEG2::CDctCoefficientTable&, bool);
+
+		//First coefficient lookups use the "Dc" variant of the table and never report an end of block.
+		static const CDctCoefficientLookup& GetInstance(TABLE, bool);
+
+		//Stream is left untouched on a miss
+		RESULT TryDecode(Framework::CBitStream*, bool, MPEG2::RUNLEVELPAIR&) const;
+
+	private:
+		enum ENTRY_TYPE : uint8
+		{
+			ENTRY_TYPE_NONE,
+			ENTRY_TYPE_COEFFICIENT,
+			ENTRY_TYPE_ENDOFBLOCK,
+			ENTRY_TYPE_LONGCODE,
+			ENTRY_TYPE_ESCAPE,
+		};
+
+		struct ENTRY
+		{
+			ENTRY_TYPE type = ENTRY_TYPE_NONE;
+			uint8 length = 0;
+			uint8 run = 0;
+			int16 level = 0;
+		};
+
+		static ENTRY MakeCoefficientEntry(MPEG2::CDctCoefficientTable&, bool, uint32, uint8);
+		static bool IsEscapeSupported(MPEG2::CDctCoefficientTable&, bool);
+
+		std::array<ENTRY, 1 << LOOKUPBITS> m_entries;
+		std::array<ENTRY, 1 << LONGCODE_LOOKUPBITS> m_longCodeEntries;
+	};
+}
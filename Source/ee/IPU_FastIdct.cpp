@@ -0,0 +1,298 @@
+#include <algorithm>
+#include "IPU_FastIdct.h"
+#include "SimdDefs.h"
+
+#ifdef FRAMEWORK_SIMD_USE_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace IPU;
+
+//2048 * sqrt(2) * cos(k * pi / 16)
+enum
+{
+	W1 = 2841,
+	W2 = 2676,
+	W3 = 2408,
+	W5 = 1609,
+	W6 = 1108,
+	W7 = 565,
+};
+
+void CFastIdct::TransformScalar(const int16* input, int16* output)
+{
+	int16 block[0x40];
+
+	//Rows
+	for(unsigned int row = 0; row < 8; row++)
+	{
+		const int16* src = input + (row * 8);
+		int16* dst = block + (row * 8);
+
+		int32 x1 = src[4] << 11;
+		int32 x2 = src[6];
+		int32 x3 = src[2];
+		int32 x4 = src[1];
+		int32 x5 = src[7];
+		int32 x6 = src[5];
+		int32 x7 = src[3];
+
+		if(!(x1 | x2 | x3 | x4 | x5 | x6 | x7))
+		{
+			std::fill(dst, dst + 8, static_cast<int16>(src[0] * 8));
+			continue;
+		}
+
+		int32 x0 = (src[0] << 11) + 128;
+
+		int32 x8 = W7 * (x4 + x5);
+		x4 = x8 + (W1 - W7) * x4;
+		x5 = x8 - (W1 + W7) * x5;
+		x8 = W3 * (x6 + x7);
+		x6 = x8 - (W3 - W5) * x6;
+		x7 = x8 - (W3 + W5) * x7;
+
+		x8 = x0 + x1;
+		x0 -= x1;
+		x1 = W6 * (x3 + x2);
+		x2 = x1 - (W2 + W6) * x2;
+		x3 = x1 + (W2 - W6) * x3;
+		x1 = x4 + x6;
+		x4 -= x6;
+		x6 = x5 + x7;
+		x5 -= x7;
+
+		x7 = x8 + x3;
+		x8 -= x3;
+		x3 = x0 + x2;
+		x0 -= x2;
+		x2 = (181 * (x4 + x5) + 128) >> 8;
+		x4 = (181 * (x4 - x5) + 128) >> 8;
+
+		dst[0] = static_cast<int16>((x7 + x1) >> 8);
+		dst[1] = static_cast<int16>((x3 + x2) >> 8);
+		dst[2] = static_cast<int16>((x0 + x4) >> 8);
+		dst[3] = static_cast<int16>((x8 + x6) >> 8);
+		dst[4] = static_cast<int16>((x8 - x6) >> 8);
+		dst[5] = static_cast<int16>((x0 - x4) >> 8);
+		dst[6] = static_cast<int16>((x3 - x2) >> 8);
+		dst[7] = static_cast<int16>((x7 - x1) >> 8);
+	}
+
+	//Columns
+	auto clamp = [](int32 value) { return static_cast<int16>(std::clamp<int32>(value, -256, 255)); };
+	for(unsigned int col = 0; col < 8; col++)
+	{
+		const int16* src = block + col;
+		int16* dst = output + col;
+
+		int32 x1 = src[8 * 4] << 8;
+		int32 x2 = src[8 * 6];
+		int32 x3 = src[8 * 2];
+		int32 x4 = src[8 * 1];
+		int32 x5 = src[8 * 7];
+		int32 x6 = src[8 * 5];
+		int32 x7 = src[8 * 3];
+
+		if(!(x1 | x2 | x3 | x4 | x5 | x6 | x7))
+		{
+			int16 value = clamp((src[8 * 0] + 32) >> 6);
+			for(unsigned int i = 0; i < 8; i++)
+			{
+				dst[8 * i] = value;
+			}
+			continue;
+		}
+
+		int32 x0 = (src[8 * 0] << 8) + 8192;
+
+		int32 x8 = W7 * (x4 + x5) + 4;
+		x4 = (x8 + (W1 - W7) * x4) >> 3;
+		x5 = (x8 - (W1 + W7) * x5) >> 3;
+		x8 = W3 * (x6 + x7) + 4;
+		x6 = (x8 - (W3 - W5) * x6) >> 3;
+		x7 = (x8 - (W3 + W5) * x7) >> 3;
+
+		x8 = x0 + x1;
+		x0 -= x1;
+		x1 = W6 * (x3 + x2) + 4;
+		x2 = (x1 - (W2 + W6) * x2) >> 3;
+		x3 = (x1 + (W2 - W6) * x3) >> 3;
+		x1 = x4 + x6;
+		x4 -= x6;
+		x6 = x5 + x7;
+		x5 -= x7;
+
+		x7 = x8 + x3;
+		x8 -= x3;
+		x3 = x0 + x2;
+		x0 -= x2;
+		x2 = (181 * (x4 + x5) + 128) >> 8;
+		x4 = (181 * (x4 - x5) + 128) >> 8;
+
+		dst[8 * 0] = clamp((x7 + x1) >> 14);
+		dst[8 * 1] = clamp((x3 + x2) >> 14);
+		dst[8 * 2] = clamp((x0 + x4) >> 14);
+		dst[8 * 3] = clamp((x8 + x6) >> 14);
+		dst[8 * 4] = clamp((x8 - x6) >> 14);
+		dst[8 * 5] = clamp((x0 - x4) >> 14);
+		dst[8 * 6] = clamp((x3 - x2) >> 14);
+		dst[8 * 7] = clamp((x7 - x1) >> 14);
+	}
+}
+
+#ifdef FRAMEWORK_SIMD_USE_SSE
+
+static inline void Transpose8x8(__m128i* rows)
+{
+	__m128i a0 = _mm_unpacklo_epi16(rows[0], rows[1]);
+	__m128i a1 = _mm_unpackhi_epi16(rows[0], rows[1]);
+	__m128i a2 = _mm_unpacklo_epi16(rows[2], rows[3]);
+	__m128i a3 = _mm_unpackhi_epi16(rows[2], rows[3]);
+	__m128i a4 = _mm_unpacklo_epi16(rows[4], rows[5]);
+	__m128i a5 = _mm_unpackhi_epi16(rows[4], rows[5]);
+	__m128i a6 = _mm_unpacklo_epi16(rows[6], rows[7]);
+	__m128i a7 = _mm_unpackhi_epi16(rows[6], rows[7]);
+
+	__m128i b0 = _mm_unpacklo_epi32(a0, a2);
+	__m128i b1 = _mm_unpackhi_epi32(a0, a2);
+	__m128i b2 = _mm_unpacklo_epi32(a1, a3);
+	__m128i b3 = _mm_unpackhi_epi32(a1, a3);
+	__m128i b4 = _mm_unpacklo_epi32(a4, a6);
+	__m128i b5 = _mm_unpackhi_epi32(a4, a6);
+	__m128i b6 = _mm_unpacklo_epi32(a5, a7);
+	__m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+	rows[0] = _mm_unpacklo_epi64(b0, b4);
+	rows[1] = _mm_unpackhi_epi64(b0, b4);
+	rows[2] = _mm_unpacklo_epi64(b1, b5);
+	rows[3] = _mm_unpackhi_epi64(b1, b5);
+	rows[4] = _mm_unpacklo_epi64(b2, b6);
+	rows[5] = _mm_unpackhi_epi64(b2, b6);
+	rows[6] = _mm_unpacklo_epi64(b3, b7);
+	rows[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+static inline __m128i MakeCoefficientPair(int16 first, int16 second)
+{
+	return _mm_set_epi16(second, first, second, first, second, first, second, first);
+}
+
+static inline __m128i Mul181(__m128i value)
+{
+	//181 = 128 + 32 + 16 + 4 + 1
+	__m128i result = _mm_add_epi32(_mm_slli_epi32(value, 7), _mm_slli_epi32(value, 5));
+	result = _mm_add_epi32(result, _mm_add_epi32(_mm_slli_epi32(value, 4), _mm_slli_epi32(value, 2)));
+	return _mm_add_epi32(result, value);
+}
+
+//Same arithmetic as the scalar version on 4 lanes of 32-bit values. Products are
+//expanded (ie.: W7 * (x4 + x5) + (W1 - W7) * x4 = W1 * x4 + W7 * x5) to use pmaddwd.
+template <bool isColumnPass, bool isHighHalf>
+static inline void IdctPassHalf(const __m128i* input, __m128i* output)
+{
+	auto interleave = [](__m128i first, __m128i second) {
+		return isHighHalf ? _mm_unpackhi_epi16(first, second) : _mm_unpacklo_epi16(first, second);
+	};
+	auto roundProduct = [](__m128i value) {
+		return isColumnPass ? _mm_srai_epi32(_mm_add_epi32(value, _mm_set1_epi32(4)), 3) : value;
+	};
+
+	static constexpr int baseShift = isColumnPass ? 8 : 11;
+	static constexpr int32 baseBias = isColumnPass ? 8192 : 128;
+
+	__m128i x0 = _mm_srai_epi32(interleave(input[0], input[0]), 16);
+	__m128i x1 = _mm_srai_epi32(interleave(input[4], input[4]), 16);
+	x0 = _mm_add_epi32(_mm_slli_epi32(x0, baseShift), _mm_set1_epi32(baseBias));
+	x1 = _mm_slli_epi32(x1, baseShift);
+
+	__m128i in17 = interleave(input[1], input[7]);
+	__m128i x4 = roundProduct(_mm_madd_epi16(in17, MakeCoefficientPair(W1, W7)));
+	__m128i x5 = roundProduct(_mm_madd_epi16(in17, MakeCoefficientPair(W7, -W1)));
+
+	__m128i in53 = interleave(input[5], input[3]);
+	__m128i x6 = roundProduct(_mm_madd_epi16(in53, MakeCoefficientPair(W5, W3)));
+	__m128i x7 = roundProduct(_mm_madd_epi16(in53, MakeCoefficientPair(W3, -W5)));
+
+	__m128i in26 = interleave(input[2], input[6]);
+	__m128i x2 = roundProduct(_mm_madd_epi16(in26, MakeCoefficientPair(W6, -W2)));
+	__m128i x3 = roundProduct(_mm_madd_epi16(in26, MakeCoefficientPair(W2, W6)));
+
+	__m128i x8 = _mm_add_epi32(x0, x1);
+	x0 = _mm_sub_epi32(x0, x1);
+	x1 = _mm_add_epi32(x4, x6);
+	x4 = _mm_sub_epi32(x4, x6);
+	x6 = _mm_add_epi32(x5, x7);
+	x5 = _mm_sub_epi32(x5, x7);
+
+	x7 = _mm_add_epi32(x8, x3);
+	x8 = _mm_sub_epi32(x8, x3);
+	x3 = _mm_add_epi32(x0, x2);
+	x0 = _mm_sub_epi32(x0, x2);
+	__m128i bias128 = _mm_set1_epi32(128);
+	x2 = _mm_srai_epi32(_mm_add_epi32(Mul181(_mm_add_epi32(x4, x5)), bias128), 8);
+	x4 = _mm_srai_epi32(_mm_add_epi32(Mul181(_mm_sub_epi32(x4, x5)), bias128), 8);
+
+	static constexpr int resultShift = isColumnPass ? 14 : 8;
+	output[0] = _mm_srai_epi32(_mm_add_epi32(x7, x1), resultShift);
+	output[1] = _mm_srai_epi32(_mm_add_epi32(x3, x2), resultShift);
+	output[2] = _mm_srai_epi32(_mm_add_epi32(x0, x4), resultShift);
+	output[3] = _mm_srai_epi32(_mm_add_epi32(x8, x6), resultShift);
+	output[4] = _mm_srai_epi32(_mm_sub_epi32(x8, x6), resultShift);
+	output[5] = _mm_srai_epi32(_mm_sub_epi32(x0, x4), resultShift);
+	output[6] = _mm_srai_epi32(_mm_sub_epi32(x3, x2), resultShift);
+	output[7] = _mm_srai_epi32(_mm_sub_epi32(x7, x1), resultShift);
+}
+
+static inline __m128i TruncatePack(__m128i lo, __m128i hi)
+{
+	//Match the scalar version's truncation to 16 bits instead of saturating
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+void CFastIdct::TransformSse(const int16* input, int16* output)
+{
+	__m128i block[8];
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		block[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + (i * 8)));
+	}
+
+	//Each vector holds the same coefficient of every row
+	Transpose8x8(block);
+
+	__m128i lo[8], hi[8];
+	IdctPassHalf<false, false>(block, lo);
+	IdctPassHalf<false, true>(block, hi);
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		block[i] = TruncatePack(lo[i], hi[i]);
+	}
+
+	//Back to rows, lanes are now the columns
+	Transpose8x8(block);
+
+	IdctPassHalf<true, false>(block, lo);
+	IdctPassHalf<true, true>(block, hi);
+	__m128i minValue = _mm_set1_epi16(-256);
+	__m128i maxValue = _mm_set1_epi16(255);
+	for(unsigned int i = 0; i < 8; i++)
+	{
+		__m128i result = _mm_packs_epi32(lo[i], hi[i]);
+		result = _mm_min_epi16(_mm_max_epi16(result, minValue), maxValue);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(output + (i * 8)), result);
+	}
+}
+
+#endif
+
+void CFastIdct::Transform(const int16* input, int16* output)
+{
+#ifdef FRAMEWORK_SIMD_USE_SSE
+	TransformSse(input, output);
+#else
+	TransformScalar(input, output);
+#endif
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Types.h"
+#include "SimdDefs.h"
+
+namespace IPU
+{
+	//Integer 8x8 IDCT (Chen-Wang), meets the IEEE 1180 accuracy requirements.
+	//Output is clamped to [-256, 255]. Input and output may point to the same block.
+	class CFastIdct
+	{
+	public:
+		static void Transform(const int16*, int16*);
+
+		//Implementations used by Transform, exposed for testing
+		static void TransformScalar(const int16*, int16*);
+#ifdef FRAMEWORK_SIMD_USE_SSE
+		static void TransformSse(const int16*, int16*);
+#endif
+	};
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cassert>
+#include "BitStream.h"
+
+namespace IPU
+{
+	//Bit stream over a single word, used to run the bit-serial VLC tables on every possible pattern when building lookups
+	class CProbeStream : public Framework::CBitStream
+	{
+	public:
+		CProbeStream(uint32 bits)
+		    : m_bits(bits)
+		{
+		}
+
+		void Advance(uint8 size) override
+		{
+			if((m_bitPosition + size) > 32)
+			{
+				throw CBitStreamException();
+			}
+			m_bitPosition += size;
+		}
+
+		uint8 GetBitIndex() const override
+		{
+			return m_bitPosition;
+		}
+
+		bool TryPeekBits_LSBF(uint8, uint32&) override
+		{
+			return false;
+		}
+
+		bool TryPeekBits_MSBF(uint8 size, uint32& result) override
+		{
+			assert(size != 0);
+			if((m_bitPosition + size) > 32)
+			{
+				return false;
+			}
+			uint64 bits = static_cast<uint64>(m_bits) << (32 + m_bitPosition);
+			result = static_cast<uint32>(bits >> (64 - size));
+			return true;
+		}
+
+	private:
+		uint32 m_bits = 0;
+		uint8 m_bitPosition = 0;
+	};
+}
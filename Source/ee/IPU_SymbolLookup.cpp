@@ -0,0 +1,76 @@
+#include <cassert>
+#include "IPU_SymbolLookup.h"
+#include "IPU_ProbeStream.h"
+#include "IPU_DmVectorTable.h"
+#include "IPU_MacroblockAddressIncrementTable.h"
+#include "IPU_MacroblockTypeBTable.h"
+#include "IPU_MacroblockTypeITable.h"
+#include "IPU_MacroblockTypePTable.h"
+#include "IPU_MotionCodeTable.h"
+
+using namespace IPU;
+
+CSymbolLookup::CSymbolLookup(MPEG2::CVLCTable& table, unsigned int lookupBits)
+    : m_lookupBits(static_cast<uint8>(lookupBits))
+    , m_entries(1 << lookupBits)
+{
+	assert(lookupBits <= 16);
+	for(uint32 i = 0; i < m_entries.size(); i++)
+	{
+		auto& entry = m_entries[i];
+		try
+		{
+			uint32 symbol = 0;
+			CProbeStream stream(i << (32 - lookupBits));
+			if(table.TryGetSymbol(&stream, symbol) != MPEG2::CVLCTable::DECODE_STATUS_SUCCESS) continue;
+			if(stream.GetBitIndex() > lookupBits) continue;
+			entry.symbol = symbol;
+			entry.length = stream.GetBitIndex();
+		}
+		catch(...)
+		{
+			//Invalid pattern, leave it to the original table
+			entry = ENTRY();
+		}
+	}
+}
+
+const CSymbolLookup& CSymbolLookup::GetInstance(TABLE table)
+{
+	switch(table)
+	{
+	default:
+		assert(false);
+		[[fallthrough]];
+	case TABLE_MBADDRESSINCREMENT:
+	{
+		static const CSymbolLookup lookup(*CMacroblockAddressIncrementTable::GetInstance(), CMacroblockAddressIncrementTable::MAXBITS);
+		return lookup;
+	}
+	case TABLE_MBTYPE_I:
+	{
+		static const CSymbolLookup lookup(*CMacroblockTypeITable::GetInstance(), CMacroblockTypeITable::MAXBITS);
+		return lookup;
+	}
+	case TABLE_MBTYPE_P:
+	{
+		static const CSymbolLookup lookup(*CMacroblockTypePTable::GetInstance(), CMacroblockTypePTable::MAXBITS);
+		return lookup;
+	}
+	case TABLE_MBTYPE_B:
+	{
+		static const CSymbolLookup lookup(*CMacroblockTypeBTable::GetInstance(), CMacroblockTypeBTable::MAXBITS);
+		return lookup;
+	}
+	case TABLE_MOTIONCODE:
+	{
+		static const CSymbolLookup lookup(*CMotionCodeTable::GetInstance(), CMotionCodeTable::MAXBITS);
+		return lookup;
+	}
+	case TABLE_DMVECTOR:
+	{
+		static const CSymbolLookup lookup(*CDmVectorTable::GetInstance(), CDmVectorTable::MAXBITS);
+		return lookup;
+	}
+	}
+}
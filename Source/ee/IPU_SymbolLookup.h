@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include "Types.h"
+#include "mpeg2/VLCTable.h"
+
+namespace IPU
+{
+	//Single lookup decoder for the macroblock and motion VLC tables, indexed by the next MAXBITS bits of the stream.
+	//Entries are derived from the bit-serial tables once, patterns that don't decode to a symbol have a null length.
+	class CSymbolLookup
+	{
+	public:
+		enum TABLE
+		{
+			TABLE_MBADDRESSINCREMENT,
+			TABLE_MBTYPE_I,
+			TABLE_MBTYPE_P,
+			TABLE_MBTYPE_B,
+			TABLE_MOTIONCODE,
+			TABLE_DMVECTOR,
+		};
+
+		CSymbolLookup(MPEG2::CVLCTable&, unsigned int);
+
+		static const CSymbolLookup& GetInstance(TABLE);
+
+		//Returns false without touching the stream if the table needs to be used instead
+		bool TryGetSymbol(Framework::CBitStream* stream, uint32& symbol) const
+		{
+			uint32 bits = 0;
+			if(!stream->TryPeekBits_MSBF(m_lookupBits, bits)) return false;
+			const auto& entry = m_entries[bits];
+			if(entry.length == 0) return false;
+			stream->Advance(entry.length);
+			symbol = entry.symbol;
+			return true;
+		}
+
+	private:
+		struct ENTRY
+		{
+			uint32 symbol = 0;
+			uint8 length = 0;
+		};
+
+		uint8 m_lookupBits = 0;
+		std::vector<ENTRY> m_entries;
+	};
+}
@@ -34,6 +34,11 @@ void CMA_VU::SetRelativePipeTime(uint32 relativePipeTime)
 	m_Upper.SetRelativePipeTime(relativePipeTime);
 }
 
+uint32 CMA_VU::GetVuMemAddressMask() const
+{
+	return m_Lower.GetVuMemAddressMask();
+}
+
 void CMA_VU::SetupReflectionTables()
 {
 	m_Lower.SetupReflectionTables();
@@ -22,6 +22,8 @@ public:
 	void SetCompileHints(uint32) override;
 	void SetRelativePipeTime(uint32);
 
+	uint32 GetVuMemAddressMask() const;
+
 private:
 	void SetupReflectionTables();
 
@@ -176,6 +178,8 @@ private:
 	public:
 		CLower(uint32);
 
+		uint32 GetVuMemAddressMask() const;
+
 		void SetupReflectionTables();
 		void CompileInstruction(uint32, CMipsJitter*, CMIPS*, uint32) override;
 		void GetInstructionMnemonic(CMIPS*, uint32, uint32, char*, unsigned int);
@@ -54,6 +54,11 @@ void CMA_VU::CLower::CompileInstruction(uint32 address, CMipsJitter* codeGen, CM
 	}
 }
 
+uint32 CMA_VU::CLower::GetVuMemAddressMask() const
+{
+	return m_vuMemAddressMask;
+}
+
 void CMA_VU::CLower::SetRelativePipeTime(uint32 relativePipeTime)
 {
 	m_relativePipeTime = relativePipeTime;
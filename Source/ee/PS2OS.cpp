@@ -236,6 +236,9 @@ CPS2OS::CPS2OS(CMIPS& ee, uint8* ram, uint8* bios, uint8* spr, CGSHandler*& gs,
     , m_sifDmaNextIdx(&m_state->sifDmaNextIdx)
     , m_sifDmaTimes(m_state->sifDmaTimes)
     , m_threadSchedule(m_threads, &m_state->threadScheduleBase)
+    , m_threadScheduleIndex(MAX_THREAD,
+                            [this](uint32 threadId) -> uint32& { return GetThreadScheduleLink(threadId); },
+                            [this](uint32 threadId) { return m_threads[threadId]->currPriority; })
     , m_intcHandlerQueue(m_intcHandlers, &m_state->intcHandlerQueueBase)
     , m_dmacHandlerQueue(m_dmacHandlers, &m_state->dmacHandlerQueueBase)
 {
@@ -263,6 +266,7 @@ void CPS2OS::Initialize(uint32 ramSize)
 
 	SetVsyncFlagPtrs(0, 0);
 	UpdateTLBEnabledState();
+	RebuildThreadScheduleIndex();
 
 	AssembleCustomSyscallHandler();
 	AssembleInterruptHandler();
@@ -437,6 +441,7 @@ void CPS2OS::LoadELF(Framework::CStream* stream, const char* executablePath, con
 
 	LoadExecutableInternal();
 	ApplyGameConfig();
+	ApplyHleFunctions();
 
 	OnExecutableChange();
 
@@ -723,6 +728,30 @@ void CPS2OS::ApplyGameConfig()
 	}
 }
 
+void CPS2OS::SetHleFunctionsEnabled(bool enabled)
+{
+	m_hleFunctionsEnabled = enabled;
+}
+
+void CPS2OS::ApplyHleFunctions()
+{
+	//AOT blocks are only identified by their contents, they can't depend on where they're located
+#ifndef AOT_BUILD_CACHE
+	auto executor = static_cast<CEeExecutor*>(m_ee.m_executor.get());
+	if(!m_hleFunctionsEnabled)
+	{
+		executor->SetHleFunctionBlocks(CEeExecutor::HleFunctionBlockMap());
+		return;
+	}
+
+	auto executableRange = GetExecutableRange();
+	auto hleFunctions = Ee::CHleFunctions::FindFunctions(m_ram, m_ramSize, executableRange.first, executableRange.second);
+	CLog::GetInstance().Print(LOG_NAME, "Found %d library function(s) to run natively.\r\n", static_cast<int>(hleFunctions.size()));
+
+	executor->SetHleFunctionBlocks(std::move(hleFunctions));
+#endif
+}
+
 void CPS2OS::AssembleCustomSyscallHandler()
 {
 	CMIPSAssembler assembler((uint32*)&m_bios[0x100]);
@@ -1142,24 +1171,23 @@ uint32* CPS2OS::GetCustomSyscallTable()
 
 void CPS2OS::LinkThread(uint32 threadId)
 {
-	auto thread = m_threads[threadId];
+	m_threadScheduleIndex.Link(threadId);
+}
 
-	for(auto threadSchedulePair : m_threadSchedule)
-	{
-		auto scheduledThread = threadSchedulePair.second;
-		if(scheduledThread->currPriority > thread->currPriority)
-		{
-			m_threadSchedule.AddBefore(threadSchedulePair.first, threadId);
-			return;
-		}
-	}
+void CPS2OS::UnlinkThread(uint32 threadId)
+{
+	assert(m_threadScheduleIndex.IsLinked(threadId));
+	m_threadScheduleIndex.Unlink(threadId);
+}
 
-	m_threadSchedule.PushBack(threadId);
+void CPS2OS::RebuildThreadScheduleIndex()
+{
+	m_threadScheduleIndex.Rebuild();
 }
 
-void CPS2OS::UnlinkThread(uint32 threadId)
+uint32& CPS2OS::GetThreadScheduleLink(uint32 threadId) const
 {
-	m_threadSchedule.Unlink(threadId);
+	return (threadId == 0) ? m_state->threadScheduleBase : m_threads[threadId]->nextId;
 }
 
 void CPS2OS::ThreadShakeAndBake()
@@ -2369,15 +2397,10 @@ void CPS2OS::sc_RotateThreadReadyQueue()
 
 	//Find first of this priority and reinsert if it's the same as the current thread
 	//If it's not the same, the schedule will be rotated when another thread is choosen
-	for(auto threadSchedulePair : m_threadSchedule)
+	if(uint32 threadId = m_threadScheduleIndex.FindFirst(prio))
 	{
-		auto scheduledThread = threadSchedulePair.second;
-		if(scheduledThread->currPriority == prio)
-		{
-			UnlinkThread(threadSchedulePair.first);
-			LinkThread(threadSchedulePair.first);
-			break;
-		}
+		UnlinkThread(threadId);
+		LinkThread(threadId);
 	}
 
 	m_ee.m_State.nGPR[SC_RETURN].nD0 = static_cast<int32>(prio);
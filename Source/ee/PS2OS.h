@@ -10,6 +10,7 @@
 #include "../OsStructManager.h"
 #include "../OsVariableWrapper.h"
 #include "../OsStructQueue.h"
+#include "../ThreadPriorityIndex.h"
 #include "../gs/GSHandler.h"
 #include "SIF.h"
 #include "Ee_IdleEvaluator.h"
@@ -32,6 +33,12 @@ public:
 	void Initialize(uint32);
 	void Release();
 
+	//Must be called when the BIOS state in RAM was replaced (ie.: state load)
+	void RebuildThreadScheduleIndex();
+
+	//Run some statically linked library functions natively, applied when an executable is loaded
+	void SetHleFunctionsEnabled(bool);
+
 	bool IsIdle() const;
 
 	void BootFromFile(const fs::path&);
@@ -343,6 +350,7 @@ private:
 	void UnloadExecutable();
 
 	void ApplyGameConfig();
+	void ApplyHleFunctions();
 
 	void DisassembleSysCall(uint8);
 	std::string GetSysCallDescription(uint8);
@@ -362,6 +370,7 @@ private:
 	void CreateIdleThread();
 	void LinkThread(uint32);
 	void UnlinkThread(uint32);
+	uint32& GetThreadScheduleLink(uint32) const;
 	void ThreadShakeAndBake();
 	void ThreadSwitchContext(uint32);
 	void ThreadSaveContext(THREAD*, bool);
@@ -444,6 +453,7 @@ private:
 	uint32 m_ramSize = 0;
 	uint8* m_bios = nullptr;
 	uint8* m_spr = nullptr;
+	bool m_hleFunctionsEnabled = true;
 
 	CSIF& m_sif;
 	Ee::CLibMc2 m_libMc2;
@@ -467,6 +477,9 @@ private:
 	uint32* m_sifDmaTimes = nullptr;
 
 	ThreadQueue m_threadSchedule;
+
+	//Index over the thread schedule kept in RAM, rebuilt when that schedule is reset or loaded
+	CThreadPriorityIndex m_threadScheduleIndex;
 	IntcHandlerQueue m_intcHandlerQueue;
 	DmacHandlerQueue m_dmacHandlerQueue;
 
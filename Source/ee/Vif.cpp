@@ -84,6 +84,7 @@ void CVif::Reset()
 	m_writeTick = 0;
 	m_stream.Reset();
 	m_pendingMicroProgram = -1;
+	m_microProgramChanged = false;
 	m_incomingFifoDelay = 0;
 	m_interruptDelayTicks = 0;
 }
@@ -601,6 +602,7 @@ void CVif::Cmd_MPG(StreamType& stream, CODE nCommand)
 			    {
 				    m_vpu.InvalidateMicroProgram(start, start + size);
 				    memcpy(microMem + start, microProgramPtr, size);
+				    m_microProgramChanged = true;
 			    }
 		    };
 
@@ -631,6 +633,24 @@ void CVif::Cmd_MPG(StreamType& stream, CODE nCommand)
 	if((m_NUM == 0) && (nSize != 0))
 	{
 		m_STAT.nVPS = 0;
+
+		//Whole microprogram is uploaded, get it compiled before MSCAL/MSCNT needs it
+		if(m_microProgramChanged)
+		{
+			uint32 microMemSize = m_vpu.GetMicroMemorySize();
+			uint32 programStart = (m_CODE.nIMM * 8) & (microMemSize - 1);
+			uint32 programSize = std::min<uint32>(nCodeNum, microMemSize);
+			if((programStart + programSize) > microMemSize)
+			{
+				m_vpu.PrecompileMicroProgram(programStart, microMemSize);
+				m_vpu.PrecompileMicroProgram(0, programStart + programSize - microMemSize);
+			}
+			else
+			{
+				m_vpu.PrecompileMicroProgram(programStart, programStart + programSize);
+			}
+			m_microProgramChanged = false;
+		}
 	}
 	else
 	{
@@ -1051,6 +1071,39 @@ void CVif::CFifoStream::Advance(uint32 size)
 	}
 }
 
+const uint8* CVif::CFifoStream::GetDirectReadPointer() const
+{
+	if(m_tagIncluded) return nullptr;
+	if(m_bufferPosition == BUFFERSIZE)
+	{
+		return m_source + m_nextAddress;
+	}
+	//Buffer might hold data from a previous transfer
+	if((m_nextAddress - m_startAddress) < 0x10) return nullptr;
+	return m_source + m_nextAddress + m_bufferPosition - 0x10;
+}
+
+void CVif::CFifoStream::AdvanceDirectRead(uint32 size)
+{
+	assert(GetDirectReadPointer() != nullptr);
+	assert(size <= GetAvailableReadBytes());
+	uint32 readAddress = (m_bufferPosition == BUFFERSIZE) ? m_nextAddress : (m_nextAddress + m_bufferPosition - 0x10);
+	readAddress += size;
+	uint32 qwordOffset = (readAddress - m_startAddress) & 0x0F;
+	if(qwordOffset == 0)
+	{
+		m_nextAddress = readAddress;
+		m_bufferPosition = BUFFERSIZE;
+	}
+	else
+	{
+		m_nextAddress = readAddress - qwordOffset + 0x10;
+		assert(m_nextAddress <= m_endAddress);
+		m_buffer = *reinterpret_cast<uint128*>(&m_source[m_nextAddress - 0x10]);
+		m_bufferPosition = qwordOffset;
+	}
+}
+
 uint128 CVif::CFifoStream::GetBuffer() const
 {
 	return m_buffer;
@@ -211,6 +211,10 @@ protected:
 		uint8* GetDirectPointer() const;
 		void Advance(uint32);
 
+		//Byte granular direct access, returns nullptr if buffered data doesn't mirror the source
+		const uint8* GetDirectReadPointer() const;
+		void AdvanceDirectRead(uint32);
+
 		uint128 GetBuffer() const;
 		void SetBuffer(uint128);
 
@@ -521,6 +525,200 @@ protected:
 		return success;
 	}
 
+	template <uint8 dataType>
+	static constexpr uint32 GetUnpackElementSize()
+	{
+		if(dataType == 0x0F) return 2;
+		if((dataType & 0x03) == 0x03) return 0;
+		return ((dataType >> 2) + 1) * (4 >> (dataType & 0x03));
+	}
+
+	template <uint8 dataType, bool usn>
+	static inline void Unpack_DecodeDirect(const uint8* src, uint128& result)
+	{
+		constexpr unsigned int fields = (dataType >> 2) + 1;
+		constexpr unsigned int fieldSize = 4 >> (dataType & 0x03);
+
+		memset(&result, 0, sizeof(result));
+		if constexpr(dataType == 0x0F)
+		{
+			uint16 value = 0;
+			memcpy(&value, src, 2);
+			result.nV0 = ((value >> 0) & 0x1F) << 3;
+			result.nV1 = ((value >> 5) & 0x1F) << 3;
+			result.nV2 = ((value >> 10) & 0x1F) << 3;
+			result.nV3 = ((value >> 15) & 0x01) << 7;
+		}
+		else
+		{
+			uint32 values[fields];
+			for(unsigned int i = 0; i < fields; i++)
+			{
+				if constexpr(fieldSize == 4)
+				{
+					memcpy(&values[i], src + (i * 4), 4);
+				}
+				else if constexpr(fieldSize == 2)
+				{
+					uint16 value = 0;
+					memcpy(&value, src + (i * 2), 2);
+					values[i] = usn ? value : static_cast<int16>(value);
+				}
+				else
+				{
+					uint8 value = src[i];
+					values[i] = usn ? value : static_cast<int8>(value);
+				}
+			}
+
+			if constexpr(fields == 1)
+			{
+				for(unsigned int i = 0; i < 4; i++)
+				{
+					result.nV[i] = values[0];
+				}
+			}
+			else
+			{
+				for(unsigned int i = 0; i < fields; i++)
+				{
+					result.nV[i] = values[i];
+				}
+			}
+		}
+	}
+
+#ifdef FRAMEWORK_SIMD_USE_SSE
+	template <uint8 dataType, bool usn>
+	static inline __m128i Unpack_DecodeDirectSse(const uint8* src)
+	{
+		if constexpr(dataType == 0x0C)
+		{
+			//V4-32
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+		}
+		else if constexpr(dataType == 0x08)
+		{
+			//V3-32
+			uint32 z = 0;
+			memcpy(&z, src + 8, 4);
+			__m128i xy = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+			return _mm_unpacklo_epi64(xy, _mm_cvtsi32_si128(z));
+		}
+		else if constexpr((dataType == 0x0D) || (dataType == 0x05))
+		{
+			//V4-16, V2-16
+			__m128i value;
+			if constexpr(dataType == 0x0D)
+			{
+				value = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+			}
+			else
+			{
+				uint32 xy = 0;
+				memcpy(&xy, src, 4);
+				value = _mm_cvtsi32_si128(xy);
+			}
+			if constexpr(usn)
+			{
+				return _mm_unpacklo_epi16(value, _mm_setzero_si128());
+			}
+			else
+			{
+				return _mm_srai_epi32(_mm_unpacklo_epi16(value, value), 16);
+			}
+		}
+		else if constexpr(dataType == 0x0E)
+		{
+			//V4-8
+			uint32 xyzw = 0;
+			memcpy(&xyzw, src, 4);
+			__m128i value = _mm_cvtsi32_si128(xyzw);
+			if constexpr(usn)
+			{
+				value = _mm_unpacklo_epi8(value, _mm_setzero_si128());
+				return _mm_unpacklo_epi16(value, _mm_setzero_si128());
+			}
+			else
+			{
+				value = _mm_unpacklo_epi8(value, value);
+				value = _mm_unpacklo_epi16(value, value);
+				return _mm_srai_epi32(value, 24);
+			}
+		}
+		else
+		{
+			uint128 result;
+			Unpack_DecodeDirect<dataType, usn>(src, result);
+			return _mm_loadu_si128(reinterpret_cast<const __m128i*>(&result));
+		}
+	}
+#endif
+
+	template <uint8 dataType, bool usn, uint8 mode>
+	inline FRAMEWORK_SAFE_BUFFERS void Unpack_DirectRun(const uint8* src, uint128* dst, uint32 count)
+	{
+		constexpr uint32 elementSize = GetUnpackElementSize<dataType>();
+#ifdef FRAMEWORK_SIMD_USE_SSE
+		const __m128i row = _mm_load_si128(reinterpret_cast<const __m128i*>(m_R));
+		for(uint32 i = 0; i < count; i++)
+		{
+			__m128i value = Unpack_DecodeDirectSse<dataType, usn>(src);
+			if constexpr(mode == MODE_OFFSET)
+			{
+				value = _mm_add_epi32(value, row);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+			src += elementSize;
+		}
+#else
+		for(uint32 i = 0; i < count; i++)
+		{
+			uint128 value;
+			Unpack_DecodeDirect<dataType, usn>(src, value);
+			if constexpr(mode == MODE_OFFSET)
+			{
+				for(unsigned int j = 0; j < 4; j++)
+				{
+					value.nV[j] += m_R[j];
+				}
+			}
+			dst[i] = value;
+			src += elementSize;
+		}
+#endif
+	}
+
+	//Unpacks as many complete values as available in the stream, for cases where
+	//every value read is written to consecutive addresses (no mask, no skipping/filling)
+	template <uint8 dataType, bool usn, uint8 mode>
+	uint32 Unpack_Direct(StreamType& stream, uint8* vuMem, uint32 vuMemSize, uint32 dstAddr, uint32 count)
+	{
+		constexpr uint32 elementSize = GetUnpackElementSize<dataType>();
+		if(elementSize == 0) return 0;
+
+		auto src = stream.GetDirectReadPointer();
+		if(src == nullptr) return 0;
+
+		count = std::min<uint32>(count, stream.GetAvailableReadBytes() / elementSize);
+		uint32 remainCount = count;
+		while(remainCount != 0)
+		{
+			//Split where VU memory wraps around
+			uint32 runCount = std::min<uint32>(remainCount, (vuMemSize - dstAddr) / 0x10);
+			Unpack_DirectRun<dataType, usn, mode>(src, reinterpret_cast<uint128*>(vuMem + dstAddr), runCount);
+			src += runCount * elementSize;
+			dstAddr = (dstAddr + (runCount * 0x10)) & (vuMemSize - 1);
+			remainCount -= runCount;
+		}
+
+		if(count != 0)
+		{
+			stream.AdvanceDirectRead(count * elementSize);
+		}
+		return count;
+	}
+
 	template <uint8 dataType, bool clGreaterEqualWl, bool useMask, uint8 mode, bool usn>
 	void Unpack(StreamType& stream, CODE nCommand, uint32 nDstAddr)
 	{
@@ -559,6 +757,15 @@ protected:
 		assert(nDstAddr < vuMemSize);
 		nDstAddr &= (vuMemSize - 1);
 
+		if(clGreaterEqualWl && !useMask && ((mode == 0) || (mode == MODE_OFFSET)) && (cl == wl) && (m_readTick == m_writeTick))
+		{
+			uint32 processed = Unpack_Direct<dataType, usn, mode>(stream, vuMem, vuMemSize, nDstAddr, currentNum);
+			currentNum -= processed;
+			nDstAddr = (nDstAddr + (processed * 0x10)) & (vuMemSize - 1);
+			m_readTick = (m_readTick + processed) % cl;
+			m_writeTick = m_readTick;
+		}
+
 		while(currentNum != 0)
 		{
 			bool mustWrite = false;
@@ -725,6 +932,7 @@ protected:
 	uint32 m_readTick;
 	uint32 m_writeTick;
 	uint32 m_pendingMicroProgram;
+	bool m_microProgramChanged = false;
 	uint32 m_incomingFifoDelay;
 	int32 m_interruptDelayTicks;
 
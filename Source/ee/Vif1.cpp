@@ -91,10 +91,72 @@ uint32 CVif1::ReceiveDMA(uint32 address, uint32 qwc, uint32 direction, bool tagI
 	}
 	else
 	{
+		if(CanForwardDirectPayload(tagIncluded))
+		{
+			uint32 forwarded = ForwardDirectPayload(address, qwc);
+			if(forwarded == qwc)
+			{
+				//Everything went through, our stream is drained like it would be at the end of ProcessPacket
+				ResumeDelayedMicroProgram();
+				return forwarded;
+			}
+			if(m_CODE.nIMM != 0)
+			{
+				//GIF can't take more for now
+				return forwarded;
+			}
+			//DIRECT is done, process what's left of the transfer normally
+			return forwarded + CVif::ReceiveDMA(address + (forwarded * 0x10), qwc - forwarded, direction, false);
+		}
 		return CVif::ReceiveDMA(address, qwc, direction, tagIncluded);
 	}
 }
 
+bool CVif1::CanForwardDirectPayload(bool tagIncluded) const
+{
+	//Transfer only contains payload for a DIRECT command that was started by a previous transfer
+	return !tagIncluded &&
+	       (m_STAT.nVPS == 1) && (m_STAT.nVEW == 0) &&
+	       ((m_CODE.nCMD == CODE_CMD_DIRECT) || (m_CODE.nCMD == CODE_CMD_DIRECTHL)) &&
+	       (m_CODE.nIMM != 0) &&
+	       (m_directQwordBufferIndex == 0) &&
+	       (m_stream.GetAvailableReadBytes() == 0);
+}
+
+uint32 CVif1::ForwardDirectPayload(uint32 address, uint32 qwc)
+{
+	//Hand the payload to the GIF where it sits in memory instead of going through our stream
+#ifdef PROFILE
+	CProfilerZone profilerZone(m_vifProfilerZone);
+#endif
+
+	const uint8* memory = nullptr;
+	uint32 memorySize = 0;
+	if(address & 0x80000000)
+	{
+		memory = m_spr;
+		memorySize = PS2::EE_SPR_SIZE;
+	}
+	else
+	{
+		memory = m_ram;
+		memorySize = PS2::EE_RAM_SIZE;
+	}
+	address &= (memorySize - 1);
+
+	uint32 size = std::min<uint32>(m_CODE.nIMM, qwc) * 0x10;
+	assert((address + size) <= memorySize);
+
+	uint32 processed = m_gif.ProcessMultiplePackets(memory, memorySize, address, address + size, CGsPacketMetadata(2));
+	assert(processed <= size);
+	assert((processed & 0x0F) == 0);
+
+	m_CODE.nIMM -= (processed / 0x10);
+	m_STAT.nVPS = (m_CODE.nIMM == 0) ? 0 : 1;
+
+	return processed / 0x10;
+}
+
 void CVif1::ExecuteCommand(StreamType& stream, CODE nCommand)
 {
 #ifdef _DEBUG
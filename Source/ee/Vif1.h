@@ -23,6 +23,8 @@ private:
 	void ExecuteCommand(StreamType&, CODE) override;
 
 	void Cmd_DIRECT(StreamType&, CODE);
+	bool CanForwardDirectPayload(bool) const;
+	uint32 ForwardDirectPayload(uint32, uint32);
 	void Cmd_UNPACK(StreamType&, CODE, uint32) override;
 
 	void PrepareMicroProgram() override;
@@ -7,6 +7,7 @@
 #include "../FrameDump.h"
 #include "Vif.h"
 #include "Vif1.h"
+#include "VuExecutor.h"
 #include "GIF.h"
 
 #define LOG_NAME ("ee_vpu")
@@ -225,6 +226,11 @@ void CVpu::InvalidateMicroProgram(uint32 start, uint32 end)
 	m_ctx->m_executor->ClearActiveBlocksInRange(start, end, false);
 }
 
+void CVpu::PrecompileMicroProgram(uint32 start, uint32 end)
+{
+	static_cast<CVuExecutor*>(m_ctx->m_executor.get())->PrecompileMicroProgram(start, end);
+}
+
 void CVpu::ProcessXgKick(uint32 address)
 {
 	address &= 0x3FF;
@@ -1,7 +1,9 @@
+#include <algorithm>
 #include "VuAnalysis.h"
 #include "../MIPS.h"
 #include "../Ps2Const.h"
 #include "VUShared.h"
+#include "MA_VU.h"
 
 void CVuAnalysis::Analyse(CMIPS* ctx, uint32 begin, uint32 end)
 {
@@ -115,3 +117,169 @@ void CVuAnalysis::Analyse(CMIPS* ctx, uint32 begin, uint32 end)
 		}
 	}
 }
+
+bool CVuAnalysis::IsMacFlagsLiveOnEntry(CMIPS* ctx, uint32 address, uint32 maxAddress, AddressRangeList* readRanges)
+{
+	//Walks every path leaving 'address'. On a given path, incoming MAC flags are dead once an instruction
+	//writing the MAC flags has gone through the flag pipeline: every read after that sees the newer result.
+	//Timings don't account for stalls, which only delay reads and thus keep this conservative.
+	static const uint32 NO_WRITE = ~0U;
+
+	auto arch = static_cast<CMA_VU*>(ctx->m_pArch);
+
+	//Returns true if the pair reads incoming MAC flags, updates the number of pairs left before our own result is visible
+	auto processPair =
+	    [&](uint32 pairAddress, uint32& writeLatency) {
+		    if(readRanges)
+		    {
+			    readRanges->push_back(std::make_pair(pairAddress, pairAddress + 7));
+		    }
+		    uint32 opcodeLo = ctx->m_pMemoryMap->GetInstruction(pairAddress + 0);
+		    uint32 opcodeHi = ctx->m_pMemoryMap->GetInstruction(pairAddress + 4);
+		    auto loOps = arch->GetAffectedOperands(ctx, pairAddress + 0, opcodeLo);
+		    auto hiOps = arch->GetAffectedOperands(ctx, pairAddress + 4, opcodeHi);
+		    if(loOps.readMACflags)
+		    {
+			    assert(writeLatency != 0);
+			    return true;
+		    }
+		    if(hiOps.writeMACflags && (writeLatency == NO_WRITE))
+		    {
+			    writeLatency = VUShared::LATENCY_MAC;
+		    }
+		    if(writeLatency != NO_WRITE)
+		    {
+			    writeLatency--;
+		    }
+		    return false;
+	    };
+
+	auto isBranch =
+	    [&](uint32 pairAddress) {
+		    uint32 opcodeLo = ctx->m_pMemoryMap->GetInstruction(pairAddress + 0);
+		    uint32 opcodeHi = ctx->m_pMemoryMap->GetInstruction(pairAddress + 4);
+		    if(opcodeHi & VUShared::VU_UPPEROP_BIT_I) return false;
+		    return arch->IsInstructionBranch(ctx, pairAddress, opcodeLo) == MIPS_BRANCH_NORMAL;
+	    };
+
+	std::vector<std::pair<uint32, uint32>> pendingPaths = {std::make_pair(address & ~0x07, NO_WRITE)};
+	std::set<std::pair<uint32, uint32>> visitedStates;
+	uint32 stepCount = 0;
+	while(!pendingPaths.empty())
+	{
+		auto [pairAddress, writeLatency] = pendingPaths.back();
+		pendingPaths.pop_back();
+
+		while(true)
+		{
+			if(writeLatency == 0) break;
+			if(pairAddress >= maxAddress) return true;
+			if(!visitedStates.insert(std::make_pair(pairAddress, writeLatency)).second) break;
+			if(++stepCount > MACFLAGS_LIVENESS_MAX_STEPS) return true;
+
+			uint32 opcodeLo = ctx->m_pMemoryMap->GetInstruction(pairAddress + 0);
+			uint32 opcodeHi = ctx->m_pMemoryMap->GetInstruction(pairAddress + 4);
+
+			if(processPair(pairAddress, writeLatency)) return true;
+
+			if(opcodeHi & (VUShared::VU_UPPEROP_BIT_D | VUShared::VU_UPPEROP_BIT_T))
+			{
+				//Execution stops, flags can be read by the EE
+				if(writeLatency == NO_WRITE) return true;
+				break;
+			}
+
+			bool endsProgram = (opcodeHi & VUShared::VU_UPPEROP_BIT_E) != 0;
+			if(isBranch(pairAddress) || endsProgram)
+			{
+				//Execute delay slot
+				uint32 delaySlotAddress = pairAddress + 8;
+				if(delaySlotAddress >= maxAddress) return true;
+				if(writeLatency == 0) break;
+				if(isBranch(delaySlotAddress)) return true;
+				if(processPair(delaySlotAddress, writeLatency)) return true;
+
+				if(endsProgram)
+				{
+					//Pipeline is flushed when the microprogram ends, the EE will see our last result
+					if(writeLatency == NO_WRITE) return true;
+					break;
+				}
+
+				uint32 lowerOp = opcodeLo >> 25;
+				if((lowerOp == LOWEROP_JR) || (lowerOp == LOWEROP_JALR)) return true;
+				uint32 branchTarget = arch->GetInstructionEffectiveAddress(ctx, pairAddress, opcodeLo);
+				if(branchTarget == MIPS_INVALID_PC) return true;
+				pendingPaths.push_back(std::make_pair(branchTarget & (maxAddress - 1), writeLatency));
+				if(lowerOp != LOWEROP_B)
+				{
+					pendingPaths.push_back(std::make_pair(pairAddress + 0x10, writeLatency));
+				}
+				break;
+			}
+
+			pairAddress += 8;
+		}
+	}
+
+	if(readRanges)
+	{
+		MergeAddressRanges(*readRanges);
+	}
+	return false;
+}
+
+bool CVuAnalysis::IsMacFlagsLiveOnExit(CMIPS* ctx, uint32 begin, uint32 end, uint32 maxAddress, AddressRangeList* readRanges)
+{
+	//Find out where control goes after a block partitioned by CVuExecutor
+	auto arch = static_cast<CMA_VU*>(ctx->m_pArch);
+	assert((begin & 0x07) == 0);
+	assert(((end + 4) & 0x07) == 0);
+
+	uint32 lastPairAddress = end - 4;
+	uint32 lastOpcodeLo = ctx->m_pMemoryMap->GetInstruction(lastPairAddress + 0);
+	uint32 lastOpcodeHi = ctx->m_pMemoryMap->GetInstruction(lastPairAddress + 4);
+	if(lastOpcodeHi & (VUShared::VU_UPPEROP_BIT_D | VUShared::VU_UPPEROP_BIT_T)) return true;
+	if(!(lastOpcodeHi & VUShared::VU_UPPEROP_BIT_I) && (arch->IsInstructionBranch(ctx, lastPairAddress, lastOpcodeLo) == MIPS_BRANCH_NORMAL))
+	{
+		//Branch in delay slot, don't bother
+		return true;
+	}
+
+	if(lastPairAddress >= (begin + 8))
+	{
+		uint32 branchPairAddress = lastPairAddress - 8;
+		uint32 branchOpcodeLo = ctx->m_pMemoryMap->GetInstruction(branchPairAddress + 0);
+		uint32 branchOpcodeHi = ctx->m_pMemoryMap->GetInstruction(branchPairAddress + 4);
+		if(branchOpcodeHi & VUShared::VU_UPPEROP_BIT_E) return true;
+		if(!(branchOpcodeHi & VUShared::VU_UPPEROP_BIT_I) && (arch->IsInstructionBranch(ctx, branchPairAddress, branchOpcodeLo) == MIPS_BRANCH_NORMAL))
+		{
+			uint32 lowerOp = branchOpcodeLo >> 25;
+			if((lowerOp == LOWEROP_JR) || (lowerOp == LOWEROP_JALR)) return true;
+			uint32 branchTarget = arch->GetInstructionEffectiveAddress(ctx, branchPairAddress, branchOpcodeLo);
+			if(branchTarget == MIPS_INVALID_PC) return true;
+			if(IsMacFlagsLiveOnEntry(ctx, branchTarget & (maxAddress - 1), maxAddress, readRanges)) return true;
+			if(lowerOp == LOWEROP_B) return false;
+		}
+	}
+
+	return IsMacFlagsLiveOnEntry(ctx, end + 4, maxAddress, readRanges);
+}
+
+void CVuAnalysis::MergeAddressRanges(AddressRangeList& ranges)
+{
+	std::sort(std::begin(ranges), std::end(ranges));
+	AddressRangeList mergedRanges;
+	for(const auto& range : ranges)
+	{
+		if(!mergedRanges.empty() && (range.first <= (mergedRanges.back().second + 1)))
+		{
+			mergedRanges.back().second = std::max(mergedRanges.back().second, range.second);
+		}
+		else
+		{
+			mergedRanges.push_back(range);
+		}
+	}
+	ranges = std::move(mergedRanges);
+}
@@ -9,8 +9,30 @@ class CMIPS;
 class CVuAnalysis
 {
 public:
+	//Inclusive byte ranges of micro memory
+	typedef std::vector<std::pair<uint32, uint32>> AddressRangeList;
+
 	static void Analyse(CMIPS*, uint32, uint32);
 
+	//Checks if MAC flags produced before reaching an address or leaving a block can still be observed,
+	//either by a flag reading instruction or from outside once the microprogram ends.
+	//Ranges of code that were looked at to conclude that flags are dead are added to the optional list.
+	static bool IsMacFlagsLiveOnEntry(CMIPS*, uint32, uint32, AddressRangeList* = nullptr);
+	static bool IsMacFlagsLiveOnExit(CMIPS*, uint32, uint32, uint32, AddressRangeList* = nullptr);
+
 private:
+	enum
+	{
+		MACFLAGS_LIVENESS_MAX_STEPS = 0x400,
+	};
+
+	enum LOWEROP
+	{
+		LOWEROP_B = 0x20,
+		LOWEROP_JR = 0x24,
+		LOWEROP_JALR = 0x25,
+	};
+
 	static uint32 FindBlockStart(CMIPS*, uint32);
+	static void MergeAddressRanges(AddressRangeList&);
 };
@@ -14,6 +14,16 @@ bool CVuBasicBlock::IsLinkable() const
 	return m_isLinkable;
 }
 
+void CVuBasicBlock::CopyLinkabilityFrom(const CVuBasicBlock& other)
+{
+	m_isLinkable = other.m_isLinkable;
+}
+
+void CVuBasicBlock::SetMacFlagsLiveOnExit(bool macFlagsLiveOnExit)
+{
+	m_macFlagsLiveOnExit = macFlagsLiveOnExit;
+}
+
 void CVuBasicBlock::CompileRange(CMipsJitter* jitter)
 {
 	CompileProlog(jitter);
@@ -630,13 +640,16 @@ void CVuBasicBlock::ComputeSkipFlagsHints(const std::vector<uint32>& fmacStallDe
 		relativePipeTime++;
 	}
 
-	//Simulate usage from outside our block
-	for(uint32 relativePipeTime = maxPipeTime; relativePipeTime < extendedMaxPipeTime; relativePipeTime++)
+	//Simulate usage from outside our block, unless successors are known to overwrite flags before reading them
+	if(m_macFlagsLiveOnExit)
 	{
-		uint32 pipeTimeForResult = flagsResults[relativePipeTime];
-		if(pipeTimeForResult != g_undefinedMACflagsResult)
+		for(uint32 relativePipeTime = maxPipeTime; relativePipeTime < extendedMaxPipeTime; relativePipeTime++)
 		{
-			resultUsed[pipeTimeForResult] = true;
+			uint32 pipeTimeForResult = flagsResults[relativePipeTime];
+			if(pipeTimeForResult != g_undefinedMACflagsResult)
+			{
+				resultUsed[pipeTimeForResult] = true;
+			}
 		}
 	}
 
@@ -9,6 +9,10 @@ public:
 	virtual ~CVuBasicBlock() = default;
 
 	bool IsLinkable() const;
+	void CopyLinkabilityFrom(const CVuBasicBlock&);
+
+	//Set to false when successors are known not to observe MAC flags produced by this block
+	void SetMacFlagsLiveOnExit(bool);
 
 protected:
 	void CompileRange(CMipsJitter*) override;
@@ -45,4 +49,5 @@ private:
 	static void EmitXgKick(CMipsJitter*);
 
 	bool m_isLinkable = true;
+	bool m_macFlagsLiveOnExit = true;
 };
@@ -1,6 +1,8 @@
 #include "VuExecutor.h"
 #include "VuBasicBlock.h"
+#include "VuAnalysis.h"
 #include "VUShared.h"
+#include "MA_VU.h"
 #include "xxhash.h"
 
 // clang-format off
@@ -16,19 +18,105 @@ CVuExecutor::CVuExecutor(CMIPS& context, uint32 maxAddress)
 {
 }
 
+CVuExecutor::~CVuExecutor()
+{
+	{
+		std::unique_lock lock(m_precompileMutex);
+		m_precompileThreadDone = true;
+	}
+	m_precompileCondition.notify_all();
+	if(m_precompileThread.joinable())
+	{
+		m_precompileThread.join();
+	}
+}
+
 void CVuExecutor::Reset()
 {
+	{
+		std::unique_lock lock(m_precompileMutex);
+		m_precompileJobs.clear();
+		m_precompiledBlocks.clear();
+		m_precompiledKeys.clear();
+	}
 	m_cachedBlocks.clear();
+	m_outsideDependencies.clear();
 	CGenericMipsExecutor::Reset();
 }
 
-BasicBlockPtr CVuExecutor::BlockFactory(CMIPS& context, uint32 begin, uint32 end)
+void CVuExecutor::ClearActiveBlocksInRange(uint32 start, uint32 end, bool executing)
+{
+	CGenericMipsExecutor::ClearActiveBlocksInRange(start, end, executing);
+
+	//Also clear blocks whose MAC flag analysis looked at code in the range.
+	//Compiled code stays in the block cache, its key includes the analysis result.
+	for(auto dependencyIterator = std::begin(m_outsideDependencies); dependencyIterator != std::end(m_outsideDependencies);)
+	{
+		uint32 blockBegin = dependencyIterator->first;
+		const auto& dependency = dependencyIterator->second;
+		bool readsRange = std::any_of(std::begin(dependency.readRanges), std::end(dependency.readRanges),
+		                              [&](const auto& range) { return RangesOverlap(range.first, range.second, start, end); });
+		if(readsRange)
+		{
+			CGenericMipsExecutor::ClearActiveBlocksInRange(blockBegin, dependency.blockEnd, executing);
+		}
+		//Block might have been cleared by either call, it could be the one being executed
+		auto block = FindBlockStartingAt(blockBegin);
+		if(block->IsEmpty() || (block->GetBeginAddress() != blockBegin))
+		{
+			dependencyIterator = m_outsideDependencies.erase(dependencyIterator);
+		}
+		else
+		{
+			dependencyIterator++;
+		}
+	}
+}
+
+void CVuExecutor::PrecompileMicroProgram(uint32 start, uint32 end)
+{
+	assert(start < end);
+	assert(end <= m_maxAddress);
+
+#ifdef __EMSCRIPTEN__
+	//No worker threads on this platform, blocks get compiled when they're first executed
+	return;
+#endif
+
+	auto map = m_context.m_pMemoryMap->GetInstructionMap(0);
+	assert(map != nullptr);
+	assert(((map->nEnd - map->nStart) + 1) == m_maxAddress);
+	auto microMemory = reinterpret_cast<const uint8*>(map->pPointer);
+
+	PRECOMPILE_JOB job;
+	job.microMemory = std::vector<uint8>(microMemory, microMemory + m_maxAddress);
+	job.start = start & ~0x07;
+	job.end = end;
+
+	{
+		std::unique_lock lock(m_precompileMutex);
+		if(m_precompileJobs.size() == MAX_PRECOMPILE_JOB_COUNT)
+		{
+			m_precompileJobs.pop_front();
+		}
+		m_precompileJobs.push_back(std::move(job));
+	}
+	m_precompileCondition.notify_one();
+
+	//Started lazily since the context's architecture isn't set up yet when we're constructed
+	if(!m_precompileThread.joinable())
+	{
+		m_precompileThread = std::thread([this]() { PrecompileThreadProc(); });
+	}
+}
+
+CVuExecutor::CachedBlockKey CVuExecutor::MakeBlockKey(CMIPS& context, uint32 begin, uint32 end, CVuAnalysis::AddressRangeList* readRanges) const
 {
 	uint32 blockSize = ((end - begin) + 4) / 4;
 	uint32 blockSizeByte = blockSize * 4;
 
-	auto map = m_context.m_pMemoryMap->GetInstructionMap(begin);
-	assert(m_context.m_pMemoryMap->GetInstructionMap(end) == map);
+	auto map = context.m_pMemoryMap->GetInstructionMap(begin);
+	assert(context.m_pMemoryMap->GetInstructionMap(end) == map);
 	uint32 localBegin = begin - map->nStart;
 	auto blockMemory = reinterpret_cast<const uint32*>(reinterpret_cast<uint8*>(map->pPointer) + localBegin);
 
@@ -36,62 +124,123 @@ BasicBlockPtr CVuExecutor::BlockFactory(CMIPS& context, uint32 begin, uint32 end
 	uint128 hash;
 	memcpy(&hash, &xxHash, sizeof(xxHash));
 	static_assert(sizeof(hash) == sizeof(xxHash));
-	auto blockKey = std::make_pair(hash, blockSizeByte);
+
+	uint32 blockInfo = blockSizeByte;
+	if(!CVuAnalysis::IsMacFlagsLiveOnExit(&context, begin, end, m_maxAddress, readRanges))
+	{
+		blockInfo |= BLOCKKEY_MACFLAGS_DEAD_ON_EXIT;
+	}
+	return std::make_pair(hash, blockInfo);
+}
+
+uint32 CVuExecutor::GetBlockCompileHints(const CachedBlockKey& blockKey)
+{
+	auto blockCompileHintsIterator = std::find_if(std::begin(g_blockCompileHints), std::end(g_blockCompileHints),
+	                                              [&](const auto& item) {
+		                                              return (item.blockKey.first == blockKey.first) &&
+		                                                     (item.blockKey.second == (blockKey.second & ~BLOCKKEY_MACFLAGS_DEAD_ON_EXIT));
+	                                              });
+	if(blockCompileHintsIterator != std::end(g_blockCompileHints))
+	{
+		return blockCompileHintsIterator->hints;
+	}
+	return 0;
+}
+
+BasicBlockPtr CVuExecutor::FindPrecompiledBlock(const CachedBlockKey& blockKey)
+{
+	std::unique_lock lock(m_precompileMutex);
+	auto blockIterator = m_precompiledBlocks.find(blockKey);
+	if(blockIterator == std::end(m_precompiledBlocks)) return BasicBlockPtr();
+	auto& blocks = blockIterator->second;
+	assert(!blocks.empty());
+	auto result = std::move(blocks.back());
+	blocks.pop_back();
+	if(blocks.empty())
+	{
+		m_precompiledBlocks.erase(blockIterator);
+	}
+	return result;
+}
+
+BasicBlockPtr CVuExecutor::BlockFactory(CMIPS& context, uint32 begin, uint32 end)
+{
+	CVuAnalysis::AddressRangeList readRanges;
+	auto blockKey = MakeBlockKey(m_context, begin, end, &readRanges);
+	if(blockKey.second & BLOCKKEY_MACFLAGS_DEAD_ON_EXIT)
+	{
+		auto& dependency = m_outsideDependencies[begin];
+		dependency.blockEnd = end;
+		dependency.readRanges = std::move(readRanges);
+	}
+	else
+	{
+		m_outsideDependencies.erase(begin);
+	}
 
 	//Don't use the cached blocks of we have a breakpoint in our block range.
 	bool hasBreakpoint = m_context.HasBreakpointInRange(begin, end);
 	if(!hasBreakpoint)
 	{
-		auto beginBlockIterator = m_cachedBlocks.lower_bound(blockKey);
-		auto endBlockIterator = m_cachedBlocks.upper_bound(blockKey);
-		//Check if we have a block that has the same contents and the same range.
-		for(auto blockIterator = beginBlockIterator; blockIterator != endBlockIterator; blockIterator++)
+		auto blockIterator = m_cachedBlocks.find(blockKey);
+		if(blockIterator != std::end(m_cachedBlocks))
 		{
-			const auto& basicBlock(blockIterator->second);
-			if(basicBlock->GetBeginAddress() == begin && basicBlock->GetEndAddress() == end)
+			auto& cachedBlocks = blockIterator->second;
+			//Check if we have a block that has the same contents and the same range.
+			for(const auto& basicBlock : cachedBlocks)
 			{
-				return basicBlock;
+				if(basicBlock->GetBeginAddress() == begin && basicBlock->GetEndAddress() == end)
+				{
+					return basicBlock;
+				}
 			}
+			//Check if we have a block that has the same contents but not the same range. Reuse the code of that block if that's the case.
+			assert(!cachedBlocks.empty());
+			auto result = std::make_shared<CVuBasicBlock>(context, begin, end, m_blockCategory);
+			result->CopyFunctionFrom(cachedBlocks.front());
+			cachedBlocks.push_back(result);
+			return result;
 		}
-		//Check if we have a block that has the same contents but not the same range. Reuse the code of that block if that's the case.
-		if(beginBlockIterator != endBlockIterator)
+
+		//Check if the block was compiled in the background when its microprogram was uploaded.
+		//That block was compiled against a snapshot of micro memory, only its code is reused.
+		if(auto precompiledBlock = FindPrecompiledBlock(blockKey))
 		{
 			auto result = std::make_shared<CVuBasicBlock>(context, begin, end, m_blockCategory);
-			result->CopyFunctionFrom(beginBlockIterator->second);
-			m_cachedBlocks.insert(std::make_pair(blockKey, result));
+			result->CopyFunctionFrom(precompiledBlock);
+			result->CopyLinkabilityFrom(static_cast<const CVuBasicBlock&>(*precompiledBlock));
+			m_cachedBlocks[blockKey].push_back(result);
 			return result;
 		}
 	}
 
 	//Totally new block, build it from scratch
 	auto result = std::make_shared<CVuBasicBlock>(context, begin, end, m_blockCategory);
-
-	auto blockCompileHintsIterator = std::find_if(std::begin(g_blockCompileHints), std::end(g_blockCompileHints),
-	                                              [&](const auto& item) { return item.blockKey == blockKey; });
-	if(blockCompileHintsIterator != std::end(g_blockCompileHints))
+	if(uint32 hints = GetBlockCompileHints(blockKey))
 	{
-		result->AddBlockCompileHints(blockCompileHintsIterator->hints);
+		result->AddBlockCompileHints(hints);
 	}
+	result->SetMacFlagsLiveOnExit((blockKey.second & BLOCKKEY_MACFLAGS_DEAD_ON_EXIT) == 0);
 
 	result->Compile();
 	if(!hasBreakpoint)
 	{
-		m_cachedBlocks.insert(std::make_pair(blockKey, result));
+		m_cachedBlocks[blockKey].push_back(result);
 	}
 	return result;
 }
 
-void CVuExecutor::PartitionFunction(uint32 startAddress)
+uint32 CVuExecutor::FindBlockEnd(CMIPS& context, uint32 startAddress, uint32 maxAddress, uint32& branchAddress)
 {
-	uint32 endAddress = std::min<uint32>(startAddress + MAX_BLOCK_SIZE - 4, m_maxAddress - 4);
-	uint32 branchAddress = MIPS_INVALID_PC;
+	uint32 endAddress = std::min<uint32>(startAddress + MAX_BLOCK_SIZE - 4, maxAddress - 4);
+	branchAddress = MIPS_INVALID_PC;
 	for(uint32 address = startAddress; address < endAddress; address += 8)
 	{
 		uint32 addrLo = address + 0;
 		uint32 addrHi = address + 4;
-		uint32 lowerOp = m_context.m_pMemoryMap->GetInstruction(addrLo);
-		uint32 upperOp = m_context.m_pMemoryMap->GetInstruction(addrHi);
-		auto branchType = m_context.m_pArch->IsInstructionBranch(&m_context, addrLo, lowerOp);
+		uint32 lowerOp = context.m_pMemoryMap->GetInstruction(addrLo);
+		uint32 upperOp = context.m_pMemoryMap->GetInstruction(addrHi);
+		auto branchType = context.m_pArch->IsInstructionBranch(&context, addrLo, lowerOp);
 		if(upperOp & VUShared::VU_UPPEROP_BIT_E)
 		{
 			endAddress = address + 0xC;
@@ -104,7 +253,7 @@ void CVuExecutor::PartitionFunction(uint32 startAddress)
 		}
 		else if(branchType == MIPS_BRANCH_NORMAL)
 		{
-			branchAddress = m_context.m_pArch->GetInstructionEffectiveAddress(&m_context, addrLo, lowerOp);
+			branchAddress = context.m_pArch->GetInstructionEffectiveAddress(&context, addrLo, lowerOp);
 			endAddress = address + 0xC;
 			break;
 		}
@@ -115,6 +264,13 @@ void CVuExecutor::PartitionFunction(uint32 startAddress)
 		}
 	}
 	assert((endAddress - startAddress) <= MAX_BLOCK_SIZE);
+	return endAddress;
+}
+
+void CVuExecutor::PartitionFunction(uint32 startAddress)
+{
+	uint32 branchAddress = MIPS_INVALID_PC;
+	uint32 endAddress = FindBlockEnd(m_context, startAddress, m_maxAddress, branchAddress);
 	CreateBlock(startAddress, endAddress);
 	auto block = static_cast<CVuBasicBlock*>(FindBlockStartingAt(startAddress));
 	if(block->IsLinkable())
@@ -122,3 +278,85 @@ void CVuExecutor::PartitionFunction(uint32 startAddress)
 		SetupBlockLinks(startAddress, endAddress, branchAddress);
 	}
 }
+
+void CVuExecutor::PrecompileThreadProc()
+{
+	//Private context mirroring the VU we're compiling for, but reading instructions from a snapshot
+	std::vector<uint8> microMemory(m_maxAddress);
+	CMA_VU arch(static_cast<CMA_VU*>(m_context.m_pArch)->GetVuMemAddressMask());
+	CMIPS context(MEMORYMAP_ENDIAN_LSBF);
+	context.m_pMemoryMap->InsertInstructionMap(0, m_maxAddress - 1, microMemory.data(), 0);
+	context.m_pArch = &arch;
+	context.m_pAddrTranslator = CMIPS::TranslateAddress64;
+
+	while(true)
+	{
+		PRECOMPILE_JOB job;
+		{
+			std::unique_lock lock(m_precompileMutex);
+			m_precompileCondition.wait(lock, [this]() { return m_precompileThreadDone || !m_precompileJobs.empty(); });
+			if(m_precompileThreadDone) break;
+			job = std::move(m_precompileJobs.front());
+			m_precompileJobs.pop_front();
+		}
+		assert(job.microMemory.size() == microMemory.size());
+		memcpy(microMemory.data(), job.microMemory.data(), microMemory.size());
+		ProcessPrecompileJob(context, job);
+	}
+
+	//Blocks that were never adopted refer to our private context
+	std::unique_lock lock(m_precompileMutex);
+	m_precompiledBlocks.clear();
+}
+
+void CVuExecutor::ProcessPrecompileJob(CMIPS& context, const PRECOMPILE_JOB& job)
+{
+	//Partition the uploaded range the same way PartitionFunction would, following
+	//fallthroughs and branch targets that land inside the range.
+	std::vector<uint32> pendingAddresses = {job.start};
+	std::unordered_set<uint32> visitedAddresses;
+	while(!pendingAddresses.empty())
+	{
+		uint32 startAddress = pendingAddresses.back();
+		pendingAddresses.pop_back();
+		if((startAddress < job.start) || (startAddress >= job.end)) continue;
+		if(!visitedAddresses.insert(startAddress).second) continue;
+
+		uint32 branchAddress = MIPS_INVALID_PC;
+		uint32 endAddress = FindBlockEnd(context, startAddress, m_maxAddress, branchAddress);
+		auto blockKey = MakeBlockKey(context, startAddress, endAddress);
+
+		bool mustCompile = false;
+		{
+			std::unique_lock lock(m_precompileMutex);
+			if(m_precompileThreadDone) return;
+			if(m_precompiledKeys.size() == MAX_PRECOMPILED_BLOCK_COUNT)
+			{
+				//Keys of adopted blocks are also dropped, they might get precompiled again
+				m_precompiledBlocks.clear();
+				m_precompiledKeys.clear();
+			}
+			mustCompile = m_precompiledKeys.insert(blockKey).second;
+		}
+
+		if(mustCompile)
+		{
+			auto block = std::make_shared<CVuBasicBlock>(context, startAddress, endAddress, m_blockCategory);
+			if(uint32 hints = GetBlockCompileHints(blockKey))
+			{
+				block->AddBlockCompileHints(hints);
+			}
+			block->SetMacFlagsLiveOnExit((blockKey.second & BLOCKKEY_MACFLAGS_DEAD_ON_EXIT) == 0);
+			block->Compile();
+
+			std::unique_lock lock(m_precompileMutex);
+			m_precompiledBlocks[blockKey].push_back(std::move(block));
+		}
+
+		pendingAddresses.push_back(endAddress + 4);
+		if(branchAddress != MIPS_INVALID_PC)
+		{
+			pendingAddresses.push_back(branchAddress & m_addressMask);
+		}
+	}
+}
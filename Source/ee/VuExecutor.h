@@ -1,19 +1,58 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "../GenericMipsExecutor.h"
+#include "VuAnalysis.h"
 
 class CVuExecutor : public CGenericMipsExecutor<BlockLookupOneWay, 8>
 {
 public:
 	CVuExecutor(CMIPS&, uint32);
-	virtual ~CVuExecutor() = default;
+	virtual ~CVuExecutor();
 
 	void Reset() override;
+	void ClearActiveBlocksInRange(uint32, uint32, bool) override;
+
+	//Queues compilation of the microprogram uploaded in [start, end[ on a background thread.
+	//Compiled blocks are adopted by BlockFactory when execution reaches them.
+	void PrecompileMicroProgram(uint32, uint32);
 
 protected:
+	//Content hash and size of the block, size also holds analysis results that change the generated code
 	typedef std::pair<uint128, uint32> CachedBlockKey;
-	typedef std::multimap<CachedBlockKey, BasicBlockPtr> CachedBlockMap;
+
+	enum
+	{
+		BLOCKKEY_MACFLAGS_DEAD_ON_EXIT = 0x80000000,
+	};
+
+	enum
+	{
+		//Oldest pending jobs are dropped when uploads outpace the worker
+		MAX_PRECOMPILE_JOB_COUNT = 4,
+		//Precompiled blocks that were never adopted are dropped past this count
+		MAX_PRECOMPILED_BLOCK_COUNT = 0x1000,
+	};
+
+	struct CachedBlockKeyHasher
+	{
+		size_t operator()(const CachedBlockKey& key) const
+		{
+			//Key is already a content hash, no need to mix it again
+			return static_cast<size_t>(key.first.nD0 ^ key.second);
+		}
+	};
+
+	typedef std::vector<BasicBlockPtr> CachedBlockList;
+	typedef std::unordered_map<CachedBlockKey, CachedBlockList, CachedBlockKeyHasher> CachedBlockMap;
+	typedef std::unordered_set<CachedBlockKey, CachedBlockKeyHasher> CachedBlockKeySet;
 
 	struct BLOCK_COMPILE_HINTS
 	{
@@ -21,9 +60,42 @@ protected:
 		uint32 hints;
 	};
 
+	struct OUTSIDE_DEPENDENCY
+	{
+		uint32 blockEnd = 0;
+		CVuAnalysis::AddressRangeList readRanges;
+	};
+	typedef std::map<uint32, OUTSIDE_DEPENDENCY> OutsideDependencyMap;
+
+	struct PRECOMPILE_JOB
+	{
+		std::vector<uint8> microMemory;
+		uint32 start = 0;
+		uint32 end = 0;
+	};
+
 	BasicBlockPtr BlockFactory(CMIPS&, uint32, uint32) override;
 	void PartitionFunction(uint32) override;
 
+	CachedBlockKey MakeBlockKey(CMIPS&, uint32, uint32, CVuAnalysis::AddressRangeList* = nullptr) const;
+	static uint32 GetBlockCompileHints(const CachedBlockKey&);
+	static uint32 FindBlockEnd(CMIPS&, uint32, uint32, uint32&);
+
+	BasicBlockPtr FindPrecompiledBlock(const CachedBlockKey&);
+	void PrecompileThreadProc();
+	void ProcessPrecompileJob(CMIPS&, const PRECOMPILE_JOB&);
+
 	static const BLOCK_COMPILE_HINTS g_blockCompileHints[];
 	CachedBlockMap m_cachedBlocks;
+
+	//Active blocks whose code depends on MAC flag analysis of code outside of their range, by begin address
+	OutsideDependencyMap m_outsideDependencies;
+
+	std::thread m_precompileThread;
+	std::mutex m_precompileMutex;
+	std::condition_variable m_precompileCondition;
+	std::deque<PRECOMPILE_JOB> m_precompileJobs;
+	CachedBlockMap m_precompiledBlocks;
+	CachedBlockKeySet m_precompiledKeys;
+	bool m_precompileThreadDone = false;
 };
@@ -64,6 +64,7 @@ CGSH_OpenGL::CGSH_OpenGL(bool gsThreaded)
 	LoadPreferences();
 
 	m_pCvtBuffer = new uint8[CVTBUFFERSIZE];
+	m_textureConvertWorkers = std::make_unique<CTextureConvertWorkers>();
 
 	memset(&m_renderState, 0, sizeof(m_renderState));
 	m_vertexBuffer.reserve(VERTEX_BUFFER_SIZE);
@@ -106,6 +107,7 @@ void CGSH_OpenGL::ReleaseImpl()
 	m_primVertexArray.Reset();
 	m_vertexParamsBuffer.Reset();
 	m_fragmentParamsBuffer.Reset();
+	ReleaseTextureUploadBuffer();
 }
 
 void CGSH_OpenGL::ResetImpl()
@@ -113,8 +115,7 @@ void CGSH_OpenGL::ResetImpl()
 	LoadPreferences();
 	m_textureCache.Flush();
 	PalCache_Flush();
-	m_framebuffers.clear();
-	m_depthbuffers.clear();
+	ClearFramebuffers();
 	m_vertexBuffer.clear();
 	m_renderState.isValid = false;
 	m_validGlState = 0;
@@ -137,23 +138,21 @@ void CGSH_OpenGL::FlipImpl(const DISPLAY_INFO& dispInfo)
 
 	if(dispLayer.enabled)
 	{
-		for(const auto& candidateFramebuffer : m_framebuffers)
+		uint32 framebufferPosition = SearchBufferIndex(m_framebufferIndex, dispLayer.bufPtr, dispLayer.bufWidth,
+		                                               [&](uint32 position) {
+			                                               const auto& candidateFramebuffer = m_framebuffers[position];
+			                                               return GetFramebufferBitDepth(candidateFramebuffer->m_psm) == GetFramebufferBitDepth(dispLayer.psm);
+		                                               });
+		if(framebufferPosition != BUFFERINDEX_NOTFOUND)
 		{
-			if(
-			    (candidateFramebuffer->m_basePtr == dispLayer.bufPtr) &&
-			    (GetFramebufferBitDepth(candidateFramebuffer->m_psm) == GetFramebufferBitDepth(dispLayer.psm)) &&
-			    (candidateFramebuffer->m_width == dispLayer.bufWidth))
-			{
-				//We have a winner
-				framebuffer = candidateFramebuffer;
-				break;
-			}
+			//We have a winner
+			framebuffer = m_framebuffers[framebufferPosition];
 		}
 
 		if(!framebuffer && (dispLayer.bufWidth != 0))
 		{
 			framebuffer = FramebufferPtr(new CFramebuffer(dispLayer.bufPtr, dispLayer.bufWidth, FRAMEBUFFER_HEIGHT, dispLayer.psm, m_fbScale, m_multisampleEnabled));
-			m_framebuffers.push_back(framebuffer);
+			AddFramebuffer(framebuffer);
 			PopulateFramebuffer(framebuffer);
 		}
 	}
@@ -250,6 +249,7 @@ void CGSH_OpenGL::RegisterPreferences()
 	CGSHandler::RegisterPreferences();
 	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_CGSH_OPENGL_RESOLUTION_FACTOR, 1);
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_CGSH_OPENGL_FORCEBILINEARTEXTURES, false);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_CGSH_OPENGL_TEXTUREDEDUPLICATION, true);
 }
 
 void CGSH_OpenGL::NotifyPreferencesChangedImpl()
@@ -257,8 +257,7 @@ void CGSH_OpenGL::NotifyPreferencesChangedImpl()
 	LoadPreferences();
 	m_textureCache.Flush();
 	PalCache_Flush();
-	m_framebuffers.clear();
-	m_depthbuffers.clear();
+	ClearFramebuffers();
 	CGSHandler::NotifyPreferencesChangedImpl();
 }
 
@@ -266,6 +265,7 @@ void CGSH_OpenGL::LoadPreferences()
 {
 	m_fbScale = CAppConfig::GetInstance().GetPreferenceInteger(PREF_CGSH_OPENGL_RESOLUTION_FACTOR);
 	m_forceBilinearTextures = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_CGSH_OPENGL_FORCEBILINEARTEXTURES);
+	m_textureDeduplicationEnabled = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_CGSH_OPENGL_TEXTUREDEDUPLICATION);
 }
 
 void CGSH_OpenGL::InitializeRC()
@@ -296,6 +296,15 @@ void CGSH_OpenGL::InitializeRC()
 	m_vertexParamsBuffer = GenerateUniformBlockBuffer(sizeof(VERTEXPARAMS));
 	m_fragmentParamsBuffer = GenerateUniformBlockBuffer(sizeof(FRAGMENTPARAMS));
 
+#ifdef USE_TEXTURE_UPLOAD_BUFFER
+	m_textureUploadBuffer = Framework::OpenGl::CBuffer::Create();
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_textureUploadBuffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, TEXTUREUPLOAD_SEGMENT_SIZE * TEXTUREUPLOAD_SEGMENT_COUNT, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+#endif
+	m_textureUploadSegment = 0;
+	m_textureUploadOffset = 0;
+
 	PresentBackbuffer();
 
 	CHECKGLERROR();
@@ -529,12 +538,78 @@ Framework::OpenGl::ProgramPtr CGSH_OpenGL::GetShaderFromCaps(const SHADERCAPS& s
 	return shaderIterator->second;
 }
 
+CGSH_OpenGL::DRAWSTATE_KEY CGSH_OpenGL::GetDrawStateKey(uint64 primReg) const
+{
+	//Reduces register values to the bits that actually have an effect on the
+	//GL state used for drawing, so that games rewriting registers with values that
+	//only differ in ignored fields don't break the current batch.
+
+	static const uint64 primMask = 0x0000000000000270ULL;     //TME, FGE, ABE, CTXT
+	static const uint64 alphaMask = 0x000000FF000000FFULL;    //A, B, C, D, FIX
+	static const uint64 tex0ClutMask = 0x1FFFFFE000000000ULL; //CBP, CPSM, CSM, CSA
+	static const uint64 tex0CldMask = 0xE000000000000000ULL;  //CLD
+
+	auto prim = make_convertible<PRMODE>(primReg);
+	unsigned int context = prim.nContext;
+
+	DRAWSTATE_KEY key = {};
+	key.primReg = primReg & primMask;
+	key.frameReg = m_nReg[GS_REG_FRAME_1 + context];
+	key.testReg = m_nReg[GS_REG_TEST_1 + context];
+	key.zbufReg = m_nReg[GS_REG_ZBUF_1 + context];
+	key.scissorReg = m_nReg[GS_REG_SCISSOR_1 + context];
+
+	if(prim.nAlpha)
+	{
+		key.alphaReg = m_nReg[GS_REG_ALPHA_1 + context] & alphaMask;
+	}
+
+	if(prim.nTexture)
+	{
+		auto tex0 = make_convertible<TEX0>(m_nReg[GS_REG_TEX0_1 + context]);
+		//CLUT loads are handled through ProcessClutTransfer which invalidates texture state
+		uint64 tex0Mask = ~tex0CldMask;
+		if(!CGsPixelFormats::IsPsmIDTEX(tex0.nPsm))
+		{
+			tex0Mask &= ~tex0ClutMask;
+		}
+		key.tex0Reg = static_cast<uint64>(tex0) & tex0Mask;
+		key.tex1Reg = m_nReg[GS_REG_TEX1_1 + context];
+		key.texAReg = m_nReg[GS_REG_TEXA];
+		key.clampReg = m_nReg[GS_REG_CLAMP_1 + context];
+	}
+
+	if(prim.nFog)
+	{
+		key.fogColReg = m_nReg[GS_REG_FOGCOL];
+	}
+
+	return key;
+}
+
+bool CGSH_OpenGL::IsDrawStateCurrent(const DRAWSTATE_KEY& key) const
+{
+	return m_renderState.isValid && m_renderState.isTextureStateValid && m_renderState.isFramebufferStateValid &&
+	       (memcmp(&m_renderState.drawStateKey, &key, sizeof(DRAWSTATE_KEY)) == 0);
+}
+
 void CGSH_OpenGL::SetRenderingContext(uint64 primReg)
 {
 	auto prim = make_convertible<PRMODE>(primReg);
 
 	unsigned int context = prim.nContext;
 
+	auto offset = make_convertible<XYOFFSET>(m_nReg[GS_REG_XYOFFSET_1 + context]);
+	m_nPrimOfsX = offset.GetX();
+	m_nPrimOfsY = offset.GetY();
+
+	auto key = GetDrawStateKey(primReg);
+	if(IsDrawStateCurrent(key))
+	{
+		return;
+	}
+
+	//Register values as they are used when applying changes
 	uint64 testReg = m_nReg[GS_REG_TEST_1 + context];
 	uint64 frameReg = m_nReg[GS_REG_FRAME_1 + context];
 	uint64 alphaReg = m_nReg[GS_REG_ALPHA_1 + context];
@@ -551,7 +626,10 @@ void CGSH_OpenGL::SetRenderingContext(uint64 primReg)
 	//--------------------------------------------------------
 
 	auto shaderCaps = make_convertible<SHADERCAPS>(0);
-	FillShaderCapsFromTexture(shaderCaps, tex0Reg, tex1Reg, texAReg, clampReg);
+	if(prim.nTexture)
+	{
+		FillShaderCapsFromTexture(shaderCaps, tex0Reg, tex1Reg, texAReg, clampReg);
+	}
 	FillShaderCapsFromTest(shaderCaps, testReg);
 	FillShaderCapsFromAlpha(shaderCaps, prim.nAlpha != 0, alphaReg);
 
@@ -560,65 +638,41 @@ void CGSH_OpenGL::SetRenderingContext(uint64 primReg)
 		shaderCaps.hasFog = 1;
 	}
 
-	if(!prim.nTexture)
-	{
-		shaderCaps.texSourceMode = TEXTURE_SOURCE_MODE_NONE;
-	}
-
 	//--------------------------------------------------------
-	// Fast path: if everything (shader caps + relevant regs) matches, skip.
+	//Determine which effective states changed
 	//--------------------------------------------------------
-	if(m_renderState.isValid)
-	{
-		if(m_renderState.isTextureStateValid && m_renderState.isFramebufferStateValid &&
-		   (static_cast<uint32>(m_renderState.shaderCaps) == static_cast<uint32>(shaderCaps)) &&
-		   (m_renderState.primReg == primReg) &&
-		   (m_renderState.alphaReg == alphaReg) &&
-		   (m_renderState.testReg == testReg) &&
-		   (m_renderState.zbufReg == zbufReg) &&
-		   (m_renderState.frameReg == frameReg) &&
-		   (m_renderState.scissorReg == scissorReg) &&
-		   (m_renderState.tex0Reg == tex0Reg) &&
-		   (m_renderState.tex1Reg == tex1Reg) &&
-		   (m_renderState.texAReg == texAReg) &&
-		   (m_renderState.clampReg == clampReg) &&
-		   (m_renderState.fogColReg == fogColReg))
-		{
-			// Nothing changed.
-			auto offsetFast = make_convertible<XYOFFSET>(m_nReg[GS_REG_XYOFFSET_1 + context]);
-			m_nPrimOfsX = offsetFast.GetX();
-			m_nPrimOfsY = offsetFast.GetY();
-			return;
-		}
-	}
 
-	//--------------------------------------------------------
-	// Determine which states changed; perform a single flush before modifying any.
-	//--------------------------------------------------------
-	uint64 prevPrimValue = m_renderState.isValid ? m_renderState.primReg : 0;
-	auto prevPrim = make_convertible<PRMODE>(prevPrimValue);
-	bool shaderChanged = !m_renderState.isValid || (static_cast<uint32>(m_renderState.shaderCaps) != static_cast<uint32>(shaderCaps));
-	bool primChanged = !m_renderState.isValid || (m_renderState.primReg != primReg);
-	bool blendEnableChanged = primChanged && !m_hasFramebufferFetchExtension && ((!m_renderState.isValid) || (prevPrim.nAlpha != prim.nAlpha));
-	bool alphaChanged = !m_renderState.isValid || (m_renderState.alphaReg != alphaReg);
-	bool testChanged = !m_renderState.isValid || (m_renderState.testReg != testReg);
-	bool zbufChanged = !m_renderState.isValid || (m_renderState.zbufReg != zbufReg);
-	bool framebufferRelatedChanged = !m_renderState.isValid || !m_renderState.isFramebufferStateValid ||
-	                                 (m_renderState.frameReg != frameReg) || zbufChanged || (m_renderState.scissorReg != scissorReg) || testChanged;
-	bool textureEnableChanged = !m_renderState.isValid || (prevPrim.nTexture != prim.nTexture);
-	bool textureChanged = !m_renderState.isValid || !m_renderState.isTextureStateValid ||
-	                      (m_renderState.tex0Reg != tex0Reg) || (m_renderState.tex1Reg != tex1Reg) || (m_renderState.texAReg != texAReg) ||
-	                      (m_renderState.clampReg != clampReg) || textureEnableChanged;
-	bool fogColorChanged = !m_renderState.isValid || (m_renderState.fogColReg != fogColReg);
-
-	bool needFlush = shaderChanged || primChanged || alphaChanged || testChanged || zbufChanged || framebufferRelatedChanged || textureChanged || fogColorChanged;
-	if(needFlush)
-	{
-		FlushVertexBuffer();
+	const auto& prevKey = m_renderState.drawStateKey;
+	auto prevPrim = make_convertible<PRMODE>(m_renderState.isValid ? prevKey.primReg : 0);
+	bool isValid = m_renderState.isValid;
+	bool shaderChanged = !isValid || (static_cast<ShaderCapsInt>(m_renderState.shaderCaps) != static_cast<ShaderCapsInt>(shaderCaps));
+	bool alphaEnableChanged = !isValid || (prevPrim.nAlpha != prim.nAlpha);
+	bool blendEnableChanged = alphaEnableChanged && !m_hasFramebufferFetchExtension;
+	bool alphaChanged = prim.nAlpha && (alphaEnableChanged || (prevKey.alphaReg != key.alphaReg));
+	bool testChanged = !isValid || (prevKey.testReg != key.testReg);
+	bool zbufChanged = !isValid || (prevKey.zbufReg != key.zbufReg);
+	bool framebufferRelatedChanged = !isValid || !m_renderState.isFramebufferStateValid ||
+	                                 (prevKey.frameReg != key.frameReg) || zbufChanged || (prevKey.scissorReg != key.scissorReg) || testChanged;
+	bool textureEnableChanged = !isValid || (prevPrim.nTexture != prim.nTexture);
+	bool textureChanged = !isValid || !m_renderState.isTextureStateValid ||
+	                      (prevKey.tex0Reg != key.tex0Reg) || (prevKey.tex1Reg != key.tex1Reg) || (prevKey.texAReg != key.texAReg) ||
+	                      (prevKey.clampReg != key.clampReg) || textureEnableChanged;
+	bool fogColorChanged = prim.nFog && (!isValid || (prevPrim.nFog != prim.nFog) || (prevKey.fogColReg != key.fogColReg));
+
+	bool needFlush = shaderChanged || blendEnableChanged || alphaChanged || testChanged || zbufChanged ||
+	                 framebufferRelatedChanged || textureChanged || fogColorChanged;
+	if(!needFlush)
+	{
+		//Only ignored fields changed, keep batching
+		m_renderState.drawStateKey = key;
+		return;
 	}
 
+	FlushVertexBuffer();
+	m_stateChangeCount++;
+
 	//--------------------------------------------------------
-	// Apply state changes (order kept similar to original when relevant)
+	//Apply state changes
 	//--------------------------------------------------------
 	if(shaderChanged)
 	{
@@ -627,11 +681,8 @@ void CGSH_OpenGL::SetRenderingContext(uint64 primReg)
 
 	if(blendEnableChanged)
 	{
-		if(!m_hasFramebufferFetchExtension)
-		{
-			m_renderState.blendEnabled = ((prim.nAlpha != 0) && m_alphaBlendingEnabled) ? GL_TRUE : GL_FALSE;
-			m_validGlState &= ~GLSTATE_BLEND;
-		}
+		m_renderState.blendEnabled = ((prim.nAlpha != 0) && m_alphaBlendingEnabled) ? GL_TRUE : GL_FALSE;
+		m_validGlState &= ~GLSTATE_BLEND;
 	}
 
 	if(alphaChanged)
@@ -670,26 +721,12 @@ void CGSH_OpenGL::SetRenderingContext(uint64 primReg)
 		CHECKGLERROR();
 	}
 
-	auto offset = make_convertible<XYOFFSET>(m_nReg[GS_REG_XYOFFSET_1 + context]);
-	m_nPrimOfsX = offset.GetX();
-	m_nPrimOfsY = offset.GetY();
-
 	CHECKGLERROR();
 
 	m_renderState.isValid = true;
 	m_renderState.isTextureStateValid = true;
 	m_renderState.isFramebufferStateValid = true;
-	m_renderState.primReg = primReg;
-	m_renderState.alphaReg = alphaReg;
-	m_renderState.testReg = testReg;
-	m_renderState.zbufReg = zbufReg;
-	m_renderState.scissorReg = scissorReg;
-	m_renderState.frameReg = frameReg;
-	m_renderState.tex0Reg = tex0Reg;
-	m_renderState.tex1Reg = tex1Reg;
-	m_renderState.texAReg = texAReg;
-	m_renderState.clampReg = clampReg;
-	m_renderState.fogColReg = fogColReg;
+	m_renderState.drawStateKey = key;
 }
 
 void CGSH_OpenGL::SetupBlendingFunction(uint64 alphaReg)
@@ -1009,7 +1046,7 @@ void CGSH_OpenGL::SetupFramebuffer(uint64 frameReg, uint64 zbufReg, uint64 sciss
 	if(!framebuffer)
 	{
 		framebuffer = FramebufferPtr(new CFramebuffer(frame.GetBasePtr(), frame.GetWidth(), FRAMEBUFFER_HEIGHT, frame.nPsm, m_fbScale, m_multisampleEnabled));
-		m_framebuffers.push_back(framebuffer);
+		AddFramebuffer(framebuffer);
 		PopulateFramebuffer(framebuffer);
 	}
 
@@ -1019,7 +1056,7 @@ void CGSH_OpenGL::SetupFramebuffer(uint64 frameReg, uint64 zbufReg, uint64 sciss
 	if(!depthbuffer)
 	{
 		depthbuffer = DepthbufferPtr(new CDepthbuffer(zbuf.GetBasePtr(), frame.GetWidth(), FRAMEBUFFER_HEIGHT, zbuf.nPsm, m_fbScale, m_multisampleEnabled));
-		m_depthbuffers.push_back(depthbuffer);
+		AddDepthbuffer(depthbuffer);
 	}
 
 	assert(framebuffer->m_width == depthbuffer->m_width);
@@ -1365,24 +1402,42 @@ void CGSH_OpenGL::SetupTexture(uint64 primReg, uint64 tex0Reg, uint64 tex1Reg, u
 
 CGSH_OpenGL::FramebufferPtr CGSH_OpenGL::FindFramebuffer(const FRAME& frame) const
 {
-	auto framebufferIterator = std::find_if(std::begin(m_framebuffers), std::end(m_framebuffers),
-	                                        [&](const FramebufferPtr& framebuffer) {
-		                                        return (framebuffer->m_basePtr == frame.GetBasePtr()) &&
-		                                               IsCompatibleFramebufferPSM(framebuffer->m_psm, frame.nPsm) &&
-		                                               (framebuffer->m_width == frame.GetWidth());
-	                                        });
+	uint32 framebufferPosition = SearchBufferIndex(m_framebufferIndex, frame.GetBasePtr(), frame.GetWidth(),
+	                                               [&](uint32 position) {
+		                                               return IsCompatibleFramebufferPSM(m_framebuffers[position]->m_psm, frame.nPsm);
+	                                               });
 
-	return (framebufferIterator != std::end(m_framebuffers)) ? *(framebufferIterator) : FramebufferPtr();
+	return (framebufferPosition != BUFFERINDEX_NOTFOUND) ? m_framebuffers[framebufferPosition] : FramebufferPtr();
 }
 
 CGSH_OpenGL::DepthbufferPtr CGSH_OpenGL::FindDepthbuffer(const ZBUF& zbuf, const FRAME& frame) const
 {
-	auto depthbufferIterator = std::find_if(std::begin(m_depthbuffers), std::end(m_depthbuffers),
-	                                        [&](const DepthbufferPtr& depthbuffer) {
-		                                        return (depthbuffer->m_basePtr == zbuf.GetBasePtr()) && (depthbuffer->m_width == frame.GetWidth());
-	                                        });
+	uint32 depthbufferPosition = SearchBufferIndex(m_depthbufferIndex, zbuf.GetBasePtr(), frame.GetWidth(),
+	                                               [](uint32) { return true; });
+
+	return (depthbufferPosition != BUFFERINDEX_NOTFOUND) ? m_depthbuffers[depthbufferPosition] : DepthbufferPtr();
+}
+
+void CGSH_OpenGL::AddFramebuffer(const FramebufferPtr& framebuffer)
+{
+	auto& positions = m_framebufferIndex[MakeBufferIndexKey(framebuffer->m_basePtr, framebuffer->m_width)];
+	positions.push_back(static_cast<uint32>(m_framebuffers.size()));
+	m_framebuffers.push_back(framebuffer);
+}
+
+void CGSH_OpenGL::AddDepthbuffer(const DepthbufferPtr& depthbuffer)
+{
+	auto& positions = m_depthbufferIndex[MakeBufferIndexKey(depthbuffer->m_basePtr, depthbuffer->m_width)];
+	positions.push_back(static_cast<uint32>(m_depthbuffers.size()));
+	m_depthbuffers.push_back(depthbuffer);
+}
 
-	return (depthbufferIterator != std::end(m_depthbuffers)) ? *(depthbufferIterator) : DepthbufferPtr();
+void CGSH_OpenGL::ClearFramebuffers()
+{
+	m_framebuffers.clear();
+	m_depthbuffers.clear();
+	m_framebufferIndex.clear();
+	m_depthbufferIndex.clear();
 }
 
 /////////////////////////////////////////////////////////////
@@ -1701,6 +1756,7 @@ void CGSH_OpenGL::Prim_Sprite()
 void CGSH_OpenGL::FlushVertexBuffer()
 {
 	if(m_vertexBuffer.empty()) return;
+	m_flushCount++;
 
 	assert(m_renderState.isValid == true);
 
@@ -2017,39 +2073,7 @@ void CGSH_OpenGL::VertexKick(uint8 nRegister, uint64 nValue)
 
 		if(nDrawingKick)
 		{
-			// Fast skip if nothing relevant changed since last draw
-			bool needCtx = true;
-			if(m_renderState.isValid && m_renderState.isTextureStateValid && m_renderState.isFramebufferStateValid)
-			{
-				uint64 primReg = m_PrimitiveMode;
-				auto primLocal = make_convertible<PRMODE>(primReg);
-				unsigned ctx = primLocal.nContext;
-				uint64 testReg = m_nReg[GS_REG_TEST_1 + ctx];
-				uint64 frameReg = m_nReg[GS_REG_FRAME_1 + ctx];
-				uint64 alphaReg = m_nReg[GS_REG_ALPHA_1 + ctx];
-				uint64 zbufReg = m_nReg[GS_REG_ZBUF_1 + ctx];
-				uint64 tex0Reg = m_nReg[GS_REG_TEX0_1 + ctx];
-				uint64 tex1Reg = m_nReg[GS_REG_TEX1_1 + ctx];
-				uint64 texAReg = m_nReg[GS_REG_TEXA];
-				uint64 clampReg = m_nReg[GS_REG_CLAMP_1 + ctx];
-				uint64 fogColReg = m_nReg[GS_REG_FOGCOL];
-				uint64 scissorReg = m_nReg[GS_REG_SCISSOR_1 + ctx];
-				if(m_renderState.primReg == primReg &&
-				   m_renderState.testReg == testReg &&
-				   m_renderState.frameReg == frameReg &&
-				   m_renderState.alphaReg == alphaReg &&
-				   m_renderState.zbufReg == zbufReg &&
-				   m_renderState.tex0Reg == tex0Reg &&
-				   m_renderState.tex1Reg == tex1Reg &&
-				   m_renderState.texAReg == texAReg &&
-				   m_renderState.clampReg == clampReg &&
-				   m_renderState.fogColReg == fogColReg &&
-				   m_renderState.scissorReg == scissorReg)
-				{
-					needCtx = false; // fully same state; skip call
-				}
-			}
-			if(needCtx) SetRenderingContext(m_PrimitiveMode);
+			SetRenderingContext(m_PrimitiveMode);
 		}
 
 		switch(m_primitiveType)
@@ -2171,27 +2195,20 @@ void CGSH_OpenGL::ProcessLocalToHostTransfer()
 void CGSH_OpenGL::ProcessLocalToLocalTransfer()
 {
 	auto bltBuf = make_convertible<BITBLTBUF>(m_nReg[GS_REG_BITBLTBUF]);
-	auto srcFramebufferIterator = std::find_if(m_framebuffers.begin(), m_framebuffers.end(),
-	                                           [&](const FramebufferPtr& framebuffer) {
-		                                           return (framebuffer->m_basePtr == bltBuf.GetSrcPtr()) &&
-		                                                  (framebuffer->m_width == bltBuf.GetSrcWidth());
-	                                           });
-	auto dstFramebufferIterator = std::find_if(m_framebuffers.begin(), m_framebuffers.end(),
-	                                           [&](const FramebufferPtr& framebuffer) {
-		                                           return (framebuffer->m_basePtr == bltBuf.GetDstPtr()) &&
-		                                                  (framebuffer->m_width == bltBuf.GetDstWidth());
-	                                           });
-
-	bool foundSrc = srcFramebufferIterator != std::end(m_framebuffers);
-	bool foundDest = dstFramebufferIterator != std::end(m_framebuffers);
+	auto anyFramebuffer = [](uint32) { return true; };
+	uint32 srcFramebufferPosition = SearchBufferIndex(m_framebufferIndex, bltBuf.GetSrcPtr(), bltBuf.GetSrcWidth(), anyFramebuffer);
+	uint32 dstFramebufferPosition = SearchBufferIndex(m_framebufferIndex, bltBuf.GetDstPtr(), bltBuf.GetDstWidth(), anyFramebuffer);
+
+	bool foundSrc = srcFramebufferPosition != BUFFERINDEX_NOTFOUND;
+	bool foundDest = dstFramebufferPosition != BUFFERINDEX_NOTFOUND;
 
 	if(foundSrc && foundDest)
 	{
 		FlushVertexBuffer();
 		m_renderState.isValid = false;
 
-		const auto& srcFramebuffer = (*srcFramebufferIterator);
-		const auto& dstFramebuffer = (*dstFramebufferIterator);
+		const auto& srcFramebuffer = m_framebuffers[srcFramebufferPosition];
+		const auto& dstFramebuffer = m_framebuffers[dstFramebufferPosition];
 
 		glBindFramebuffer(GL_FRAMEBUFFER, dstFramebuffer->m_framebuffer);
 		glBindFramebuffer(GL_READ_FRAMEBUFFER, srcFramebuffer->m_framebuffer);
@@ -2214,7 +2231,7 @@ void CGSH_OpenGL::ProcessLocalToLocalTransfer()
 		auto trxReg = make_convertible<TRXREG>(m_nReg[GS_REG_TRXREG]);
 		auto imgbuffer = Framework::CBitmap(trxReg.nRRW * m_fbScale, trxReg.nRRH * m_fbScale, 32);
 
-		glBindFramebuffer(GL_FRAMEBUFFER, (*srcFramebufferIterator)->m_framebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffers[srcFramebufferPosition]->m_framebuffer);
 		glReadPixels(trxPos.nSSAX * m_fbScale, trxPos.nSSAY * m_fbScale, trxReg.nRRW * m_fbScale, trxReg.nRRH * m_fbScale, GL_RGBA, GL_UNSIGNED_BYTE, imgbuffer.GetPixels());
 		CHECKGLERROR();
 
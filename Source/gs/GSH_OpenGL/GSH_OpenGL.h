@@ -1,6 +1,7 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <unordered_map>
 #include "../GSHandler.h"
 #include "../GsDebuggerInterface.h"
@@ -10,9 +11,11 @@
 #include "opengl/Program.h"
 #include "opengl/Shader.h"
 #include "opengl/Resource.h"
+#include "TextureConvertWorkers.h"
 
 #define PREF_CGSH_OPENGL_RESOLUTION_FACTOR "renderer.opengl.resfactor"
 #define PREF_CGSH_OPENGL_FORCEBILINEARTEXTURES "renderer.opengl.forcebilineartextures"
+#define PREF_CGSH_OPENGL_TEXTUREDEDUPLICATION "renderer.opengl.texturededuplication"
 
 #if !defined(GLES_COMPATIBILITY) && !defined(__APPLE__)
 //- Dual source blending is disabled on macOS because it seems to be problematic on
@@ -20,6 +23,12 @@
 #define USE_DUALSOURCE_BLENDING
 #endif
 
+#if !defined(GLES_COMPATIBILITY) && !defined(__EMSCRIPTEN__)
+//- Texture uploads go through a mapped pixel unpack buffer ring. WebGL has no buffer mapping
+//  and limits client waits, GLES targets upload straight from the conversion buffer.
+#define USE_TEXTURE_UPLOAD_BUFFER
+#endif
+
 class CGSH_OpenGL : public CGSHandler, public CGsDebuggerInterface
 {
 public:
@@ -66,7 +75,8 @@ protected:
 	GLuint m_presentFramebuffer = 0;
 
 private:
-	typedef CGsTextureCache<Framework::OpenGl::CTexture> TextureCache;
+	typedef std::shared_ptr<Framework::OpenGl::CTexture> TexturePtr;
+	typedef CGsTextureCache<TexturePtr> TextureCache;
 	typedef uint64 ShaderCapsInt;
 
 	struct SHADERCAPS : public convertible<ShaderCapsInt>
@@ -105,13 +115,9 @@ private:
 	};
 	static_assert(sizeof(SHADERCAPS) == sizeof(ShaderCapsInt), "SHADERCAPS too big for ShaderCapsInt.");
 
-	struct RENDERSTATE
+	//Register values reduced to the fields that affect drawing
+	struct DRAWSTATE_KEY
 	{
-		bool isValid;
-		bool isTextureStateValid;
-		bool isFramebufferStateValid;
-
-		//Register State
 		uint64 primReg;
 		uint64 frameReg;
 		uint64 testReg;
@@ -123,6 +129,16 @@ private:
 		uint64 texAReg;
 		uint64 clampReg;
 		uint64 fogColReg;
+	};
+
+	struct RENDERSTATE
+	{
+		bool isValid;
+		bool isTextureStateValid;
+		bool isFramebufferStateValid;
+
+		//Register State
+		DRAWSTATE_KEY drawStateKey;
 
 		//Intermediate State
 		SHADERCAPS shaderCaps;
@@ -186,6 +202,19 @@ private:
 		CVTBUFFERSIZE = 0x800000,
 	};
 
+	enum
+	{
+		TEXTUREUPLOAD_SEGMENT_SIZE = 0x400000,
+		TEXTUREUPLOAD_SEGMENT_COUNT = 4,
+		TEXTUREUPLOAD_ALIGNMENT = 0x40,
+	};
+
+	enum
+	{
+		//Textures smaller than this (in pixels) are converted on the GS thread only
+		TEXTURECONVERT_PARALLEL_THRESHOLD = 0x10000,
+	};
+
 	typedef void (CGSH_OpenGL::*TEXTUREUPDATER)(uint32, uint32, unsigned int, unsigned int, unsigned int, unsigned int);
 
 	enum
@@ -222,10 +251,13 @@ private:
 		uint32 m_cpsm;
 		uint32 m_csa;
 		GLuint m_texture;
+		uint64 m_contentsHash;
 		uint32 m_contents[256];
 	};
 	typedef std::shared_ptr<CPalette> PalettePtr;
 	typedef std::list<PalettePtr> PaletteList;
+	typedef std::unordered_map<uint32, PaletteList::iterator> PaletteKeyIndex;
+	typedef std::unordered_multimap<uint64, PaletteList::iterator> PaletteContentsIndex;
 
 	class CFramebuffer
 	{
@@ -265,6 +297,27 @@ private:
 	typedef std::shared_ptr<CDepthbuffer> DepthbufferPtr;
 	typedef std::vector<DepthbufferPtr> DepthbufferList;
 
+	//Maps a buffer's base pointer and width to its positions in a buffer list (in insertion order)
+	typedef std::unordered_map<uint64, std::vector<uint32>> BufferIndex;
+	static const uint32 BUFFERINDEX_NOTFOUND = ~0U;
+
+	static uint64 MakeBufferIndexKey(uint32 basePtr, uint32 width)
+	{
+		return (static_cast<uint64>(basePtr) << 32) | width;
+	}
+
+	template <typename Predicate>
+	static uint32 SearchBufferIndex(const BufferIndex& bufferIndex, uint32 basePtr, uint32 width, const Predicate& predicate)
+	{
+		auto indexIterator = bufferIndex.find(MakeBufferIndexKey(basePtr, width));
+		if(indexIterator == std::end(bufferIndex)) return BUFFERINDEX_NOTFOUND;
+		for(uint32 position : indexIterator->second)
+		{
+			if(predicate(position)) return position;
+		}
+		return BUFFERINDEX_NOTFOUND;
+	}
+
 	struct TEXTURE_INFO
 	{
 		GLuint textureHandle = 0;
@@ -314,6 +367,7 @@ private:
 	virtual void PresentBackbuffer() = 0;
 	void MakeLinearZOrtho(float*, float, float, float, float);
 	TEXTURE_INFO PrepareTexture(const TEX0&);
+	TexturePtr CreateCacheTexture(const TEX0&);
 	TEXTURE_INFO SearchTextureFramebuffer(const TEX0&);
 	GLuint PreparePalette(const TEX0&);
 
@@ -350,6 +404,8 @@ private:
 	void CopyToFb(int32, int32, int32, int32, int32, int32, int32, int32, int32, int32);
 	void DrawToDepth(unsigned int, uint64);
 
+	DRAWSTATE_KEY GetDrawStateKey(uint64) const;
+	bool IsDrawStateCurrent(const DRAWSTATE_KEY&) const;
 	void SetRenderingContext(uint64);
 	void SetupTestFunctions(uint64);
 	void SetupDepthBuffer(uint64, uint64);
@@ -369,6 +425,9 @@ private:
 
 	FramebufferPtr FindFramebuffer(const FRAME&) const;
 	DepthbufferPtr FindDepthbuffer(const ZBUF&, const FRAME&) const;
+	void AddFramebuffer(const FramebufferPtr&);
+	void AddDepthbuffer(const DepthbufferPtr&);
+	void ClearFramebuffers();
 
 	void DumpTexture(unsigned int, unsigned int, uint32);
 
@@ -390,6 +449,12 @@ private:
 	template <uint32, uint32>
 	void TexUpdater_Psm48H(uint32, uint32, unsigned int, unsigned int, unsigned int, unsigned int);
 
+	uint8* BeginTextureUpload(uint32);
+	void EndTextureUpload(unsigned int, unsigned int, unsigned int, unsigned int, GLenum, GLenum);
+	template <typename RowConverter>
+	void ConvertTextureRows(unsigned int, unsigned int, unsigned int, const RowConverter&);
+	void ReleaseTextureUploadBuffer();
+
 	//Context variables (put this in a struct or something?)
 	float m_nPrimOfsX;
 	float m_nPrimOfsY;
@@ -397,6 +462,7 @@ private:
 	uint32 m_nTexHeight;
 
 	bool m_forceBilinearTextures = false;
+	bool m_textureDeduplicationEnabled = true;
 	unsigned int m_fbScale = 1;
 	bool m_multisampleEnabled = false;
 	bool m_depthTestingEnabled = true;
@@ -405,9 +471,18 @@ private:
 
 	uint8* m_pCvtBuffer;
 
+	Framework::OpenGl::CBuffer m_textureUploadBuffer;
+	std::array<GLsync, TEXTUREUPLOAD_SEGMENT_COUNT> m_textureUploadFences = {};
+	uint32 m_textureUploadSegment = 0;
+	uint32 m_textureUploadOffset = 0;
+	uint32 m_textureUploadSize = 0;
+	bool m_textureUploadMapped = false;
+	std::unique_ptr<CTextureConvertWorkers> m_textureConvertWorkers;
+
+	static uint32 MakePaletteKey(bool, uint32, uint32);
 	GLuint PalCache_Search(const TEX0&);
-	GLuint PalCache_Search(unsigned int, const uint32*);
-	void PalCache_Insert(const TEX0&, const uint32*, GLuint);
+	GLuint PalCache_Search(unsigned int, const uint32*, uint64);
+	void PalCache_Insert(const TEX0&, const uint32*, uint64, GLuint);
 	void PalCache_Invalidate(uint32);
 
 	void PopulateFramebuffer(const FramebufferPtr&);
@@ -429,8 +504,12 @@ private:
 
 	TextureCache m_textureCache;
 	PaletteList m_paletteCache;
+	PaletteKeyIndex m_paletteLiveIndex;
+	PaletteContentsIndex m_paletteContentsIndex;
 	FramebufferList m_framebuffers;
 	DepthbufferList m_depthbuffers;
+	BufferIndex m_framebufferIndex;
+	BufferIndex m_depthbufferIndex;
 
 	Framework::OpenGl::CBuffer m_primBuffer;
 	Framework::OpenGl::CVertexArray m_primVertexArray;
@@ -7,6 +7,7 @@
 #include <intrin.h>
 #endif
 #include "SimdDefs.h"
+#include "xxhash.h"
 #include "GSH_OpenGL.h"
 #include "StdStream.h"
 #include "bitmap/BMP.h"
@@ -108,57 +109,58 @@ CGSH_OpenGL::TEXTURE_INFO CGSH_OpenGL::SearchTextureFramebuffer(const TEX0& tex0
 	FramebufferPtr framebuffer;
 
 	//First pass, look for an exact match
-	for(const auto& candidateFramebuffer : m_framebuffers)
+	uint32 framebufferPosition = SearchBufferIndex(m_framebufferIndex, tex0.GetBufPtr(), tex0.GetBufWidth(),
+	                                               [&](uint32 position) {
+		                                               const auto& candidateFramebuffer = m_framebuffers[position];
+
+		                                               //Case: TEX0 points at the start of a frame buffer with the same width
+		                                               if(IsCompatibleFramebufferPSM(candidateFramebuffer->m_psm, tex0.nPsm))
+		                                               {
+			                                               return true;
+		                                               }
+
+		                                               //Case: TEX0 point at the start of a frame buffer with the same width
+		                                               //but uses upper 8-bits (alpha) as an indexed texture (used in Yakuza)
+		                                               return (candidateFramebuffer->m_psm == CGSHandler::PSMCT32) &&
+		                                                      (tex0.nPsm == CGSHandler::PSMT8H);
+	                                               });
+	if(framebufferPosition != BUFFERINDEX_NOTFOUND)
 	{
-		//Case: TEX0 points at the start of a frame buffer with the same width
-		if(candidateFramebuffer->m_basePtr == tex0.GetBufPtr() &&
-		   candidateFramebuffer->m_width == tex0.GetBufWidth() &&
-		   IsCompatibleFramebufferPSM(candidateFramebuffer->m_psm, tex0.nPsm))
-		{
-			framebuffer = candidateFramebuffer;
-			break;
-		}
-
-		//Case: TEX0 point at the start of a frame buffer with the same width
-		//but uses upper 8-bits (alpha) as an indexed texture (used in Yakuza)
-		else if(candidateFramebuffer->m_basePtr == tex0.GetBufPtr() &&
-		        candidateFramebuffer->m_width == tex0.GetBufWidth() &&
-		        candidateFramebuffer->m_psm == CGSHandler::PSMCT32 &&
-		        tex0.nPsm == CGSHandler::PSMT8H)
-		{
-			framebuffer = candidateFramebuffer;
-			texInfo.alphaAsIndex = true;
-			break;
-		}
+		framebuffer = m_framebuffers[framebufferPosition];
+		texInfo.alphaAsIndex = !IsCompatibleFramebufferPSM(framebuffer->m_psm, tex0.nPsm);
 	}
 
 	if(!framebuffer)
 	{
 		//Second pass, be a bit more flexible
-		for(const auto& candidateFramebuffer : m_framebuffers)
+		//Another case: TEX0 is pointing to the start of a page within our framebuffer (BGDA does this)
+		//Only framebuffers starting on the same line of pages can match, probe each possible base pointer
+		//and keep the earliest created framebuffer to be consistent with a linear search.
+		auto framebufferPageSize = CGsPixelFormats::GetPsmPageSize(tex0.nPsm);
+		uint32 framebufferPageCountX = tex0.GetBufWidth() / framebufferPageSize.first;
+		uint32 bestPosition = BUFFERINDEX_NOTFOUND;
+		uint32 bestPageIndex = 0;
+		for(uint32 framebufferPageIndex = 0; framebufferPageIndex < framebufferPageCountX; framebufferPageIndex++)
 		{
-			//Another case: TEX0 is pointing to the start of a page within our framebuffer (BGDA does this)
-			if(candidateFramebuffer->m_basePtr <= tex0.GetBufPtr() &&
-			   candidateFramebuffer->m_width == tex0.GetBufWidth() &&
-			   candidateFramebuffer->m_psm == tex0.nPsm)
+			uint32 framebufferOffset = framebufferPageIndex * CGsPixelFormats::PAGESIZE;
+			if(framebufferOffset > tex0.GetBufPtr()) break;
+
+			uint32 position = SearchBufferIndex(m_framebufferIndex, tex0.GetBufPtr() - framebufferOffset, tex0.GetBufWidth(),
+			                                    [&](uint32 candidatePosition) {
+				                                    return m_framebuffers[candidatePosition]->m_psm == tex0.nPsm;
+			                                    });
+			if(position < bestPosition)
 			{
-				uint32 framebufferOffset = tex0.GetBufPtr() - candidateFramebuffer->m_basePtr;
-
-				//Bail if offset is not aligned on a page boundary
-				if((framebufferOffset & (CGsPixelFormats::PAGESIZE - 1)) != 0) continue;
-
-				auto framebufferPageSize = CGsPixelFormats::GetPsmPageSize(candidateFramebuffer->m_psm);
-				uint32 framebufferPageCountX = candidateFramebuffer->m_width / framebufferPageSize.first;
-				uint32 framebufferPageIndex = framebufferOffset / CGsPixelFormats::PAGESIZE;
-
-				//Bail if pointed page isn't on the first line
-				if(framebufferPageIndex >= framebufferPageCountX) continue;
-
-				framebuffer = candidateFramebuffer;
-				texInfo.offsetX = static_cast<float>(framebufferPageIndex * framebufferPageSize.first) / static_cast<float>(candidateFramebuffer->m_width);
-				break;
+				bestPosition = position;
+				bestPageIndex = framebufferPageIndex;
 			}
 		}
+
+		if(bestPosition != BUFFERINDEX_NOTFOUND)
+		{
+			framebuffer = m_framebuffers[bestPosition];
+			texInfo.offsetX = static_cast<float>(bestPageIndex * framebufferPageSize.first) / static_cast<float>(framebuffer->m_width);
+		}
 	}
 
 	if(framebuffer)
@@ -194,31 +196,40 @@ CGSH_OpenGL::TEXTURE_INFO CGSH_OpenGL::PrepareTexture(const TEX0& tex0)
 	auto texture = m_textureCache.Search(tex0);
 	if(!texture)
 	{
-		//Validate texture dimensions to prevent problems
-		auto texWidth = tex0.GetWidth();
-		auto texHeight = tex0.GetHeight();
-		assert(texWidth <= TEX0_MAX_TEXTURE_SIZE);
-		assert(texHeight <= TEX0_MAX_TEXTURE_SIZE);
-		texWidth = std::min<uint32>(texWidth, TEX0_MAX_TEXTURE_SIZE);
-		texHeight = std::min<uint32>(texHeight, TEX0_MAX_TEXTURE_SIZE);
-		auto texFormat = GetTextureFormatInfo(tex0.nPsm);
+		m_textureCache.Insert(tex0, CreateCacheTexture(tex0));
+		texture = m_textureCache.Search(tex0);
+		texture->m_cachedArea.Invalidate(0, RAMSIZE);
+	}
+
+	auto& cachedArea = texture->m_cachedArea;
 
+	if(m_textureDeduplicationEnabled && cachedArea.HasDirtyPages())
+	{
+		//Same data might already be loaded in a texture at another address, share it if that's the case
+		m_textureCache.UpdateContentHash(texture, m_pRAM);
+		auto sourceTexture = m_textureCache.SearchContents(tex0, cachedArea.GetContentHash(), texture);
+		if(sourceTexture)
 		{
-			auto textureHandle = Framework::OpenGl::CTexture::Create();
-			glBindTexture(GL_TEXTURE_2D, textureHandle);
-			glTexStorage2D(GL_TEXTURE_2D, 1, texFormat.internalFormat, texWidth, texHeight);
-			CHECKGLERROR();
-			m_textureCache.Insert(tex0, std::move(textureHandle));
+			texture->m_textureHandle = sourceTexture->m_textureHandle;
+			cachedArea.ClearDirtyPages();
 		}
+	}
 
-		texture = m_textureCache.Search(tex0);
-		texture->m_cachedArea.Invalidate(0, RAMSIZE);
+	if(cachedArea.HasDirtyPages() && (texture->m_textureHandle.use_count() > 1))
+	{
+		//Host texture is shared with other cached textures, we need our own copy before updating it
+		texture->m_textureHandle = CreateCacheTexture(tex0);
+		cachedArea.Invalidate(0, RAMSIZE);
+		if(m_textureDeduplicationEnabled)
+		{
+			//Invalidation above doesn't change contents, keep our hash usable for others
+			m_textureCache.UpdateContentHash(texture, m_pRAM);
+		}
 	}
 
-	texInfo.textureHandle = texture->m_textureHandle;
+	texInfo.textureHandle = *texture->m_textureHandle;
 
-	glBindTexture(GL_TEXTURE_2D, texture->m_textureHandle);
-	auto& cachedArea = texture->m_cachedArea;
+	glBindTexture(GL_TEXTURE_2D, *texture->m_textureHandle);
 	auto texturePageSize = CGsPixelFormats::GetPsmPageSize(tex0.nPsm);
 	auto areaRect = cachedArea.GetAreaPageRect();
 
@@ -252,6 +263,25 @@ CGSH_OpenGL::TEXTURE_INFO CGSH_OpenGL::PrepareTexture(const TEX0& tex0)
 	return texInfo;
 }
 
+CGSH_OpenGL::TexturePtr CGSH_OpenGL::CreateCacheTexture(const TEX0& tex0)
+{
+	//Validate texture dimensions to prevent problems
+	auto texWidth = tex0.GetWidth();
+	auto texHeight = tex0.GetHeight();
+	assert(texWidth <= TEX0_MAX_TEXTURE_SIZE);
+	assert(texHeight <= TEX0_MAX_TEXTURE_SIZE);
+	texWidth = std::min<uint32>(texWidth, TEX0_MAX_TEXTURE_SIZE);
+	texHeight = std::min<uint32>(texHeight, TEX0_MAX_TEXTURE_SIZE);
+	auto texFormat = GetTextureFormatInfo(tex0.nPsm);
+
+	auto textureHandle = Framework::OpenGl::CTexture::Create();
+	glBindTexture(GL_TEXTURE_2D, textureHandle);
+	glTexStorage2D(GL_TEXTURE_2D, 1, texFormat.internalFormat, texWidth, texHeight);
+	CHECKGLERROR();
+
+	return std::make_shared<Framework::OpenGl::CTexture>(std::move(textureHandle));
+}
+
 GLuint CGSH_OpenGL::PreparePalette(const TEX0& tex0)
 {
 	GLuint textureHandle = PalCache_Search(tex0);
@@ -264,7 +294,8 @@ GLuint CGSH_OpenGL::PreparePalette(const TEX0& tex0)
 	MakeLinearCLUT(tex0, convertedClut);
 
 	unsigned int entryCount = CGsPixelFormats::IsPsmIDTEX4(tex0.nPsm) ? 16 : 256;
-	textureHandle = PalCache_Search(entryCount, convertedClut.data());
+	uint64 contentsHash = XXH3_64bits(convertedClut.data(), sizeof(uint32) * entryCount);
+	textureHandle = PalCache_Search(entryCount, convertedClut.data(), contentsHash);
 	if(textureHandle != 0)
 	{
 		return textureHandle;
@@ -274,7 +305,7 @@ GLuint CGSH_OpenGL::PreparePalette(const TEX0& tex0)
 	glBindTexture(GL_TEXTURE_2D, textureHandle);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, entryCount, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, convertedClut.data());
 
-	PalCache_Insert(tex0, convertedClut.data(), textureHandle);
+	PalCache_Insert(tex0, convertedClut.data(), contentsHash, textureHandle);
 
 	return textureHandle;
 }
@@ -304,49 +335,117 @@ void CGSH_OpenGL::TexUpdater_Invalid(uint32 bufPtr, uint32 bufWidth, unsigned in
 	assert(0);
 }
 
-void CGSH_OpenGL::TexUpdater_Psm32(uint32 bufPtr, uint32 bufWidth, unsigned int texX, unsigned int texY, unsigned int texWidth, unsigned int texHeight)
+uint8* CGSH_OpenGL::BeginTextureUpload(uint32 size)
 {
-	CGsPixelFormats::CPixelIndexorPSMCT32 indexor(m_pRAM, bufPtr, bufWidth);
+	assert(!m_textureUploadMapped);
+	assert(size <= CVTBUFFERSIZE);
+#ifndef USE_TEXTURE_UPLOAD_BUFFER
+	return m_pCvtBuffer;
+#else
+	if(size > TEXTUREUPLOAD_SEGMENT_SIZE)
+	{
+		return m_pCvtBuffer;
+	}
 
-	uint32* dst = reinterpret_cast<uint32*>(m_pCvtBuffer);
-	for(unsigned int y = 0; y < texHeight; y++)
+	if((m_textureUploadOffset + size) > TEXTUREUPLOAD_SEGMENT_SIZE)
 	{
-		for(unsigned int x = 0; x < texWidth; x++)
+		//Current segment is full, fence it and move on to the next one.
+		//We can only write in the next segment once the GPU is done reading from it.
+		auto& currentFence = m_textureUploadFences[m_textureUploadSegment];
+		assert(currentFence == nullptr);
+		currentFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		m_textureUploadSegment = (m_textureUploadSegment + 1) % TEXTUREUPLOAD_SEGMENT_COUNT;
+		m_textureUploadOffset = 0;
+
+		auto& nextFence = m_textureUploadFences[m_textureUploadSegment];
+		if(nextFence != nullptr)
 		{
-			dst[x] = indexor.GetPixel(texX + x, texY + y);
+			glClientWaitSync(nextFence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			glDeleteSync(nextFence);
+			nextFence = nullptr;
 		}
+	}
 
-		dst += texWidth;
+	uint32 bufferOffset = (m_textureUploadSegment * TEXTUREUPLOAD_SEGMENT_SIZE) + m_textureUploadOffset;
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_textureUploadBuffer);
+	auto buffer = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, bufferOffset, size,
+	                               GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if(buffer == nullptr)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return m_pCvtBuffer;
+	}
+	if((reinterpret_cast<uintptr_t>(buffer) & 0xF) != 0)
+	{
+		//Column converters need 16 bytes alignment
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return m_pCvtBuffer;
 	}
 
-	glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, GL_RGBA, GL_UNSIGNED_BYTE, m_pCvtBuffer);
-	CHECKGLERROR();
+	m_textureUploadMapped = true;
+	m_textureUploadSize = size;
+	return reinterpret_cast<uint8*>(buffer);
+#endif
 }
 
-template <typename IndexorType>
-void CGSH_OpenGL::TexUpdater_Psm16(uint32 bufPtr, uint32 bufWidth, unsigned int texX, unsigned int texY, unsigned int texWidth, unsigned int texHeight)
+void CGSH_OpenGL::EndTextureUpload(unsigned int texX, unsigned int texY, unsigned int texWidth, unsigned int texHeight, GLenum format, GLenum type)
 {
-	IndexorType indexor(m_pRAM, bufPtr, bufWidth);
+	if(m_textureUploadMapped)
+	{
+		uintptr_t bufferOffset = (m_textureUploadSegment * TEXTUREUPLOAD_SEGMENT_SIZE) + m_textureUploadOffset;
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, format, type, reinterpret_cast<const void*>(bufferOffset));
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
-	auto dst = reinterpret_cast<uint16*>(m_pCvtBuffer);
-	for(unsigned int y = 0; y < texHeight; y++)
+		m_textureUploadOffset += (m_textureUploadSize + TEXTUREUPLOAD_ALIGNMENT - 1) & ~(TEXTUREUPLOAD_ALIGNMENT - 1);
+		m_textureUploadMapped = false;
+	}
+	else
 	{
-		for(unsigned int x = 0; x < texWidth; x++)
-		{
-			auto pixel = indexor.GetPixel(texX + x, texY + y);
-			auto cvtPixel =
-			    (((pixel & 0x001F) >> 0) << 11) | //R
-			    (((pixel & 0x03E0) >> 5) << 6) |  //G
-			    (((pixel & 0x7C00) >> 10) << 1) | //B
-			    (pixel >> 15);                    //A
-			dst[x] = cvtPixel;
-		}
+		glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, format, type, m_pCvtBuffer);
+	}
+	CHECKGLERROR();
+}
 
-		dst += texWidth;
+void CGSH_OpenGL::ReleaseTextureUploadBuffer()
+{
+	for(auto& fence : m_textureUploadFences)
+	{
+		if(fence == nullptr) continue;
+		glDeleteSync(fence);
+		fence = nullptr;
 	}
+	m_textureUploadBuffer.Reset();
+	m_textureUploadSegment = 0;
+	m_textureUploadOffset = 0;
+}
 
-	glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1, m_pCvtBuffer);
-	CHECKGLERROR();
+//Calls 'converter' with [startY, endY) row ranges covering the whole texture.
+//Large textures are split in bands (aligned on 'rowAlign') and converted in parallel.
+template <typename RowConverter>
+void CGSH_OpenGL::ConvertTextureRows(unsigned int texWidth, unsigned int texHeight, unsigned int rowAlign, const RowConverter& converter)
+{
+	unsigned int workerCount = m_textureConvertWorkers->GetWorkerCount();
+	unsigned int maxBandCount = texHeight / rowAlign;
+	if((workerCount == 0) || (maxBandCount < 2) || ((texWidth * texHeight) < TEXTURECONVERT_PARALLEL_THRESHOLD))
+	{
+		converter(0, texHeight);
+		return;
+	}
+
+	unsigned int bandCount = std::min(workerCount + 1, maxBandCount);
+	unsigned int bandHeight = (texHeight + bandCount - 1) / bandCount;
+	bandHeight = ((bandHeight + rowAlign - 1) / rowAlign) * rowAlign;
+	bandCount = (texHeight + bandHeight - 1) / bandHeight;
+
+	m_textureConvertWorkers->Execute(bandCount,
+	                                 [&](unsigned int bandIndex) {
+		                                 unsigned int startY = bandIndex * bandHeight;
+		                                 unsigned int endY = std::min(startY + bandHeight, texHeight);
+		                                 converter(startY, endY);
+	                                 });
 }
 
 #if defined(FRAMEWORK_SIMD_USE_SSE)
@@ -471,6 +570,22 @@ inline void convertColumn4(uint8* dest, const int destStride, uint8* src, int co
 	}
 }
 
+inline void convertColumn32(uint8* dest, const int destStride, const uint8* src)
+{
+	//Column words are stored as (0,0) (1,0) (0,1) (1,1) (2,0) (3,0) (2,1) (3,1) ...
+	auto mSrc = reinterpret_cast<const __m128i*>(src);
+
+	__m128i a = _mm_load_si128(mSrc + 0);
+	__m128i b = _mm_load_si128(mSrc + 1);
+	__m128i c = _mm_load_si128(mSrc + 2);
+	__m128i d = _mm_load_si128(mSrc + 3);
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 0x00), _mm_unpacklo_epi64(a, b));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 0x10), _mm_unpacklo_epi64(c, d));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + destStride + 0x00), _mm_unpackhi_epi64(a, b));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dest + destStride + 0x10), _mm_unpackhi_epi64(c, d));
+}
+
 #elif defined(FRAMEWORK_SIMD_USE_NEON)
 #include <arm_neon.h>
 
@@ -546,6 +661,25 @@ inline void convertColumn4(uint8* dest, const int destStride, uint8* src, int co
 	}
 }
 
+inline void convertColumn32(uint8* dest, const int destStride, const uint8* src)
+{
+	//Column words are stored as (0,0) (1,0) (0,1) (1,1) (2,0) (3,0) (2,1) (3,1) ...
+	auto src32 = reinterpret_cast<const uint32*>(src);
+
+	uint32x4_t a = vld1q_u32(src32 + 0);
+	uint32x4_t b = vld1q_u32(src32 + 4);
+	uint32x4_t c = vld1q_u32(src32 + 8);
+	uint32x4_t d = vld1q_u32(src32 + 12);
+
+	auto dst0 = reinterpret_cast<uint32*>(dest);
+	auto dst1 = reinterpret_cast<uint32*>(dest + destStride);
+
+	vst1q_u32(dst0 + 0, vcombine_u32(vget_low_u32(a), vget_low_u32(b)));
+	vst1q_u32(dst0 + 4, vcombine_u32(vget_low_u32(c), vget_low_u32(d)));
+	vst1q_u32(dst1 + 0, vcombine_u32(vget_high_u32(a), vget_high_u32(b)));
+	vst1q_u32(dst1 + 4, vcombine_u32(vget_high_u32(c), vget_high_u32(d)));
+}
+
 #else
 /*
 // If we have a platform that does not have SIMD then implement the basic case here.
@@ -554,8 +688,97 @@ void convertColumn8(uint8* dest, const int destStride, uint8* src, int colNum)
 
 }
 */
+
+inline void convertColumn32(uint8* dest, const int destStride, const uint8* src)
+{
+	auto src32 = reinterpret_cast<const uint32*>(src);
+	auto dst0 = reinterpret_cast<uint32*>(dest);
+	auto dst1 = reinterpret_cast<uint32*>(dest + destStride);
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		dst0[(i * 2) + 0] = src32[(i * 4) + 0];
+		dst0[(i * 2) + 1] = src32[(i * 4) + 1];
+		dst1[(i * 2) + 0] = src32[(i * 4) + 2];
+		dst1[(i * 2) + 1] = src32[(i * 4) + 3];
+	}
+}
 #endif
 
+void CGSH_OpenGL::TexUpdater_Psm32(uint32 bufPtr, uint32 bufWidth, unsigned int texX, unsigned int texY, unsigned int texWidth, unsigned int texHeight)
+{
+	CGsPixelFormats::CPixelIndexorPSMCT32 indexor(m_pRAM, bufPtr, bufWidth);
+
+	uint8* cvtBuffer = BeginTextureUpload(texWidth * texHeight * sizeof(uint32));
+
+	//A PSMCT32 column is 8x2 pixels, stored in 64 contiguous bytes
+	bool columnAligned = ((texX % 8) == 0) && ((texY % 2) == 0) && ((texWidth % 8) == 0) && ((texHeight % 2) == 0);
+	if(columnAligned)
+	{
+		ConvertTextureRows(texWidth, texHeight, 2,
+		                   [&](unsigned int startY, unsigned int endY) {
+			                   uint8* dst = cvtBuffer + (startY * texWidth * sizeof(uint32));
+			                   for(unsigned int y = startY; y < endY; y += 2)
+			                   {
+				                   for(unsigned int x = 0; x < texWidth; x += 8)
+				                   {
+					                   auto src = reinterpret_cast<const uint8*>(indexor.GetPixelAddress(texX + x, texY + y));
+					                   convertColumn32(dst + (x * sizeof(uint32)), texWidth * sizeof(uint32), src);
+				                   }
+
+				                   dst += texWidth * sizeof(uint32) * 2;
+			                   }
+		                   });
+	}
+	else
+	{
+		ConvertTextureRows(texWidth, texHeight, 1,
+		                   [&](unsigned int startY, unsigned int endY) {
+			                   uint32* dst = reinterpret_cast<uint32*>(cvtBuffer) + (startY * texWidth);
+			                   for(unsigned int y = startY; y < endY; y++)
+			                   {
+				                   for(unsigned int x = 0; x < texWidth; x++)
+				                   {
+					                   dst[x] = indexor.GetPixel(texX + x, texY + y);
+				                   }
+
+				                   dst += texWidth;
+			                   }
+		                   });
+	}
+
+	EndTextureUpload(texX, texY, texWidth, texHeight, GL_RGBA, GL_UNSIGNED_BYTE);
+}
+
+template <typename IndexorType>
+void CGSH_OpenGL::TexUpdater_Psm16(uint32 bufPtr, uint32 bufWidth, unsigned int texX, unsigned int texY, unsigned int texWidth, unsigned int texHeight)
+{
+	IndexorType indexor(m_pRAM, bufPtr, bufWidth);
+
+	uint8* cvtBuffer = BeginTextureUpload(texWidth * texHeight * sizeof(uint16));
+
+	ConvertTextureRows(texWidth, texHeight, 1,
+	                   [&](unsigned int startY, unsigned int endY) {
+		                   auto dst = reinterpret_cast<uint16*>(cvtBuffer) + (startY * texWidth);
+		                   for(unsigned int y = startY; y < endY; y++)
+		                   {
+			                   for(unsigned int x = 0; x < texWidth; x++)
+			                   {
+				                   auto pixel = indexor.GetPixel(texX + x, texY + y);
+				                   auto cvtPixel =
+				                       (((pixel & 0x001F) >> 0) << 11) | //R
+				                       (((pixel & 0x03E0) >> 5) << 6) |  //G
+				                       (((pixel & 0x7C00) >> 10) << 1) | //B
+				                       (pixel >> 15);                    //A
+				                   dst[x] = cvtPixel;
+			                   }
+
+			                   dst += texWidth;
+		                   }
+	                   });
+
+	EndTextureUpload(texX, texY, texWidth, texHeight, GL_RGBA, GL_UNSIGNED_SHORT_5_5_5_1);
+}
+
 void CGSH_OpenGL::TexUpdater_Psm8(uint32 bufPtr, uint32 bufWidth, unsigned int texX, unsigned int texY, unsigned int texWidth, unsigned int texHeight)
 {
 	if(texWidth < 16)
@@ -567,31 +790,36 @@ void CGSH_OpenGL::TexUpdater_Psm8(uint32 bufPtr, uint32 bufWidth, unsigned int t
 	}
 
 	CGsPixelFormats::CPixelIndexorPSMT8 indexor(m_pRAM, bufPtr, bufWidth);
-	uint8* dst = m_pCvtBuffer;
-	for(unsigned int y = 0; y < texHeight; y += 16)
-	{
-		for(unsigned int x = 0; x < texWidth; x += 16)
-		{
-			uint8* colDst = dst;
-			uint8* src = indexor.GetPixelAddress(texX + x, texY + y);
-
-			// process an entire 16x16 block.
-			// A column (64 bytes) is 16x4 pixels and they stack vertically in a block
 
-			int colNum = 0;
-			for(unsigned int coly = 0; coly < 16; coly += 4)
-			{
-				convertColumn8(colDst + x, texWidth, src, colNum++);
-				src += 64;
-				colDst += texWidth * 4;
-			}
-		}
-
-		dst += texWidth * 16;
-	}
-
-	glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, GL_RED, GL_UNSIGNED_BYTE, m_pCvtBuffer);
-	CHECKGLERROR();
+	uint8* cvtBuffer = BeginTextureUpload(texWidth * texHeight);
+
+	ConvertTextureRows(texWidth, texHeight, 16,
+	                   [&](unsigned int startY, unsigned int endY) {
+		                   uint8* dst = cvtBuffer + (startY * texWidth);
+		                   for(unsigned int y = startY; y < endY; y += 16)
+		                   {
+			                   for(unsigned int x = 0; x < texWidth; x += 16)
+			                   {
+				                   uint8* colDst = dst;
+				                   uint8* src = indexor.GetPixelAddress(texX + x, texY + y);
+
+				                   // process an entire 16x16 block.
+				                   // A column (64 bytes) is 16x4 pixels and they stack vertically in a block
+
+				                   int colNum = 0;
+				                   for(unsigned int coly = 0; coly < 16; coly += 4)
+				                   {
+					                   convertColumn8(colDst + x, texWidth, src, colNum++);
+					                   src += 64;
+					                   colDst += texWidth * 4;
+				                   }
+			                   }
+
+			                   dst += texWidth * 16;
+		                   }
+	                   });
+
+	EndTextureUpload(texX, texY, texWidth, texHeight, GL_RED, GL_UNSIGNED_BYTE);
 }
 
 void CGSH_OpenGL::TexUpdater_Psm4(unsigned int bufPtr, unsigned int bufWidth, unsigned int texX, unsigned int texY, unsigned int texWidth, unsigned int texHeight)
@@ -607,32 +835,37 @@ void CGSH_OpenGL::TexUpdater_Psm4(unsigned int bufPtr, unsigned int bufWidth, un
 
 	CGsPixelFormats::CPixelIndexorPSMT4 indexor(m_pRAM, bufPtr, bufWidth);
 
-	uint8* dst = m_pCvtBuffer;
-	for(unsigned int y = 0; y < texHeight; y += 16)
-	{
-		for(unsigned int x = 0; x < texWidth; x += 32)
-		{
-			uint8* colDst = dst + x;
-			unsigned int nx = texX + x;
-			unsigned int ny = texY + y;
-			uint32 colAddr = indexor.GetColumnAddress(nx, ny);
-			uint8* src = m_pRAM + colAddr;
-
-			// process an entire 32x16 block.
-			// A column (64 bytes) is 32x4 pixels and they stack vertically in a block
-
-			for(unsigned int colNum = 0; colNum < 4; ++colNum)
-			{
-				convertColumn4(colDst, texWidth, src, colNum);
-				src += 64;
-				colDst += texWidth * 4;
-			}
-		}
-
-		dst += texWidth * 16;
-	}
-	glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, GL_RED, GL_UNSIGNED_BYTE, m_pCvtBuffer);
-	CHECKGLERROR();
+	uint8* cvtBuffer = BeginTextureUpload(texWidth * texHeight);
+
+	ConvertTextureRows(texWidth, texHeight, 16,
+	                   [&](unsigned int startY, unsigned int endY) {
+		                   uint8* dst = cvtBuffer + (startY * texWidth);
+		                   for(unsigned int y = startY; y < endY; y += 16)
+		                   {
+			                   for(unsigned int x = 0; x < texWidth; x += 32)
+			                   {
+				                   uint8* colDst = dst + x;
+				                   unsigned int nx = texX + x;
+				                   unsigned int ny = texY + y;
+				                   uint32 colAddr = indexor.GetColumnAddress(nx, ny);
+				                   uint8* src = m_pRAM + colAddr;
+
+				                   // process an entire 32x16 block.
+				                   // A column (64 bytes) is 32x4 pixels and they stack vertically in a block
+
+				                   for(unsigned int colNum = 0; colNum < 4; ++colNum)
+				                   {
+					                   convertColumn4(colDst, texWidth, src, colNum);
+					                   src += 64;
+					                   colDst += texWidth * 4;
+				                   }
+			                   }
+
+			                   dst += texWidth * 16;
+		                   }
+	                   });
+
+	EndTextureUpload(texX, texY, texWidth, texHeight, GL_RED, GL_UNSIGNED_BYTE);
 }
 
 template <typename IndexorType>
@@ -640,20 +873,24 @@ void CGSH_OpenGL::TexUpdater_Psm48(uint32 bufPtr, uint32 bufWidth, unsigned int
 {
 	IndexorType indexor(m_pRAM, bufPtr, bufWidth);
 
-	uint8* dst = m_pCvtBuffer;
-	for(unsigned int y = 0; y < texHeight; y++)
-	{
-		for(unsigned int x = 0; x < texWidth; x++)
-		{
-			uint8 pixel = indexor.GetPixel(texX + x, texY + y);
-			dst[x] = pixel;
-		}
+	uint8* cvtBuffer = BeginTextureUpload(texWidth * texHeight);
 
-		dst += texWidth;
-	}
+	ConvertTextureRows(texWidth, texHeight, 1,
+	                   [&](unsigned int startY, unsigned int endY) {
+		                   uint8* dst = cvtBuffer + (startY * texWidth);
+		                   for(unsigned int y = startY; y < endY; y++)
+		                   {
+			                   for(unsigned int x = 0; x < texWidth; x++)
+			                   {
+				                   uint8 pixel = indexor.GetPixel(texX + x, texY + y);
+				                   dst[x] = pixel;
+			                   }
 
-	glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, GL_RED, GL_UNSIGNED_BYTE, m_pCvtBuffer);
-	CHECKGLERROR();
+			                   dst += texWidth;
+		                   }
+	                   });
+
+	EndTextureUpload(texX, texY, texWidth, texHeight, GL_RED, GL_UNSIGNED_BYTE);
 }
 
 template <uint32 shiftAmount, uint32 mask>
@@ -661,21 +898,25 @@ void CGSH_OpenGL::TexUpdater_Psm48H(uint32 bufPtr, uint32 bufWidth, unsigned int
 {
 	CGsPixelFormats::CPixelIndexorPSMCT32 indexor(m_pRAM, bufPtr, bufWidth);
 
-	uint8* dst = m_pCvtBuffer;
-	for(unsigned int y = 0; y < texHeight; y++)
-	{
-		for(unsigned int x = 0; x < texWidth; x++)
-		{
-			uint32 pixel = indexor.GetPixel(texX + x, texY + y);
-			pixel = (pixel >> shiftAmount) & mask;
-			dst[x] = static_cast<uint8>(pixel);
-		}
-
-		dst += texWidth;
-	}
-
-	glTexSubImage2D(GL_TEXTURE_2D, 0, texX, texY, texWidth, texHeight, GL_RED, GL_UNSIGNED_BYTE, m_pCvtBuffer);
-	CHECKGLERROR();
+	uint8* cvtBuffer = BeginTextureUpload(texWidth * texHeight);
+
+	ConvertTextureRows(texWidth, texHeight, 1,
+	                   [&](unsigned int startY, unsigned int endY) {
+		                   uint8* dst = cvtBuffer + (startY * texWidth);
+		                   for(unsigned int y = startY; y < endY; y++)
+		                   {
+			                   for(unsigned int x = 0; x < texWidth; x++)
+			                   {
+				                   uint32 pixel = indexor.GetPixel(texX + x, texY + y);
+				                   pixel = (pixel >> shiftAmount) & mask;
+				                   dst[x] = static_cast<uint8>(pixel);
+			                   }
+
+			                   dst += texWidth;
+		                   }
+	                   });
+
+	EndTextureUpload(texX, texY, texWidth, texHeight, GL_RED, GL_UNSIGNED_BYTE);
 }
 
 /////////////////////////////////////////////////////////////
@@ -688,6 +929,7 @@ CGSH_OpenGL::CPalette::CPalette()
     , m_cpsm(0)
     , m_csa(0)
     , m_texture(0)
+    , m_contentsHash(0)
 {
 }
 
@@ -717,30 +959,31 @@ void CGSH_OpenGL::CPalette::Invalidate(uint32 csa)
 // Palette Caching
 /////////////////////////////////////////////////////////////
 
-GLuint CGSH_OpenGL::PalCache_Search(const TEX0& tex0)
+uint32 CGSH_OpenGL::MakePaletteKey(bool isIDTEX4, uint32 cpsm, uint32 csa)
 {
-	for(auto paletteIterator(m_paletteCache.begin());
-	    paletteIterator != m_paletteCache.end(); paletteIterator++)
-	{
-		auto palette = *paletteIterator;
-		if(!palette->m_live) continue;
-		if(CGsPixelFormats::IsPsmIDTEX4(tex0.nPsm) != palette->m_isIDTEX4) continue;
-		if(tex0.nCPSM != palette->m_cpsm) continue;
-		if(tex0.nCSA != palette->m_csa) continue;
-		m_paletteCache.erase(paletteIterator);
-		m_paletteCache.push_front(palette);
-		return palette->m_texture;
-	}
+	return (isIDTEX4 ? 0x10000 : 0) | (cpsm << 8) | csa;
+}
 
-	return 0;
+GLuint CGSH_OpenGL::PalCache_Search(const TEX0& tex0)
+{
+	//Live index always points to the most recently used live palette for a given key
+	auto indexIterator = m_paletteLiveIndex.find(MakePaletteKey(CGsPixelFormats::IsPsmIDTEX4(tex0.nPsm), tex0.nCPSM, tex0.nCSA));
+	if(indexIterator == std::end(m_paletteLiveIndex)) return 0;
+
+	auto paletteIterator = indexIterator->second;
+	const auto& palette = *paletteIterator;
+	assert(palette->m_live);
+	m_paletteCache.splice(m_paletteCache.begin(), m_paletteCache, paletteIterator);
+	return palette->m_texture;
 }
 
-GLuint CGSH_OpenGL::PalCache_Search(unsigned int entryCount, const uint32* contents)
+GLuint CGSH_OpenGL::PalCache_Search(unsigned int entryCount, const uint32* contents, uint64 contentsHash)
 {
-	for(auto paletteIterator(m_paletteCache.begin());
-	    paletteIterator != m_paletteCache.end(); paletteIterator++)
+	auto paletteRange = m_paletteContentsIndex.equal_range(contentsHash);
+	for(auto indexIterator = paletteRange.first; indexIterator != paletteRange.second; indexIterator++)
 	{
-		auto palette = *paletteIterator;
+		auto paletteIterator = indexIterator->second;
+		const auto& palette = *paletteIterator;
 
 		if(palette->m_texture == 0) continue;
 
@@ -750,18 +993,37 @@ GLuint CGSH_OpenGL::PalCache_Search(unsigned int entryCount, const uint32* conte
 		if(memcmp(contents, palette->m_contents, sizeof(uint32) * entryCount) != 0) continue;
 
 		palette->m_live = true;
+		m_paletteLiveIndex[MakePaletteKey(palette->m_isIDTEX4, palette->m_cpsm, palette->m_csa)] = paletteIterator;
 
-		m_paletteCache.erase(paletteIterator);
-		m_paletteCache.push_front(palette);
+		m_paletteCache.splice(m_paletteCache.begin(), m_paletteCache, paletteIterator);
 		return palette->m_texture;
 	}
 
 	return 0;
 }
 
-void CGSH_OpenGL::PalCache_Insert(const TEX0& tex0, const uint32* contents, GLuint textureHandle)
+void CGSH_OpenGL::PalCache_Insert(const TEX0& tex0, const uint32* contents, uint64 contentsHash, GLuint textureHandle)
 {
-	auto texture = *m_paletteCache.rbegin();
+	auto paletteIterator = std::prev(m_paletteCache.end());
+	auto texture = *paletteIterator;
+
+	//Remove evicted palette from indices
+	if(texture->m_texture != 0)
+	{
+		auto liveIterator = m_paletteLiveIndex.find(MakePaletteKey(texture->m_isIDTEX4, texture->m_cpsm, texture->m_csa));
+		if((liveIterator != std::end(m_paletteLiveIndex)) && (liveIterator->second == paletteIterator))
+		{
+			m_paletteLiveIndex.erase(liveIterator);
+		}
+		auto paletteRange = m_paletteContentsIndex.equal_range(texture->m_contentsHash);
+		for(auto indexIterator = paletteRange.first; indexIterator != paletteRange.second; indexIterator++)
+		{
+			if(indexIterator->second != paletteIterator) continue;
+			m_paletteContentsIndex.erase(indexIterator);
+			break;
+		}
+	}
+
 	texture->Free();
 
 	unsigned int entryCount = CGsPixelFormats::IsPsmIDTEX4(tex0.nPsm) ? 16 : 256;
@@ -771,20 +1033,26 @@ void CGSH_OpenGL::PalCache_Insert(const TEX0& tex0, const uint32* contents, GLui
 	texture->m_csa = tex0.nCSA;
 	texture->m_texture = textureHandle;
 	texture->m_live = true;
+	texture->m_contentsHash = contentsHash;
 	memcpy(texture->m_contents, contents, entryCount * sizeof(uint32));
 
-	m_paletteCache.pop_back();
-	m_paletteCache.push_front(texture);
+	m_paletteCache.splice(m_paletteCache.begin(), m_paletteCache, paletteIterator);
+
+	m_paletteLiveIndex[MakePaletteKey(texture->m_isIDTEX4, texture->m_cpsm, texture->m_csa)] = paletteIterator;
+	m_paletteContentsIndex.emplace(contentsHash, paletteIterator);
 }
 
 void CGSH_OpenGL::PalCache_Invalidate(uint32 csa)
 {
 	std::for_each(std::begin(m_paletteCache), std::end(m_paletteCache),
 	              [csa](PalettePtr& palette) { palette->Invalidate(csa); });
+	m_paletteLiveIndex.clear();
 }
 
 void CGSH_OpenGL::PalCache_Flush()
 {
 	std::for_each(std::begin(m_paletteCache), std::end(m_paletteCache),
 	              [](PalettePtr& palette) { palette->Free(); });
+	m_paletteLiveIndex.clear();
+	m_paletteContentsIndex.clear();
 }
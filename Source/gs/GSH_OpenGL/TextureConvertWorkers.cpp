@@ -0,0 +1,96 @@
+#include <algorithm>
+#include "TextureConvertWorkers.h"
+
+CTextureConvertWorkers::CTextureConvertWorkers(unsigned int workerCount)
+{
+	if(workerCount == 0)
+	{
+		//Keep one core for the GS thread and one for the EE/IOP thread
+		unsigned int hwThreadCount = std::thread::hardware_concurrency();
+		workerCount = (hwThreadCount > 2) ? std::min<unsigned int>(hwThreadCount - 2, 3) : 0;
+	}
+#ifdef __EMSCRIPTEN__
+	//Web builds have a small fixed thread pool, convert on the GS thread only
+	workerCount = 0;
+#endif
+	for(unsigned int i = 0; i < workerCount; i++)
+	{
+		m_threads.emplace_back([this]() { WorkerProc(); });
+	}
+}
+
+CTextureConvertWorkers::~CTextureConvertWorkers()
+{
+	{
+		std::unique_lock lock(m_mutex);
+		m_terminate = true;
+	}
+	m_jobCondition.notify_all();
+	for(auto& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+unsigned int CTextureConvertWorkers::GetWorkerCount() const
+{
+	return static_cast<unsigned int>(m_threads.size());
+}
+
+void CTextureConvertWorkers::Execute(unsigned int jobCount, const JobFunction& jobFunction)
+{
+	if(jobCount == 0) return;
+	if(m_threads.empty() || (jobCount == 1))
+	{
+		for(unsigned int i = 0; i < jobCount; i++)
+		{
+			jobFunction(i);
+		}
+		return;
+	}
+
+	std::unique_lock lock(m_mutex);
+	m_jobFunction = &jobFunction;
+	m_jobCount = jobCount;
+	m_nextJob = 0;
+	m_pendingJobs = jobCount;
+	m_jobCondition.notify_all();
+
+	while(RunNextJob(lock))
+	{
+	}
+
+	m_doneCondition.wait(lock, [this]() { return m_pendingJobs == 0; });
+	m_jobFunction = nullptr;
+	m_jobCount = 0;
+	m_nextJob = 0;
+}
+
+bool CTextureConvertWorkers::RunNextJob(std::unique_lock<std::mutex>& lock)
+{
+	if(m_nextJob == m_jobCount) return false;
+	unsigned int jobIndex = m_nextJob++;
+	auto jobFunction = m_jobFunction;
+	lock.unlock();
+	(*jobFunction)(jobIndex);
+	lock.lock();
+	m_pendingJobs--;
+	if(m_pendingJobs == 0)
+	{
+		m_doneCondition.notify_all();
+	}
+	return true;
+}
+
+void CTextureConvertWorkers::WorkerProc()
+{
+	std::unique_lock lock(m_mutex);
+	while(true)
+	{
+		m_jobCondition.wait(lock, [this]() { return m_terminate || (m_nextJob != m_jobCount); });
+		if(m_terminate) break;
+		while(RunNextJob(lock))
+		{
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+//Small pool of threads used to split texture deswizzling work in bands.
+//Execute blocks until every job has been processed, the calling thread also takes part in the work.
+class CTextureConvertWorkers
+{
+public:
+	typedef std::function<void(unsigned int)> JobFunction;
+
+	CTextureConvertWorkers(unsigned int = 0);
+	virtual ~CTextureConvertWorkers();
+
+	unsigned int GetWorkerCount() const;
+	void Execute(unsigned int, const JobFunction&);
+
+private:
+	void WorkerProc();
+	bool RunNextJob(std::unique_lock<std::mutex>&);
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_jobCondition;
+	std::condition_variable m_doneCondition;
+
+	const JobFunction* m_jobFunction = nullptr;
+	unsigned int m_jobCount = 0;
+	unsigned int m_nextJob = 0;
+	unsigned int m_pendingJobs = 0;
+	bool m_terminate = false;
+};
@@ -588,6 +588,12 @@ void CGSHandler::Flip(uint32 flags)
 	    waitForCompletion, waitForCompletion);
 }
 
+CGSHandler::FRAME_DRAW_STATS CGSHandler::GetLastFrameDrawStats() const
+{
+	std::lock_guard<std::mutex> statsLock(m_lastFrameDrawStatsMutex);
+	return m_lastFrameDrawStats;
+}
+
 void CGSHandler::FlipImpl(const DISPLAY_INFO&)
 {
 	OnFlipComplete();
@@ -597,7 +603,15 @@ void CGSHandler::FlipImpl(const DISPLAY_INFO&)
 void CGSHandler::MarkNewFrame()
 {
 	OnNewFrame(m_drawCallCount);
+	{
+		std::lock_guard<std::mutex> statsLock(m_lastFrameDrawStatsMutex);
+		m_lastFrameDrawStats.drawCount = m_drawCallCount;
+		m_lastFrameDrawStats.flushCount = m_flushCount;
+		m_lastFrameDrawStats.stateChangeCount = m_stateChangeCount;
+	}
 	m_drawCallCount = 0;
+	m_flushCount = 0;
+	m_stateChangeCount = 0;
 	UpdateFrameDumpState();
 #if LOGGING_ENABLED
 	CLog::GetInstance().Print(LOG_NAME, "Frame Done.\r\n---------------------------------------------------------------------------------\r\n");
@@ -4,6 +4,7 @@
 #include <vector>
 #include <functional>
 #include <atomic>
+#include <mutex>
 #include <array>
 #include "signal/Signal.h"
 
@@ -810,6 +811,13 @@ public:
 	};
 	static_assert(sizeof(LABEL) == sizeof(uint64), "Size of LABEL struct must be 8 bytes.");
 
+	struct FRAME_DRAW_STATS
+	{
+		uint32 drawCount = 0;
+		uint32 flushCount = 0;
+		uint32 stateChangeCount = 0;
+	};
+
 	typedef std::pair<uint8, uint64> RegisterWrite;
 	typedef std::vector<RegisterWrite> RegisterWriteList;
 	typedef std::function<CGSHandler*()> FactoryFunction;
@@ -861,6 +869,20 @@ public:
 		m_currentWriteBuffer[m_writeBufferSize++] = write;
 	}
 
+	//Returns a pointer where up to 'count' register writes can be stored directly,
+	//or nullptr if the buffer can't hold that many. Must be followed by CommitRegisterWrites.
+	inline RegisterWrite* ReserveRegisterWrites(uint32 count)
+	{
+		if((m_writeBufferSize + count) > REGISTERWRITEBUFFER_SIZE) return nullptr;
+		return m_currentWriteBuffer + m_writeBufferSize;
+	}
+
+	inline void CommitRegisterWrites(uint32 count)
+	{
+		assert((m_writeBufferSize + count) <= REGISTERWRITEBUFFER_SIZE);
+		m_writeBufferSize += count;
+	}
+
 	void ProcessWriteBuffer(const CGsPacketMetadata*);
 	void SubmitWriteBuffer();
 	void FlushWriteBuffer();
@@ -903,6 +925,9 @@ public:
 
 	void ProcessSingleFrame();
 
+	//Safe to call from any thread, stats are published by the GS thread when a frame ends
+	FRAME_DRAW_STATS GetLastFrameDrawStats() const;
+
 	FlipCompleteEvent OnFlipComplete;
 	NewFrameEvent OnNewFrame;
 
@@ -1111,6 +1136,11 @@ protected:
 	uint32 m_nCBP1;
 
 	uint32 m_drawCallCount = 0;
+	//Flushes that issued a draw and render state changes, only updated by the GS thread
+	uint32 m_flushCount = 0;
+	uint32 m_stateChangeCount = 0;
+	FRAME_DRAW_STATS m_lastFrameDrawStats;
+	mutable std::mutex m_lastFrameDrawStatsMutex;
 
 	static constexpr int MAX_INFLIGHT_FRAMES = 2;
 	RegisterWrite* m_writeBuffers[MAX_INFLIGHT_FRAMES] = {};
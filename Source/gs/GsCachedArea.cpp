@@ -1,6 +1,8 @@
 #include <cassert>
+#include <algorithm>
 #include <cstring>
 #include "maybe_unused.h"
+#include "xxhash.h"
 #include "GsCachedArea.h"
 #include "GsPixelFormats.h"
 
@@ -21,6 +23,7 @@ static bool DoMemoryRangesOverlap(uint32 start1, uint32 size1, uint32 start2, ui
 CGsCachedArea::CGsCachedArea()
 {
 	ClearDirtyPages();
+	memset(m_hashDirtyPages, 0xFF, sizeof(m_hashDirtyPages));
 }
 
 void CGsCachedArea::SetArea(uint32 psm, uint32 bufPtr, uint32 bufWidth, uint32 height)
@@ -29,6 +32,7 @@ void CGsCachedArea::SetArea(uint32 psm, uint32 bufPtr, uint32 bufWidth, uint32 h
 	m_bufPtr = bufPtr;
 	m_bufWidth = bufWidth;
 	m_height = height;
+	memset(m_hashDirtyPages, 0xFF, sizeof(m_hashDirtyPages));
 
 	//Check that we have enough bits to represent page dirtyness in m_dirtyPages
 	{
@@ -152,6 +156,7 @@ void CGsCachedArea::SetPageDirty(uint32 pageIndex)
 	unsigned int dirtyPageSection = pageIndex / (sizeof(m_dirtyPages[0]) * 8);
 	unsigned int dirtyPageIndex = pageIndex % (sizeof(m_dirtyPages[0]) * 8);
 	m_dirtyPages[dirtyPageSection] |= (1ULL << dirtyPageIndex);
+	m_hashDirtyPages[dirtyPageSection] |= (1ULL << dirtyPageIndex);
 }
 
 bool CGsCachedArea::HasDirtyPages() const
@@ -188,3 +193,51 @@ void CGsCachedArea::ClearDirtyPages(const PageRect& rect)
 		}
 	}
 }
+
+void CGsCachedArea::UpdateContentHash(const uint8* ram)
+{
+	uint32 pageCount = GetPageCount();
+	assert(pageCount <= MAX_DIRTYPAGES);
+	m_pageHashes.resize(pageCount);
+
+	for(uint32 pageIndex = 0; pageIndex < pageCount; pageIndex++)
+	{
+		unsigned int dirtyPageSection = pageIndex / (sizeof(m_hashDirtyPages[0]) * 8);
+		unsigned int dirtyPageIndex = pageIndex % (sizeof(m_hashDirtyPages[0]) * 8);
+		if((m_hashDirtyPages[dirtyPageSection] & (1ULL << dirtyPageIndex)) == 0) continue;
+
+		uint32 pageAddress = (m_bufPtr + (pageIndex * CGsPixelFormats::PAGESIZE)) & (CGSHandler::RAMSIZE - 1);
+		uint32 pageSize = std::min<uint32>(CGsPixelFormats::PAGESIZE, CGSHandler::RAMSIZE - pageAddress);
+		if(pageSize != CGsPixelFormats::PAGESIZE)
+		{
+			//Page wraps around the end of GS memory, hash it as if it was contiguous
+			uint8 pageBuffer[CGsPixelFormats::PAGESIZE];
+			memcpy(pageBuffer, ram + pageAddress, pageSize);
+			memcpy(pageBuffer + pageSize, ram, CGsPixelFormats::PAGESIZE - pageSize);
+			m_pageHashes[pageIndex] = XXH3_64bits(pageBuffer, CGsPixelFormats::PAGESIZE);
+		}
+		else
+		{
+			m_pageHashes[pageIndex] = XXH3_64bits(ram + pageAddress, pageSize);
+		}
+	}
+
+	memset(m_hashDirtyPages, 0, sizeof(m_hashDirtyPages));
+	m_contentHash = XXH3_64bits(m_pageHashes.data(), m_pageHashes.size() * sizeof(uint64));
+}
+
+uint64 CGsCachedArea::GetContentHash() const
+{
+	assert(IsContentHashValid());
+	return m_contentHash;
+}
+
+bool CGsCachedArea::IsContentHashValid() const
+{
+	DirtyPageHolder dirtyStatus = 0;
+	for(unsigned int i = 0; i < MAX_DIRTYPAGES_SECTIONS; i++)
+	{
+		dirtyStatus |= m_hashDirtyPages[i];
+	}
+	return (dirtyStatus == 0);
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 #include "Types.h"
 
 class CGsCachedArea
@@ -39,6 +40,11 @@ public:
 	void ClearDirtyPages();
 	void ClearDirtyPages(const PageRect&);
 
+	//Content hashing, only pages invalidated since the last update are rehashed
+	void UpdateContentHash(const uint8*);
+	uint64 GetContentHash() const;
+	bool IsContentHashValid() const;
+
 private:
 	uint32 m_psm = 0;
 	uint32 m_bufPtr = 0;
@@ -46,4 +52,7 @@ private:
 	uint32 m_height = 0;
 
 	DirtyPageHolder m_dirtyPages[MAX_DIRTYPAGES_SECTIONS];
+	DirtyPageHolder m_hashDirtyPages[MAX_DIRTYPAGES_SECTIONS];
+	std::vector<uint64> m_pageHashes;
+	uint64 m_contentHash = 0;
 };
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <cassert>
 #include <list>
+#include <unordered_map>
 #include "GSHandler.h"
 #include "GsCachedArea.h"
 
 #define TEX0_CLUTINFO_MASK (~0xFFFFFFE000000000ULL)
+#define TEX0_BUFPTR_MASK (~0x3FFFULL)
 
 template <typename TextureHandleType>
 class CGsTextureCache
@@ -24,6 +27,10 @@ public:
 		bool m_live = false;
 		CGsCachedArea m_cachedArea;
 
+		//Key this texture is registered under in the contents index, if any
+		bool m_contentIndexed = false;
+		std::pair<uint64, uint64> m_contentKey;
+
 		//Platform specific
 		TextureHandleType m_textureHandle;
 	};
@@ -59,9 +66,44 @@ public:
 		return nullptr;
 	}
 
+	//Looks for another live texture with the same format that has identical and up to date contents.
+	//Used to share host textures between copies of the same data in different GS memory locations.
+	CTexture* SearchContents(const CGSHandler::TEX0& tex0, uint64 contentHash, const CTexture* excludedTexture)
+	{
+		uint64 formatTex0 = static_cast<uint64>(tex0) & TEX0_CLUTINFO_MASK & TEX0_BUFPTR_MASK;
+
+		//Index entries are only updated when hashes are computed, contents might have been invalidated since
+		auto textureRange = m_contentIndex.equal_range(std::make_pair(formatTex0, contentHash));
+		for(auto textureIterator = textureRange.first; textureIterator != textureRange.second; textureIterator++)
+		{
+			auto texture = textureIterator->second;
+			assert(texture->m_live);
+			if(texture == excludedTexture) continue;
+			const auto& cachedArea = texture->m_cachedArea;
+			if(cachedArea.HasDirtyPages()) continue;
+			if(!cachedArea.IsContentHashValid()) continue;
+			assert(cachedArea.GetContentHash() == contentHash);
+			return texture;
+		}
+
+		return nullptr;
+	}
+
+	//Rehashes the texture's contents and registers it in the contents index
+	void UpdateContentHash(CTexture* texture, const uint8* ram)
+	{
+		assert(texture->m_live);
+		RemoveFromContentIndex(texture);
+		texture->m_cachedArea.UpdateContentHash(ram);
+		texture->m_contentKey = std::make_pair(texture->m_tex0 & TEX0_BUFPTR_MASK, texture->m_cachedArea.GetContentHash());
+		texture->m_contentIndexed = true;
+		m_contentIndex.emplace(texture->m_contentKey, texture);
+	}
+
 	void Insert(const CGSHandler::TEX0& tex0, TextureHandleType textureHandle)
 	{
 		auto texture = *m_textureCache.rbegin();
+		RemoveFromContentIndex(texture.get());
 		texture->Reset();
 
 		// DBZ Budokai Tenkaichi 2 and 3 use invalid (empty) buffer sizes.
@@ -92,12 +134,40 @@ public:
 	void Flush()
 	{
 		std::for_each(std::begin(m_textureCache), std::end(m_textureCache),
-		              [](TexturePtr& texture) { texture->Reset(); });
+		              [](TexturePtr& texture) { texture->m_contentIndexed = false; texture->Reset(); });
+		m_contentIndex.clear();
 	}
 
 private:
 	typedef std::shared_ptr<CTexture> TexturePtr;
 	typedef std::list<TexturePtr> TextureList;
+	typedef std::pair<uint64, uint64> ContentKey;
+
+	struct ContentKeyHasher
+	{
+		size_t operator()(const ContentKey& key) const
+		{
+			//Content hash is already well distributed
+			return static_cast<size_t>(key.first ^ key.second);
+		}
+	};
+
+	//Format (TEX0 without buffer pointer and CLUT info) and content hash to texture
+	typedef std::unordered_multimap<ContentKey, CTexture*, ContentKeyHasher> ContentIndex;
+
+	void RemoveFromContentIndex(CTexture* texture)
+	{
+		if(!texture->m_contentIndexed) return;
+		auto textureRange = m_contentIndex.equal_range(texture->m_contentKey);
+		for(auto textureIterator = textureRange.first; textureIterator != textureRange.second; textureIterator++)
+		{
+			if(textureIterator->second != texture) continue;
+			m_contentIndex.erase(textureIterator);
+			break;
+		}
+		texture->m_contentIndexed = false;
+	}
 
 	TextureList m_textureCache;
+	ContentIndex m_contentIndex;
 };
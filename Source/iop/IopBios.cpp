@@ -120,6 +120,9 @@ CIopBios::CIopBios(CMIPS& cpu, uint8* ram, uint8* spr)
     , m_vpls(reinterpret_cast<VPL*>(&m_ram[BIOS_VPL_BASE]), 1, MAX_VPL)
     , m_loadedModules(reinterpret_cast<LOADEDMODULE*>(&m_ram[BIOS_LOADEDMODULE_BASE]), 1, MAX_LOADEDMODULE)
     , m_currentThreadId(reinterpret_cast<uint32*>(m_ram + BIOS_CURRENT_THREAD_ID_BASE))
+    , m_threadLinkIndex(MAX_THREAD,
+                        [this](uint32 threadId) -> uint32& { return GetThreadLink(threadId); },
+                        [this](uint32 threadId) { return m_threads[threadId]->priority; })
 {
 	static_assert(BIOS_CALCULATED_END <= CIopBios::CONTROL_BLOCK_END, "Control block size is too small");
 	static_assert(BIOS_SYSTEM_INTRHANDLER_TABLE_BASE > CIopBios::CONTROL_BLOCK_START, "Intr handler table is outside reserved block");
@@ -157,6 +160,7 @@ void CIopBios::Reset(uint32 ramSize, const Iop::SifManPtr& sifMan)
 	m_cpu.m_State.nCOP0[CCOP_SCU::STATUS] |= CMIPS::STATUS_IE;
 
 	m_threads.FreeAll();
+	m_threadLinkIndex.Rebuild();
 	m_semaphores.FreeAll();
 	m_intrHandlers.FreeAll();
 #ifdef DEBUGGER_INCLUDED
@@ -425,6 +429,8 @@ void CIopBios::LoadState(Framework::CZipArchiveReader& archive)
 		m_cpu.m_analysis->Analyse(moduleTag.begin, moduleTag.end);
 	}
 #endif
+
+	m_threadLinkIndex.Rebuild();
 }
 
 bool CIopBios::IsIdle()
@@ -432,6 +438,11 @@ bool CIopBios::IsIdle()
 	return (m_cpu.m_State.nPC == m_idleFunctionAddress);
 }
 
+bool CIopBios::CanSkipIdleLoop()
+{
+	return IsIdle() && (GetNextReadyThread() == -1);
+}
+
 void CIopBios::InitializeModuleStarter()
 {
 	memset(m_moduleStartRequests, 0, sizeof(m_moduleStartRequests));
@@ -1611,18 +1622,12 @@ int32 CIopBios::RotateThreadReadyQueue(uint32 priority)
 		priority = thread->priority;
 	}
 
-	uint32 nextThreadId = ThreadLinkHead();
-	while(nextThreadId != 0)
+	uint32 nextThreadId = m_threadLinkIndex.FindFirst(priority);
+	if(nextThreadId != 0)
 	{
-		auto nextThread = m_threads[nextThreadId];
-		if(nextThread->priority == priority)
-		{
-			UnlinkThread(nextThreadId);
-			LinkThread(nextThreadId);
-			m_rescheduleNeeded = true;
-			break;
-		}
-		nextThreadId = nextThread->nextThreadId;
+		UnlinkThread(nextThreadId);
+		LinkThread(nextThreadId);
+		m_rescheduleNeeded = true;
 	}
 
 	return KERNEL_RESULT_OK;
@@ -1813,47 +1818,17 @@ void CIopBios::SaveThreadContext(uint32 threadId)
 
 void CIopBios::LinkThread(uint32 threadId)
 {
-	auto thread = m_threads[threadId];
-	auto nextThreadId = &ThreadLinkHead();
-	while(1)
-	{
-		assert((*nextThreadId) < MAX_THREAD);
-		if((*nextThreadId) == 0)
-		{
-			(*nextThreadId) = threadId;
-			thread->nextThreadId = 0;
-			break;
-		}
-		auto currentThread = m_threads[(*nextThreadId)];
-		if(currentThread->priority > thread->priority)
-		{
-			thread->nextThreadId = (*nextThreadId);
-			(*nextThreadId) = threadId;
-			break;
-		}
-		nextThreadId = &currentThread->nextThreadId;
-	}
+	m_threadLinkIndex.Link(threadId);
 }
 
 void CIopBios::UnlinkThread(uint32 threadId)
 {
-	THREAD* thread = m_threads[threadId];
-	uint32* nextThreadId = &ThreadLinkHead();
-	while(1)
-	{
-		if((*nextThreadId) == 0)
-		{
-			break;
-		}
-		THREAD* currentThread = m_threads[(*nextThreadId)];
-		if((*nextThreadId) == threadId)
-		{
-			(*nextThreadId) = thread->nextThreadId;
-			thread->nextThreadId = 0;
-			break;
-		}
-		nextThreadId = &currentThread->nextThreadId;
-	}
+	m_threadLinkIndex.Unlink(threadId);
+}
+
+uint32& CIopBios::GetThreadLink(uint32 threadId) const
+{
+	return (threadId == 0) ? ThreadLinkHead() : m_threads[threadId]->nextThreadId;
 }
 
 void CIopBios::Reschedule()
@@ -9,6 +9,7 @@
 #include "../ELF.h"
 #include "../OsStructManager.h"
 #include "../OsVariableWrapper.h"
+#include "../ThreadPriorityIndex.h"
 #include "Iop_BiosBase.h"
 #include "Iop_BiosStructs.h"
 #include "Iop_SifMan.h"
@@ -204,6 +205,7 @@ public:
 	void LoadState(Framework::CZipArchiveReader&) override;
 
 	bool IsIdle() override;
+	bool CanSkipIdleLoop() override;
 
 	Iop::CSysmem* GetSysmem();
 	Iop::CIoman* GetIoman();
@@ -613,6 +615,7 @@ private:
 
 	void LinkThread(uint32);
 	void UnlinkThread(uint32);
+	uint32& GetThreadLink(uint32) const;
 
 	uint32& ThreadLinkHead() const;
 	uint64& CurrentTime() const;
@@ -685,6 +688,9 @@ private:
 
 	OsVariableWrapper<uint32> m_currentThreadId;
 
+	//Index over the thread link list kept in RAM, rebuilt when that list is reset or loaded
+	CThreadPriorityIndex m_threadLinkIndex;
+
 #ifdef DEBUGGER_INCLUDED
 	BiosDebugModuleInfoArray m_moduleTags;
 #endif
@@ -0,0 +1,79 @@
+#include "IopExecutor.h"
+#include "xxhash.h"
+
+CIopExecutor::CIopExecutor(CMIPS& context, uint32 maxAddress)
+    : CGenericMipsExecutor(context, maxAddress, BLOCK_CATEGORY_PS2_IOP)
+{
+}
+
+void CIopExecutor::Reset()
+{
+	//Active blocks can be reused after the reset, make sure they don't hold on to links to other blocks
+	for(const auto& block : m_blocks)
+	{
+		OrphanBlock(block.get());
+	}
+	if(m_cachedBlockCount > MAX_CACHED_BLOCK_COUNT)
+	{
+		m_cachedBlocks.clear();
+		m_cachedBlockCount = 0;
+	}
+	CGenericMipsExecutor::Reset();
+}
+
+BasicBlockPtr CIopExecutor::BlockFactory(CMIPS& context, uint32 start, uint32 end)
+{
+	uint32 blockSize = (end - start) + 4;
+	assert(blockSize <= (MAX_BLOCK_SIZE + 4));
+
+	uint32 blockMemory[(MAX_BLOCK_SIZE / 4) + 1];
+	for(uint32 address = start; address <= end; address += 4)
+	{
+		uint32 index = (address - start) / 4;
+		uint32 opcode = m_context.m_pMemoryMap->GetInstruction(address);
+		blockMemory[index] = opcode;
+	}
+
+	auto xxHash = XXH3_128bits(blockMemory, blockSize);
+	uint128 hash;
+	memcpy(&hash, &xxHash, sizeof(xxHash));
+	static_assert(sizeof(hash) == sizeof(xxHash));
+	auto blockKey = std::make_pair(hash, blockSize);
+
+	//Don't use the cached blocks if we have a breakpoint in our block range.
+	bool hasBreakpoint = m_context.HasBreakpointInRange(start, end);
+	if(!hasBreakpoint)
+	{
+		auto blockIterator = m_cachedBlocks.find(blockKey);
+		if(blockIterator != std::end(m_cachedBlocks))
+		{
+			auto& cachedBlocks = blockIterator->second;
+			//Check if we have a block that has the same contents and the same range.
+			for(const auto& basicBlock : cachedBlocks)
+			{
+				if(basicBlock->GetBeginAddress() == start && basicBlock->GetEndAddress() == end)
+				{
+					return basicBlock;
+				}
+			}
+			//Same contents but not the same range (ie.: module loaded at another address or through a RAM mirror).
+			//Generated code only refers to addresses relative to the block's beginning, so we can reuse it.
+			assert(!cachedBlocks.empty());
+			auto result = std::make_shared<CBasicBlock>(context, start, end, m_blockCategory);
+			result->CopyFunctionFrom(cachedBlocks.front());
+			cachedBlocks.push_back(result);
+			m_cachedBlockCount++;
+			return result;
+		}
+	}
+
+	//Totally new block, build it from scratch
+	auto result = std::make_shared<CBasicBlock>(context, start, end, m_blockCategory);
+	result->Compile();
+	if(!hasBreakpoint)
+	{
+		m_cachedBlocks[blockKey].push_back(result);
+		m_cachedBlockCount++;
+	}
+	return result;
+}
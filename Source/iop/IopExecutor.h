@@ -0,0 +1,41 @@
+#pragma once
+
+#include <unordered_map>
+#include "../GenericMipsExecutor.h"
+
+class CIopExecutor : public CGenericMipsExecutor<BlockLookupOneWay>
+{
+public:
+	CIopExecutor(CMIPS&, uint32);
+	virtual ~CIopExecutor() = default;
+
+	void Reset() override;
+
+protected:
+	//Content hash and size of the block, doesn't depend on where the block is located
+	typedef std::pair<uint128, uint32> CachedBlockKey;
+
+	enum
+	{
+		//Cached blocks survive resets (modules are reloaded at the same place after a LoadExecPS2).
+		//Drop them once we have too many to avoid growing forever.
+		MAX_CACHED_BLOCK_COUNT = 0x10000,
+	};
+
+	struct CachedBlockKeyHasher
+	{
+		size_t operator()(const CachedBlockKey& key) const
+		{
+			//Key is already a content hash, no need to mix it again
+			return static_cast<size_t>(key.first.nD0 ^ key.second);
+		}
+	};
+
+	typedef std::vector<BasicBlockPtr> CachedBlockList;
+	typedef std::unordered_map<CachedBlockKey, CachedBlockList, CachedBlockKeyHasher> CachedBlockMap;
+
+	BasicBlockPtr BlockFactory(CMIPS&, uint32, uint32) override;
+
+	CachedBlockMap m_cachedBlocks;
+	uint32 m_cachedBlockCount = 0;
+};
@@ -24,6 +24,13 @@ namespace Iop
 
 		virtual bool IsIdle() = 0;
 
+		//True when idle and nothing but an interrupt or the passing of time can make a thread ready,
+		//running the idle loop would only find out that there's nothing to do.
+		virtual bool CanSkipIdleLoop()
+		{
+			return false;
+		}
+
 		virtual void PreLoadState(){};
 		virtual void SaveState(Framework::CZipArchiveWriter&) = 0;
 		virtual void LoadState(Framework::CZipArchiveReader&) = 0;
@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <algorithm>
 #include <cstring>
 #include "Iop_RootCounters.h"
 #include "Iop_Intc.h"
@@ -81,6 +82,8 @@ unsigned int CRootCounters::GetCounterIdByAddress(uint32 address)
 void CRootCounters::Reset()
 {
 	memset(&m_counter, 0, sizeof(m_counter));
+	m_pendingTicks = 0;
+	ComputeNextEventTicks();
 }
 
 void CRootCounters::LoadState(Framework::CZipArchiveReader& archive)
@@ -95,10 +98,13 @@ void CRootCounters::LoadState(Framework::CZipArchiveReader& archive)
 		counter.target = registerFile.GetRegister32((counterPrefix + "TGT").c_str());
 		counter.clockRemain = registerFile.GetRegister32((counterPrefix + "REM").c_str());
 	}
+	m_pendingTicks = 0;
+	ComputeNextEventTicks();
 }
 
 void CRootCounters::SaveState(Framework::CZipArchiveWriter& archive)
 {
+	FlushPendingTicks();
 	auto registerFile = std::make_unique<CRegisterStateFile>(STATE_REGS_XML);
 	for(unsigned int i = 0; i < MAX_COUNTERS; i++)
 	{
@@ -114,55 +120,106 @@ void CRootCounters::SaveState(Framework::CZipArchiveWriter& archive)
 
 void CRootCounters::Update(unsigned int ticks)
 {
-	for(unsigned int i = 0; i < MAX_COUNTERS; i++)
+	m_pendingTicks += ticks;
+	if(m_pendingTicks < m_nextEventTicks) return;
+	UpdateCounters(m_pendingTicks);
+	m_pendingTicks = 0;
+	ComputeNextEventTicks();
+}
+
+uint32 CRootCounters::GetCounterClockRatio(unsigned int i) const
+{
+	const auto& counter = m_counter[i];
+	uint32 clockRatio = 1;
+	if(i == 0 && counter.mode.clc)
 	{
-		auto& counter = m_counter[i];
-		if(i == 2 && counter.mode.en) continue;
-		//Compute count increment
-		uint32 clockRatio = 1;
-		if(i == 0 && counter.mode.clc)
-		{
-			clockRatio = m_pixelClocks;
-		}
-		if(((i == 1) || (i == 3)) && counter.mode.clc)
-		{
-			clockRatio = m_hsyncClocks;
-		}
-		if(i == 2 && (counter.mode.div != COUNTER_SCALE_1))
+		clockRatio = m_pixelClocks;
+	}
+	if(((i == 1) || (i == 3)) && counter.mode.clc)
+	{
+		clockRatio = m_hsyncClocks;
+	}
+	if(i == 2 && (counter.mode.div != COUNTER_SCALE_1))
+	{
+		assert(counter.mode.div == COUNTER_SCALE_8);
+		clockRatio = 8;
+	}
+	if(
+	    ((i == 4) || (i == 5)) &&
+	    (counter.mode.div != COUNTER_SCALE_1))
+	{
+		switch(counter.mode.div)
 		{
-			assert(counter.mode.div == COUNTER_SCALE_8);
+		case COUNTER_SCALE_8:
 			clockRatio = 8;
+			break;
+		case COUNTER_SCALE_16:
+			clockRatio = 16;
+			break;
+		case COUNTER_SCALE_256:
+			clockRatio = 256;
+			break;
 		}
-		if(
-		    ((i == 4) || (i == 5)) &&
-		    (counter.mode.div != COUNTER_SCALE_1))
+	}
+	return clockRatio;
+}
+
+uint64 CRootCounters::GetCounterMax(unsigned int i) const
+{
+	const auto& counter = m_counter[i];
+	if(g_counterSizes[i] == 16)
+	{
+		return counter.mode.tar ? static_cast<uint16>(counter.target) : 0xFFFF;
+	}
+	else
+	{
+		return counter.mode.tar ? counter.target : 0xFFFFFFFF;
+	}
+}
+
+void CRootCounters::FlushPendingTicks()
+{
+	//Pending ticks never go past the first counter reaching its limit,
+	//so counters end up with the same values as if they were stepped on every update
+	if(m_pendingTicks == 0) return;
+	UpdateCounters(m_pendingTicks);
+	m_pendingTicks = 0;
+	ComputeNextEventTicks();
+}
+
+void CRootCounters::ComputeNextEventTicks()
+{
+	m_nextEventTicks = ~0ULL;
+	for(unsigned int i = 0; i < MAX_COUNTERS; i++)
+	{
+		const auto& counter = m_counter[i];
+		if(i == 2 && counter.mode.en) continue;
+		uint64 counterMax = GetCounterMax(i);
+		if(counter.count >= counterMax)
 		{
-			switch(counter.mode.div)
-			{
-			case COUNTER_SCALE_8:
-				clockRatio = 8;
-				break;
-			case COUNTER_SCALE_16:
-				clockRatio = 16;
-				break;
-			case COUNTER_SCALE_256:
-				clockRatio = 256;
-				break;
-			}
+			m_nextEventTicks = 0;
+			return;
 		}
-		uint32 totalTicks = counter.clockRemain + ticks;
+		//Remainder can be larger than the ratio if the clock source was changed
+		uint64 eventClocks = (counterMax - counter.count) * GetCounterClockRatio(i);
+		uint64 eventTicks = (counter.clockRemain < eventClocks) ? (eventClocks - counter.clockRemain) : 0;
+		m_nextEventTicks = std::min(m_nextEventTicks, eventTicks);
+	}
+}
+
+void CRootCounters::UpdateCounters(uint64 ticks)
+{
+	for(unsigned int i = 0; i < MAX_COUNTERS; i++)
+	{
+		auto& counter = m_counter[i];
+		if(i == 2 && counter.mode.en) continue;
+		//Compute count increment
+		uint32 clockRatio = GetCounterClockRatio(i);
+		uint64 totalTicks = counter.clockRemain + ticks;
 		uint64 countAdd = totalTicks / clockRatio;
-		counter.clockRemain = totalTicks % clockRatio;
+		counter.clockRemain = static_cast<uint32>(totalTicks % clockRatio);
 		//Update count
-		uint64 counterMax = 0;
-		if(g_counterSizes[i] == 16)
-		{
-			counterMax = counter.mode.tar ? static_cast<uint16>(counter.target) : 0xFFFF;
-		}
-		else
-		{
-			counterMax = counter.mode.tar ? counter.target : 0xFFFFFFFF;
-		}
+		uint64 counterMax = GetCounterMax(i);
 		uint64 counterTemp = static_cast<uint64>(counter.count) + countAdd;
 		if(counterTemp >= counterMax)
 		{
@@ -188,6 +245,7 @@ uint32 CRootCounters::ReadRegister(uint32 address)
 #ifdef _DEBUG
 	DisassembleRead(address);
 #endif
+	FlushPendingTicks();
 	unsigned int counterId = GetCounterIdByAddress(address);
 	unsigned int registerId = address & 0x0F;
 	assert(counterId < MAX_COUNTERS);
@@ -214,6 +272,7 @@ uint32 CRootCounters::WriteRegister(uint32 address, uint32 value)
 	unsigned int counterId = GetCounterIdByAddress(address);
 	unsigned int registerId = address & 0x0F;
 	assert(counterId < MAX_COUNTERS);
+	FlushPendingTicks();
 	COUNTER& counter = m_counter[counterId];
 	switch(registerId)
 	{
@@ -227,6 +286,7 @@ uint32 CRootCounters::WriteRegister(uint32 address, uint32 value)
 		counter.target = value;
 		break;
 	}
+	ComputeNextEventTicks();
 	return 0;
 }
 
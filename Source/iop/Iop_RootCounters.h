@@ -35,6 +35,8 @@ namespace Iop
 		void LoadState(Framework::CZipArchiveReader&);
 		void SaveState(Framework::CZipArchiveWriter&);
 
+		//Counters are only observed through their registers and interrupts, so stepping is deferred
+		//until one of them reaches its limit or a register is accessed.
 		void Update(unsigned int);
 
 		uint32 ReadRegister(uint32);
@@ -108,7 +110,15 @@ namespace Iop
 
 		static unsigned int GetCounterIdByAddress(uint32);
 
+		uint32 GetCounterClockRatio(unsigned int) const;
+		uint64 GetCounterMax(unsigned int) const;
+		void FlushPendingTicks();
+		void UpdateCounters(uint64);
+		void ComputeNextEventTicks();
+
 		COUNTER m_counter[MAX_COUNTERS];
+		uint64 m_pendingTicks = 0;
+		uint64 m_nextEventTicks = 0;
 		unsigned int m_hsyncClocks;
 		unsigned int m_pixelClocks;
 		Iop::CIntc& m_intc;
@@ -3,6 +3,10 @@
 #include "Iop_Spu2.h"
 #include "Log.h"
 #include "placeholder_def.h"
+#ifdef DEBUGGER_INCLUDED
+#include "StdStreamUtils.h"
+#include "string_format.h"
+#endif
 
 #define LOG_NAME ("iop_spu2")
 
@@ -50,9 +54,74 @@ uint32 CSpu2::ReadRegister(uint32 address)
 
 uint32 CSpu2::WriteRegister(uint32 address, uint32 value)
 {
+#ifdef DEBUGGER_INCLUDED
+	if(m_capturing)
+	{
+		CAPTURE_WRITE write;
+		write.tick = m_captureTick;
+		write.address = address;
+		write.value = value;
+		m_captureWrites.push_back(write);
+	}
+#endif
 	return ProcessRegisterAccess(m_writeDispatchInfo, address, value);
 }
 
+#ifdef DEBUGGER_INCLUDED
+
+void CSpu2::StartCapture()
+{
+	m_captureWrites.clear();
+	m_captureTick = 0;
+	m_capturing = true;
+}
+
+void CSpu2::AdvanceCapture(uint32 tickCount)
+{
+	if(!m_capturing) return;
+	m_captureTick += tickCount;
+}
+
+bool CSpu2::IsCapturing() const
+{
+	return m_capturing;
+}
+
+void CSpu2::StopCapture(const fs::path& capturePath, const uint8* ram, uint32 ramSize)
+{
+	assert(m_capturing);
+	m_capturing = false;
+
+	auto writes = std::move(m_captureWrites);
+	m_captureWrites.clear();
+
+	//RAM is saved at the end of the capture to get the samples that were uploaded while capturing.
+	//Register state from before the capture is lost, so it's best started before the game is booted.
+	auto ramPath = capturePath;
+	ramPath.replace_extension(".spuram");
+	{
+		auto ramStream = Framework::CreateOutputStdStream(ramPath.native());
+		ramStream.Write(ram, ramSize);
+	}
+
+	auto scriptPath = capturePath;
+	scriptPath.replace_extension(".spuscript");
+	{
+		auto scriptStream = Framework::CreateOutputStdStream(scriptPath.native());
+		auto header = std::string("#<tick> <register address> <value>\n");
+		scriptStream.Write(header.c_str(), header.size());
+		for(const auto& write : writes)
+		{
+			auto line = string_format("%u %08X %04X\n", write.tick, write.address, write.value);
+			scriptStream.Write(line.c_str(), line.size());
+		}
+		auto endLine = string_format("%u\n", m_captureTick);
+		scriptStream.Write(endLine.c_str(), endLine.size());
+	}
+}
+
+#endif
+
 uint32 CSpu2::ProcessRegisterAccess(const REGISTER_DISPATCH_INFO& dispatchInfo, uint32 address, uint32 value)
 {
 	uint32 tmpAddress = address - REGS_BEGIN;
@@ -3,6 +3,10 @@
 
 #include <functional>
 #include "Iop_Spu2_Core.h"
+#ifdef DEBUGGER_INCLUDED
+#include <vector>
+#include "filesystem_def.h"
+#endif
 
 namespace Iop
 {
@@ -21,6 +25,15 @@ namespace Iop
 		void Reset();
 		Spu2::CCore* GetCore(unsigned int);
 
+#ifdef DEBUGGER_INCLUDED
+		//Records register writes to be replayed by SpuTest's benchmark mode. Ticks are
+		//output samples and must be advanced by whoever renders the cores.
+		void StartCapture();
+		void AdvanceCapture(uint32);
+		bool IsCapturing() const;
+		void StopCapture(const fs::path&, const uint8*, uint32);
+#endif
+
 		enum
 		{
 			C_SPDIF_OUT = 0x1F9007C0,
@@ -56,6 +69,20 @@ namespace Iop
 		void LogRead(uint32);
 		void LogWrite(uint32, uint32);
 
+#ifdef DEBUGGER_INCLUDED
+		struct CAPTURE_WRITE
+		{
+			uint32 tick = 0;
+			uint32 address = 0;
+			uint32 value = 0;
+		};
+		typedef std::vector<CAPTURE_WRITE> CaptureWriteArray;
+
+		bool m_capturing = false;
+		uint32 m_captureTick = 0;
+		CaptureWriteArray m_captureWrites;
+#endif
+
 		REGISTER_DISPATCH_INFO m_readDispatchInfo;
 		REGISTER_DISPATCH_INFO m_writeDispatchInfo;
 		CorePtr m_core[CORE_NUM];
@@ -9,6 +9,11 @@
 #include "../states/RegisterStateUtils.h"
 #include "../states/RegisterStateFile.h"
 #include "Iop_SpuBase.h"
+#include "SimdDefs.h"
+
+#ifdef FRAMEWORK_SIMD_USE_SSE
+#include <emmintrin.h>
+#endif
 
 using namespace Iop;
 
@@ -714,132 +719,221 @@ void CSpuBase::MixSamples(int32 inputSample, int32 volumeLevel, int16* output)
 	*output = static_cast<int16>(resultSample);
 }
 
-void CSpuBase::Render(int16* samples, unsigned int sampleCount)
+#ifdef FRAMEWORK_SIMD_USE_SSE
+
+//Computes (a * b) / 0x7FFF for each lane, rounding toward zero like the scalar code.
+//Only valid if |a * b| < 2^30, which holds for samples and 15-bit volume levels.
+static __m128i MulDiv7FFF(__m128i a, __m128i b)
 {
-	bool updateReverb = m_reverbEnabled && (m_ctrl & CONTROL_REVERB) && (m_reverbWorkAddrStart < m_reverbWorkAddrEnd);
-	bool irqEnabled = (m_ctrl & CONTROL_IRQ);
+	__m128i productLo = _mm_mullo_epi16(a, b);
+	__m128i productHi = _mm_mulhi_epi16(a, b);
+	__m128i results[2] = {_mm_unpacklo_epi16(productLo, productHi), _mm_unpackhi_epi16(productLo, productHi)};
+	for(auto& result : results)
+	{
+		__m128i sign = _mm_srai_epi32(result, 31);
+		__m128i absValue = _mm_sub_epi32(_mm_xor_si128(result, sign), sign);
+		//x / 0x7FFF == (x + (x >> 15) + 1) >> 15 for 0 <= x < 2^30 - 1
+		__m128i quotient = _mm_add_epi32(absValue, _mm_srli_epi32(absValue, 15));
+		quotient = _mm_srli_epi32(_mm_add_epi32(quotient, _mm_set1_epi32(1)), 15);
+		result = _mm_sub_epi32(_mm_xor_si128(quotient, sign), sign);
+	}
+	return _mm_packs_epi32(results[0], results[1]);
+}
 
-	int16* samplesBase = samples;
-	assert((sampleCount & 0x01) == 0);
-	unsigned int ticks = sampleCount / 2;
-	memset(samples, 0, sizeof(int16) * sampleCount);
+#endif
 
-	for(unsigned int j = 0; j < ticks; j++)
+//Applies envelope and volumes to a block of voice samples and mixes them in the output buffers.
+//Buffers hold 'tickCount' entries rounded up to a multiple of 8, padding must have a null envelope.
+static void MixVoiceBlock(const int16* readSamples, const int16* adsrLevels, const int16* volumes,
+                          int16* output, int16* reverbOutput, unsigned int tickCount)
+{
+#ifdef FRAMEWORK_SIMD_USE_SSE
+	for(unsigned int i = 0; i < tickCount; i += 8)
 	{
-		int16 reverbSample[2] = {};
-		//Update channels
-		for(unsigned int i = 0; i < 24; i++)
+		__m128i readSample = _mm_load_si128(reinterpret_cast<const __m128i*>(readSamples + i));
+		__m128i adsrLevel = _mm_load_si128(reinterpret_cast<const __m128i*>(adsrLevels + i));
+		__m128i inputSample = MulDiv7FFF(readSample, adsrLevel);
+
+		//Volumes and outputs are interleaved (left, right)
+		__m128i volume0 = _mm_load_si128(reinterpret_cast<const __m128i*>(volumes + (i * 2) + 0));
+		__m128i volume1 = _mm_load_si128(reinterpret_cast<const __m128i*>(volumes + (i * 2) + 8));
+		__m128i mixed0 = MulDiv7FFF(_mm_unpacklo_epi16(inputSample, inputSample), volume0);
+		__m128i mixed1 = MulDiv7FFF(_mm_unpackhi_epi16(inputSample, inputSample), volume1);
+
+		auto outputPtr = reinterpret_cast<__m128i*>(output + (i * 2));
+		_mm_store_si128(outputPtr + 0, _mm_adds_epi16(_mm_load_si128(outputPtr + 0), mixed0));
+		_mm_store_si128(outputPtr + 1, _mm_adds_epi16(_mm_load_si128(outputPtr + 1), mixed1));
+
+		if(reverbOutput)
 		{
-			auto& channel(m_channel[i]);
-			auto& reader(m_reader[i]);
-			if(channel.status == KEY_ON)
+			auto reverbPtr = reinterpret_cast<__m128i*>(reverbOutput + (i * 2));
+			_mm_store_si128(reverbPtr + 0, _mm_adds_epi16(_mm_load_si128(reverbPtr + 0), mixed0));
+			_mm_store_si128(reverbPtr + 1, _mm_adds_epi16(_mm_load_si128(reverbPtr + 1), mixed1));
+		}
+	}
+#else
+	for(unsigned int i = 0; i < tickCount; i++)
+	{
+		int32 readSample = readSamples[i];
+		if(readSample == 0) continue;
+
+		int32 inputSample = (readSample * static_cast<int32>(adsrLevels[i])) / static_cast<int32>(0x7FFF);
+		if(inputSample == 0) continue;
+
+		CSpuBase::MixSamples(inputSample, volumes[(i * 2) + 0], output + (i * 2) + 0);
+		CSpuBase::MixSamples(inputSample, volumes[(i * 2) + 1], output + (i * 2) + 1);
+
+		if(reverbOutput)
+		{
+			CSpuBase::MixSamples(inputSample, volumes[(i * 2) + 0], reverbOutput + (i * 2) + 0);
+			CSpuBase::MixSamples(inputSample, volumes[(i * 2) + 1], reverbOutput + (i * 2) + 1);
+		}
+	}
+#endif
+}
+
+void CSpuBase::RenderVoiceBlock(unsigned int channelIndex, unsigned int tickCount, int16* output, int16* reverbOutput)
+{
+	auto& channel(m_channel[channelIndex]);
+	auto& reader(m_reader[channelIndex]);
+
+	alignas(16) int16 readSamples[RENDER_BLOCK_TICKS] = {};
+	alignas(16) int16 adsrLevels[RENDER_BLOCK_TICKS] = {};
+	alignas(16) int16 volumes[RENDER_BLOCK_TICKS * 2] = {};
+	bool hasOutput = false;
+
+	//Voice state is always stepped, even when silent: reading samples sets end flags and can trigger IRQs
+	for(unsigned int j = 0; j < tickCount; j++)
+	{
+		if(channel.status == KEY_ON)
+		{
+			reader.SetParamsRead(channel.address, channel.repeat);
+			reader.ClearEndFlag();
+			channel.status = ATTACK;
+			channel.adsrVolume = 0;
+		}
+		else
+		{
+			if(reader.IsDone())
 			{
-				reader.SetParamsRead(channel.address, channel.repeat);
-				reader.ClearEndFlag();
-				channel.status = ATTACK;
+				channel.status = STOPPED;
 				channel.adsrVolume = 0;
+				reader.ClearIsDone();
 			}
-			else
+			if(reader.DidChangeRepeat() && !channel.repeatSet)
 			{
-				if(reader.IsDone())
-				{
-					channel.status = STOPPED;
-					channel.adsrVolume = 0;
-					reader.ClearIsDone();
-				}
-				if(reader.DidChangeRepeat() && !channel.repeatSet)
-				{
-					channel.repeat = reader.GetRepeat();
-					reader.ClearDidChangeRepeat();
-				}
-				//Update repeat in case it has been changed externally (needed for FFX)
-				reader.SetRepeat(channel.repeat);
+				channel.repeat = reader.GetRepeat();
+				reader.ClearDidChangeRepeat();
 			}
+			//Update repeat in case it has been changed externally (needed for FFX)
+			reader.SetRepeat(channel.repeat);
+		}
 
-			int32 readSample = reader.GetSample();
-			channel.current = reader.GetCurrent();
+		int32 readSample = reader.GetSample();
+		channel.current = reader.GetCurrent();
 
-			UpdateAdsr(channel);
-			channel.volumeLeftAbs = ComputeChannelVolume(channel.volumeLeft, channel.volumeLeftAbs);
-			channel.volumeRightAbs = ComputeChannelVolume(channel.volumeRight, channel.volumeRightAbs);
+		UpdateAdsr(channel);
+		channel.volumeLeftAbs = ComputeChannelVolume(channel.volumeLeft, channel.volumeLeftAbs);
+		channel.volumeRightAbs = ComputeChannelVolume(channel.volumeRight, channel.volumeRightAbs);
 
-			if(readSample == 0) continue;
+		int16 adsrLevel = static_cast<int16>(channel.adsrVolume >> 16);
+		readSamples[j] = static_cast<int16>(readSample);
+		adsrLevels[j] = adsrLevel;
+		volumes[(j * 2) + 0] = static_cast<int16>(channel.volumeLeftAbs >> 16);
+		volumes[(j * 2) + 1] = static_cast<int16>(channel.volumeRightAbs >> 16);
+		hasOutput |= (readSample != 0) && (adsrLevel != 0);
+	}
 
-			//Mix in adsrVolume
-			int32 inputSample = (readSample * static_cast<int32>(channel.adsrVolume >> 16)) / static_cast<int32>(MAX_ADSR_VOLUME >> 16);
+	if(!hasOutput) return;
 
-			if(inputSample == 0) continue;
+	MixVoiceBlock(readSamples, adsrLevels, volumes, output, reverbOutput, (tickCount + 7) & ~7);
+}
 
-			int32 volumeLeft = channel.volumeLeftAbs >> 16;
-			int32 volumeRight = channel.volumeRightAbs >> 16;
+void CSpuBase::Render(int16* samples, unsigned int sampleCount)
+{
+	bool updateReverb = m_reverbEnabled && (m_ctrl & CONTROL_REVERB) && (m_reverbWorkAddrStart < m_reverbWorkAddrEnd);
+	bool irqEnabled = (m_ctrl & CONTROL_IRQ);
 
-			MixSamples(inputSample, volumeLeft, samples + 0);
-			MixSamples(inputSample, volumeRight, samples + 1);
+	int16* samplesBase = samples;
+	assert((sampleCount & 0x01) == 0);
+	unsigned int ticks = sampleCount / 2;
 
-			//Mix in reverb if enabled for this channel
-			if(updateReverb && (m_channelReverb.f & (1 << i)))
-			{
-				MixSamples(inputSample, volumeLeft, reverbSample + 0);
-				MixSamples(inputSample, volumeRight, reverbSample + 1);
-			}
-		}
+	for(unsigned int blockStart = 0; blockStart < ticks; blockStart += RENDER_BLOCK_TICKS)
+	{
+		unsigned int blockTicks = std::min<unsigned int>(ticks - blockStart, RENDER_BLOCK_TICKS);
 
-		if(!m_blockReader.CanReadSamples() && (m_blockWritePtr == SOUND_INPUT_DATA_SIZE))
+		//Voices are rendered one after the other for the whole block,
+		//samples of a given tick are still mixed in the same order.
+		alignas(16) int16 voiceSamples[RENDER_BLOCK_TICKS * 2] = {};
+		alignas(16) int16 reverbSamples[RENDER_BLOCK_TICKS * 2] = {};
+		for(unsigned int i = 0; i < MAX_CHANNEL; i++)
 		{
-			//We're ready to consume some data
-			m_blockReader.FillBlock(m_ram + m_soundInputDataAddr);
-			m_blockWritePtr = 0;
+			bool mixReverb = updateReverb && (m_channelReverb.f & (1 << i));
+			RenderVoiceBlock(i, blockTicks, voiceSamples, mixReverb ? reverbSamples : nullptr);
 		}
 
-		if(m_blockReader.CanReadSamples())
+		for(unsigned int j = 0; j < blockTicks; j++)
 		{
-			int32 blockSamples[2] = {};
-			m_blockReader.GetSamples(blockSamples);
+			samples[0] = voiceSamples[(j * 2) + 0];
+			samples[1] = voiceSamples[(j * 2) + 1];
 
-			// Audio input data should have volume adjusted to BVOL register values . . .
-			if(m_spuNumber == 0 && m_blockReader.GetSpdifBypass())
-			{
-				//  . . . unless in bypass mode
-				MixSamples(blockSamples[0], 0x7FFF, samples + 0);
-				MixSamples(blockSamples[1], 0x7FFF, samples + 1);
-			}
-			else
+			if(!m_blockReader.CanReadSamples() && (m_blockWritePtr == SOUND_INPUT_DATA_SIZE))
 			{
-				MixSamples(blockSamples[0], m_inputVolL, samples + 0);
-				MixSamples(blockSamples[1], m_inputVolR, samples + 1);
+				//We're ready to consume some data
+				m_blockReader.FillBlock(m_ram + m_soundInputDataAddr);
+				m_blockWritePtr = 0;
 			}
-		}
 
-		//Simulate SPU CORE0 writing its output in RAM and check for potential interrupts
-		if(m_spuNumber == 0)
-		{
-			if(irqEnabled)
+			if(m_blockReader.CanReadSamples())
 			{
-				//TODO: Check which core is responsible for which area
-				if(m_irqAddr == (CORE0_SIN_LEFT + m_core0OutputOffset))
+				int32 blockSamples[2] = {};
+				m_blockReader.GetSamples(blockSamples);
+
+				// Audio input data should have volume adjusted to BVOL register values . . .
+				if(m_spuNumber == 0 && m_blockReader.GetSpdifBypass())
 				{
-					m_irqPending = true;
+					//  . . . unless in bypass mode
+					MixSamples(blockSamples[0], 0x7FFF, samples + 0);
+					MixSamples(blockSamples[1], 0x7FFF, samples + 1);
 				}
-				else if(m_irqAddr == (CORE1_SIN_LEFT + m_core0OutputOffset))
+				else
 				{
-					m_irqPending = true;
+					MixSamples(blockSamples[0], m_inputVolL, samples + 0);
+					MixSamples(blockSamples[1], m_inputVolR, samples + 1);
 				}
-				else if(m_irqAddr == (CORE1_SIN_RIGHT + m_core0OutputOffset))
+			}
+
+			//Simulate SPU CORE0 writing its output in RAM and check for potential interrupts
+			if(m_spuNumber == 0)
+			{
+				if(irqEnabled)
 				{
-					m_irqPending = true;
+					//TODO: Check which core is responsible for which area
+					if(m_irqAddr == (CORE0_SIN_LEFT + m_core0OutputOffset))
+					{
+						m_irqPending = true;
+					}
+					else if(m_irqAddr == (CORE1_SIN_LEFT + m_core0OutputOffset))
+					{
+						m_irqPending = true;
+					}
+					else if(m_irqAddr == (CORE1_SIN_RIGHT + m_core0OutputOffset))
+					{
+						m_irqPending = true;
+					}
 				}
+				m_core0OutputOffset += 2;
+				m_core0OutputOffset &= (CORE0_OUTPUT_SIZE - 1);
 			}
-			m_core0OutputOffset += 2;
-			m_core0OutputOffset &= (CORE0_OUTPUT_SIZE - 1);
+
+			samples += 2;
 		}
 
-		//Update reverb
+		//Reverb only adds to the final output, it can be run after the block's other contributions
 		if(updateReverb)
 		{
-			UpdateReverb(reverbSample, samples);
+			UpdateReverb(reverbSamples, samples - (blockTicks * 2), blockTicks);
 		}
-
-		samples += 2;
 	}
 
 	if(irqEnabled && m_irqWatcher->HasPendingIrq(m_spuNumber))
@@ -864,29 +958,50 @@ uint32 CSpuBase::GetAdsrDelta(unsigned int index) const
 	return m_adsrLogTable[index + 32];
 }
 
-float CSpuBase::GetReverbSample(uint32 address) const
+uint32 CSpuBase::GetReverbAddress(uint32 offset) const
 {
-	uint32 absoluteAddress = m_reverbCurrAddr + address;
-	while(absoluteAddress >= m_reverbWorkAddrEnd)
+	uint32 address = m_reverbCurrAddr + offset;
+	if(address >= m_reverbWorkAddrEnd)
 	{
-		absoluteAddress -= m_reverbWorkAddrEnd;
-		absoluteAddress += m_reverbWorkAddrStart;
+		//Same as subtracting the work area size until we're back below the end
+		uint32 workAreaSize = m_reverbWorkAddrEnd - m_reverbWorkAddrStart;
+		uint32 excess = address - m_reverbWorkAddrEnd;
+		if(excess >= workAreaSize)
+		{
+			excess %= workAreaSize;
+		}
+		address = m_reverbWorkAddrStart + excess;
 	}
-	return static_cast<float>(*reinterpret_cast<int16*>(m_ram + absoluteAddress));
+	return address;
+}
+
+float CSpuBase::GetReverbSample(uint32 address) const
+{
+	return static_cast<float>(*reinterpret_cast<int16*>(m_ram + address));
 }
 
-void CSpuBase::SetReverbSample(uint32 address, float value)
+void CSpuBase::SetReverbSamples(const uint32* addresses, const float* values)
 {
-	uint32 absoluteAddress = m_reverbCurrAddr + address;
-	while(absoluteAddress >= m_reverbWorkAddrEnd)
+	//Stores are done in order since addresses can alias each other
+#ifdef FRAMEWORK_SIMD_USE_SSE
+	__m128 value = _mm_load_ps(values);
+	value = _mm_max_ps(value, _mm_set1_ps(SHRT_MIN));
+	value = _mm_min_ps(value, _mm_set1_ps(SHRT_MAX));
+	alignas(16) int32 intValues[4];
+	_mm_store_si128(reinterpret_cast<__m128i*>(intValues), _mm_cvttps_epi32(value));
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		*reinterpret_cast<int16*>(m_ram + addresses[i]) = static_cast<int16>(intValues[i]);
+	}
+#else
+	for(unsigned int i = 0; i < 4; i++)
 	{
-		absoluteAddress -= m_reverbWorkAddrEnd;
-		absoluteAddress += m_reverbWorkAddrStart;
+		float value = values[i];
+		value = std::max<float>(value, SHRT_MIN);
+		value = std::min<float>(value, SHRT_MAX);
+		*reinterpret_cast<int16*>(m_ram + addresses[i]) = static_cast<int16>(value);
 	}
-	value = std::max<float>(value, SHRT_MIN);
-	value = std::min<float>(value, SHRT_MAX);
-	int16 intValue = static_cast<int16>(value);
-	*reinterpret_cast<int16*>(m_ram + absoluteAddress) = intValue;
+#endif
 }
 
 uint32 CSpuBase::GetReverbOffset(unsigned int registerId) const
@@ -1007,144 +1122,239 @@ void CSpuBase::UpdateAdsr(CHANNEL& channel)
 	channel.adsrVolume = static_cast<uint32>(currentAdsrLevel);
 }
 
-void CSpuBase::UpdateReverb(int16 reverbSample[2], int16* samples)
+void CSpuBase::UpdateReverb(const int16* reverbSamples, int16* samples, unsigned int tickCount)
 {
-	//Feed samples to FIR filter
-	if(m_reverbTicks & 1)
-	{
-		//IIR_INPUT_A0 = buffer[IIR_SRC_A0] * IIR_COEF + INPUT_SAMPLE_L * IN_COEF_L;
-		//IIR_INPUT_A1 = buffer[IIR_SRC_A1] * IIR_COEF + INPUT_SAMPLE_R * IN_COEF_R;
-		//IIR_INPUT_B0 = buffer[IIR_SRC_B1] * IIR_COEF + INPUT_SAMPLE_L * IN_COEF_L;
-		//IIR_INPUT_B1 = buffer[IIR_SRC_B0] * IIR_COEF + INPUT_SAMPLE_R * IN_COEF_R;
-
-		float input_sample_l = static_cast<float>(reverbSample[0]) * 0.5f;
-		float input_sample_r = static_cast<float>(reverbSample[1]) * 0.5f;
-
-		float irr_coef = GetReverbCoef(IIR_COEF);
-		float in_coef_l = GetReverbCoef(IN_COEF_L);
-		float in_coef_r = GetReverbCoef(IN_COEF_R);
-
-		float iir_input_a0 = GetReverbSample(GetReverbOffset(IIR_SRC_A0)) * irr_coef + input_sample_l * in_coef_l;
-		float iir_input_a1 = GetReverbSample(GetReverbOffset(IIR_SRC_A1)) * irr_coef + input_sample_r * in_coef_r;
-		float iir_input_b0 = GetReverbSample(GetReverbOffset(IIR_SRC_B1)) * irr_coef + input_sample_l * in_coef_l;
-		float iir_input_b1 = GetReverbSample(GetReverbOffset(IIR_SRC_B0)) * irr_coef + input_sample_r * in_coef_r;
-
-		//IIR_A0 = IIR_INPUT_A0 * IIR_ALPHA + buffer[IIR_DEST_A0] * (1.0 - IIR_ALPHA);
-		//IIR_A1 = IIR_INPUT_A1 * IIR_ALPHA + buffer[IIR_DEST_A1] * (1.0 - IIR_ALPHA);
-		//IIR_B0 = IIR_INPUT_B0 * IIR_ALPHA + buffer[IIR_DEST_B0] * (1.0 - IIR_ALPHA);
-		//IIR_B1 = IIR_INPUT_B1 * IIR_ALPHA + buffer[IIR_DEST_B1] * (1.0 - IIR_ALPHA);
-
-		float iir_alpha = GetReverbCoef(IIR_ALPHA);
-
-		float iir_a0 = iir_input_a0 * iir_alpha + GetReverbSample(GetReverbOffset(IIR_DEST_A0)) * (1.0f - iir_alpha);
-		float iir_a1 = iir_input_a1 * iir_alpha + GetReverbSample(GetReverbOffset(IIR_DEST_A1)) * (1.0f - iir_alpha);
-		float iir_b0 = iir_input_b0 * iir_alpha + GetReverbSample(GetReverbOffset(IIR_DEST_B0)) * (1.0f - iir_alpha);
-		float iir_b1 = iir_input_b1 * iir_alpha + GetReverbSample(GetReverbOffset(IIR_DEST_B1)) * (1.0f - iir_alpha);
-
-		//buffer[IIR_DEST_A0 + 1sample] = IIR_A0;
-		//buffer[IIR_DEST_A1 + 1sample] = IIR_A1;
-		//buffer[IIR_DEST_B0 + 1sample] = IIR_B0;
-		//buffer[IIR_DEST_B1 + 1sample] = IIR_B1;
-
-		SetReverbSample(GetReverbOffset(IIR_DEST_A0) + 2, iir_a0);
-		SetReverbSample(GetReverbOffset(IIR_DEST_A1) + 2, iir_a1);
-		SetReverbSample(GetReverbOffset(IIR_DEST_B0) + 2, iir_b0);
-		SetReverbSample(GetReverbOffset(IIR_DEST_B1) + 2, iir_b1);
-
-		//ACC0 = buffer[ACC_SRC_A0] * ACC_COEF_A +
-		//	   buffer[ACC_SRC_B0] * ACC_COEF_B +
-		//	   buffer[ACC_SRC_C0] * ACC_COEF_C +
-		//	   buffer[ACC_SRC_D0] * ACC_COEF_D;
-		//ACC1 = buffer[ACC_SRC_A1] * ACC_COEF_A +
-		//	   buffer[ACC_SRC_B1] * ACC_COEF_B +
-		//	   buffer[ACC_SRC_C1] * ACC_COEF_C +
-		//	   buffer[ACC_SRC_D1] * ACC_COEF_D;
-
-		float acc_coef_a = GetReverbCoef(ACC_COEF_A);
-		float acc_coef_b = GetReverbCoef(ACC_COEF_B);
-		float acc_coef_c = GetReverbCoef(ACC_COEF_C);
-		float acc_coef_d = GetReverbCoef(ACC_COEF_D);
-
-		float acc0 =
-		    GetReverbSample(GetReverbOffset(ACC_SRC_A0)) * acc_coef_a +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_B0)) * acc_coef_b +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_C0)) * acc_coef_c +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_D0)) * acc_coef_d;
-
-		float acc1 =
-		    GetReverbSample(GetReverbOffset(ACC_SRC_A1)) * acc_coef_a +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_B1)) * acc_coef_b +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_C1)) * acc_coef_c +
-		    GetReverbSample(GetReverbOffset(ACC_SRC_D1)) * acc_coef_d;
-
-		//FB_A0 = buffer[MIX_DEST_A0 - FB_SRC_A];
-		//FB_A1 = buffer[MIX_DEST_A1 - FB_SRC_A];
-		//FB_B0 = buffer[MIX_DEST_B0 - FB_SRC_B];
-		//FB_B1 = buffer[MIX_DEST_B1 - FB_SRC_B];
-
-		float fb_a0 = GetReverbSample(GetReverbOffset(MIX_DEST_A0) - GetReverbOffset(FB_SRC_A));
-		float fb_a1 = GetReverbSample(GetReverbOffset(MIX_DEST_A1) - GetReverbOffset(FB_SRC_A));
-		float fb_b0 = GetReverbSample(GetReverbOffset(MIX_DEST_B0) - GetReverbOffset(FB_SRC_B));
-		float fb_b1 = GetReverbSample(GetReverbOffset(MIX_DEST_B1) - GetReverbOffset(FB_SRC_B));
-
-		//buffer[MIX_DEST_A0] = ACC0 - FB_A0 * FB_ALPHA;
-		//buffer[MIX_DEST_A1] = ACC1 - FB_A1 * FB_ALPHA;
-		//buffer[MIX_DEST_B0] = (FB_ALPHA * ACC0) - FB_A0 * (FB_ALPHA^0x8000) - FB_B0 * FB_X;
-		//buffer[MIX_DEST_B1] = (FB_ALPHA * ACC1) - FB_A1 * (FB_ALPHA^0x8000) - FB_B1 * FB_X;
-
-		float fb_alpha = GetReverbCoef(FB_ALPHA);
-		float fb_x = GetReverbCoef(FB_X);
-
-		SetReverbSample(GetReverbOffset(MIX_DEST_A0), acc0 - fb_a0 * fb_alpha);
-		SetReverbSample(GetReverbOffset(MIX_DEST_A1), acc1 - fb_a1 * fb_alpha);
-		SetReverbSample(GetReverbOffset(MIX_DEST_B0), (fb_alpha * acc0) - fb_a0 * -fb_alpha - fb_b0 * fb_x);
-		SetReverbSample(GetReverbOffset(MIX_DEST_B1), (fb_alpha * acc1) - fb_a1 * -fb_alpha - fb_b1 * fb_x);
-
-		m_reverbCurrAddr += 2;
-		if(m_reverbCurrAddr >= m_reverbWorkAddrEnd)
-		{
-			m_reverbCurrAddr = m_reverbWorkAddrStart;
-		}
-	}
+	//Offsets and coefficients can't change while a block is rendered, resolve them once.
+	//The four lanes hold the A0, A1, B0 and B1 filters, expressions are evaluated in the
+	//same order as the reference formulas below to keep results identical.
 
-	if(m_reverbWorkAddrStart != 0)
+	// clang-format off
+	const uint32 tapOffsets[REVERB_TAP_COUNT] =
 	{
-		float sampleL = 0.333f * (GetReverbSample(GetReverbOffset(MIX_DEST_A0)) + GetReverbSample(GetReverbOffset(MIX_DEST_B0)));
-		float sampleR = 0.333f * (GetReverbSample(GetReverbOffset(MIX_DEST_A1)) + GetReverbSample(GetReverbOffset(MIX_DEST_B1)));
+		GetReverbOffset(IIR_SRC_A0), GetReverbOffset(IIR_SRC_A1), GetReverbOffset(IIR_SRC_B1), GetReverbOffset(IIR_SRC_B0),
+		GetReverbOffset(IIR_DEST_A0), GetReverbOffset(IIR_DEST_A1), GetReverbOffset(IIR_DEST_B0), GetReverbOffset(IIR_DEST_B1),
+		GetReverbOffset(IIR_DEST_A0) + 2, GetReverbOffset(IIR_DEST_A1) + 2, GetReverbOffset(IIR_DEST_B0) + 2, GetReverbOffset(IIR_DEST_B1) + 2,
+		GetReverbOffset(ACC_SRC_A0), GetReverbOffset(ACC_SRC_A1), GetReverbOffset(ACC_SRC_B0), GetReverbOffset(ACC_SRC_B1),
+		GetReverbOffset(ACC_SRC_C0), GetReverbOffset(ACC_SRC_C1), GetReverbOffset(ACC_SRC_D0), GetReverbOffset(ACC_SRC_D1),
+		GetReverbOffset(MIX_DEST_A0) - GetReverbOffset(FB_SRC_A), GetReverbOffset(MIX_DEST_A1) - GetReverbOffset(FB_SRC_A),
+		GetReverbOffset(MIX_DEST_B0) - GetReverbOffset(FB_SRC_B), GetReverbOffset(MIX_DEST_B1) - GetReverbOffset(FB_SRC_B),
+		GetReverbOffset(MIX_DEST_A0), GetReverbOffset(MIX_DEST_A1), GetReverbOffset(MIX_DEST_B0), GetReverbOffset(MIX_DEST_B1),
+	};
+	// clang-format on
+
+	float irr_coef = GetReverbCoef(IIR_COEF);
+	float in_coef_l = GetReverbCoef(IN_COEF_L);
+	float in_coef_r = GetReverbCoef(IN_COEF_R);
+	float iir_alpha = GetReverbCoef(IIR_ALPHA);
+	float iir_alpha_inv = 1.0f - iir_alpha;
+	float acc_coef_a = GetReverbCoef(ACC_COEF_A);
+	float acc_coef_b = GetReverbCoef(ACC_COEF_B);
+	float acc_coef_c = GetReverbCoef(ACC_COEF_C);
+	float acc_coef_d = GetReverbCoef(ACC_COEF_D);
+	float fb_alpha = GetReverbCoef(FB_ALPHA);
+	float fb_x = GetReverbCoef(FB_X);
+
+	alignas(16) const float inCoefs[4] = {in_coef_l, in_coef_r, in_coef_l, in_coef_r};
+	alignas(16) const float accCoefsAB[4] = {acc_coef_a, acc_coef_a, acc_coef_b, acc_coef_b};
+	alignas(16) const float accCoefsCD[4] = {acc_coef_c, acc_coef_c, acc_coef_d, acc_coef_d};
+	alignas(16) const float mixAccCoefs[4] = {1.0f, 1.0f, fb_alpha, fb_alpha};
+	alignas(16) const float mixFbACoefs[4] = {fb_alpha, fb_alpha, -fb_alpha, -fb_alpha};
+	alignas(16) const float mixFbBCoefs[4] = {0.0f, 0.0f, fb_x, fb_x};
+
+	for(unsigned int tick = 0; tick < tickCount; tick++)
+	{
+		const int16* reverbSample = reverbSamples + (tick * 2);
 
+		if(m_reverbTicks & 1)
 		{
-			int16* output = samples + 0;
-			int32 resultSample = static_cast<int32>(sampleL) + static_cast<int32>(*output);
-			resultSample = std::max<int32>(resultSample, SHRT_MIN);
-			resultSample = std::min<int32>(resultSample, SHRT_MAX);
-			*output = static_cast<int16>(resultSample);
+			uint32 tapAddresses[REVERB_TAP_COUNT];
+			for(unsigned int i = 0; i < REVERB_TAP_COUNT; i++)
+			{
+				tapAddresses[i] = GetReverbAddress(tapOffsets[i]);
+			}
+
+			alignas(16) float iirSrc[4];
+			alignas(16) float iirDest[4];
+			for(unsigned int i = 0; i < 4; i++)
+			{
+				iirSrc[i] = GetReverbSample(tapAddresses[REVERB_TAP_IIR_SRC_A0 + i]);
+				iirDest[i] = GetReverbSample(tapAddresses[REVERB_TAP_IIR_DEST_A0 + i]);
+			}
+
+			float input_sample_l = static_cast<float>(reverbSample[0]) * 0.5f;
+			float input_sample_r = static_cast<float>(reverbSample[1]) * 0.5f;
+
+			//IIR_INPUT_A0 = buffer[IIR_SRC_A0] * IIR_COEF + INPUT_SAMPLE_L * IN_COEF_L;
+			//IIR_INPUT_A1 = buffer[IIR_SRC_A1] * IIR_COEF + INPUT_SAMPLE_R * IN_COEF_R;
+			//IIR_INPUT_B0 = buffer[IIR_SRC_B1] * IIR_COEF + INPUT_SAMPLE_L * IN_COEF_L;
+			//IIR_INPUT_B1 = buffer[IIR_SRC_B0] * IIR_COEF + INPUT_SAMPLE_R * IN_COEF_R;
+
+			//IIR_A0 = IIR_INPUT_A0 * IIR_ALPHA + buffer[IIR_DEST_A0] * (1.0 - IIR_ALPHA);
+			//IIR_A1 = IIR_INPUT_A1 * IIR_ALPHA + buffer[IIR_DEST_A1] * (1.0 - IIR_ALPHA);
+			//IIR_B0 = IIR_INPUT_B0 * IIR_ALPHA + buffer[IIR_DEST_B0] * (1.0 - IIR_ALPHA);
+			//IIR_B1 = IIR_INPUT_B1 * IIR_ALPHA + buffer[IIR_DEST_B1] * (1.0 - IIR_ALPHA);
+
+			alignas(16) float iir[4];
+#ifdef FRAMEWORK_SIMD_USE_SSE
+			{
+				__m128 inputSample = _mm_setr_ps(input_sample_l, input_sample_r, input_sample_l, input_sample_r);
+				__m128 iirInput = _mm_add_ps(
+				    _mm_mul_ps(_mm_load_ps(iirSrc), _mm_set1_ps(irr_coef)),
+				    _mm_mul_ps(inputSample, _mm_load_ps(inCoefs)));
+				__m128 iirResult = _mm_add_ps(
+				    _mm_mul_ps(iirInput, _mm_set1_ps(iir_alpha)),
+				    _mm_mul_ps(_mm_load_ps(iirDest), _mm_set1_ps(iir_alpha_inv)));
+				_mm_store_ps(iir, iirResult);
+			}
+#else
+			{
+				const float inputSample[4] = {input_sample_l, input_sample_r, input_sample_l, input_sample_r};
+				for(unsigned int i = 0; i < 4; i++)
+				{
+					float iirInput = iirSrc[i] * irr_coef + inputSample[i] * inCoefs[i];
+					iir[i] = iirInput * iir_alpha + iirDest[i] * iir_alpha_inv;
+				}
+			}
+#endif
+
+			//buffer[IIR_DEST_A0 + 1sample] = IIR_A0;
+			//buffer[IIR_DEST_A1 + 1sample] = IIR_A1;
+			//buffer[IIR_DEST_B0 + 1sample] = IIR_B0;
+			//buffer[IIR_DEST_B1 + 1sample] = IIR_B1;
+
+			SetReverbSamples(tapAddresses + REVERB_TAP_IIR_NEXT_A0, iir);
+
+			//ACC0 = buffer[ACC_SRC_A0] * ACC_COEF_A +
+			//	   buffer[ACC_SRC_B0] * ACC_COEF_B +
+			//	   buffer[ACC_SRC_C0] * ACC_COEF_C +
+			//	   buffer[ACC_SRC_D0] * ACC_COEF_D;
+			//ACC1 = buffer[ACC_SRC_A1] * ACC_COEF_A +
+			//	   buffer[ACC_SRC_B1] * ACC_COEF_B +
+			//	   buffer[ACC_SRC_C1] * ACC_COEF_C +
+			//	   buffer[ACC_SRC_D1] * ACC_COEF_D;
+
+			//FB_A0 = buffer[MIX_DEST_A0 - FB_SRC_A];
+			//FB_A1 = buffer[MIX_DEST_A1 - FB_SRC_A];
+			//FB_B0 = buffer[MIX_DEST_B0 - FB_SRC_B];
+			//FB_B1 = buffer[MIX_DEST_B1 - FB_SRC_B];
+
+			alignas(16) float accSrcAB[4];
+			alignas(16) float accSrcCD[4];
+			alignas(16) float fb[4];
+			for(unsigned int i = 0; i < 4; i++)
+			{
+				accSrcAB[i] = GetReverbSample(tapAddresses[REVERB_TAP_ACC_SRC_A0 + i]);
+				accSrcCD[i] = GetReverbSample(tapAddresses[REVERB_TAP_ACC_SRC_C0 + i]);
+				fb[i] = GetReverbSample(tapAddresses[REVERB_TAP_FB_A0 + i]);
+			}
+
+			//buffer[MIX_DEST_A0] = ACC0 - FB_A0 * FB_ALPHA;
+			//buffer[MIX_DEST_A1] = ACC1 - FB_A1 * FB_ALPHA;
+			//buffer[MIX_DEST_B0] = (FB_ALPHA * ACC0) - FB_A0 * (FB_ALPHA^0x8000) - FB_B0 * FB_X;
+			//buffer[MIX_DEST_B1] = (FB_ALPHA * ACC1) - FB_A1 * (FB_ALPHA^0x8000) - FB_B1 * FB_X;
+
+			//A lanes use a null FB_X term, only its sign can differ which is lost when storing
+			alignas(16) float mix[4];
+#ifdef FRAMEWORK_SIMD_USE_SSE
+			{
+				__m128 accAB = _mm_mul_ps(_mm_load_ps(accSrcAB), _mm_load_ps(accCoefsAB));
+				__m128 accCD = _mm_mul_ps(_mm_load_ps(accSrcCD), _mm_load_ps(accCoefsCD));
+				__m128 acc = _mm_add_ps(accAB, _mm_movehl_ps(accAB, accAB));
+				acc = _mm_add_ps(acc, accCD);
+				acc = _mm_add_ps(acc, _mm_movehl_ps(accCD, accCD));
+				acc = _mm_movelh_ps(acc, acc);
+
+				__m128 fbValues = _mm_load_ps(fb);
+				__m128 fbA = _mm_movelh_ps(fbValues, fbValues);
+				__m128 mixResult = _mm_sub_ps(
+				    _mm_mul_ps(acc, _mm_load_ps(mixAccCoefs)),
+				    _mm_mul_ps(fbA, _mm_load_ps(mixFbACoefs)));
+				mixResult = _mm_sub_ps(mixResult, _mm_mul_ps(fbValues, _mm_load_ps(mixFbBCoefs)));
+				_mm_store_ps(mix, mixResult);
+			}
+#else
+			{
+				float acc[2];
+				for(unsigned int i = 0; i < 2; i++)
+				{
+					acc[i] =
+					    accSrcAB[i + 0] * accCoefsAB[i + 0] +
+					    accSrcAB[i + 2] * accCoefsAB[i + 2] +
+					    accSrcCD[i + 0] * accCoefsCD[i + 0] +
+					    accSrcCD[i + 2] * accCoefsCD[i + 2];
+				}
+				for(unsigned int i = 0; i < 4; i++)
+				{
+					mix[i] = (acc[i & 1] * mixAccCoefs[i]) - fb[i & 1] * mixFbACoefs[i] - fb[i] * mixFbBCoefs[i];
+				}
+			}
+#endif
+
+			SetReverbSamples(tapAddresses + REVERB_TAP_MIX_DEST_A0, mix);
+
+			m_reverbCurrAddr += 2;
+			if(m_reverbCurrAddr >= m_reverbWorkAddrEnd)
+			{
+				m_reverbCurrAddr = m_reverbWorkAddrStart;
+			}
 		}
 
+		if(m_reverbWorkAddrStart != 0)
 		{
-			int16* output = samples + 1;
-			int32 resultSample = static_cast<int32>(sampleR) + static_cast<int32>(*output);
-			resultSample = std::max<int32>(resultSample, SHRT_MIN);
-			resultSample = std::min<int32>(resultSample, SHRT_MAX);
-			*output = static_cast<int16>(resultSample);
+			float mixA0 = GetReverbSample(GetReverbAddress(tapOffsets[REVERB_TAP_MIX_DEST_A0]));
+			float mixA1 = GetReverbSample(GetReverbAddress(tapOffsets[REVERB_TAP_MIX_DEST_A1]));
+			float mixB0 = GetReverbSample(GetReverbAddress(tapOffsets[REVERB_TAP_MIX_DEST_B0]));
+			float mixB1 = GetReverbSample(GetReverbAddress(tapOffsets[REVERB_TAP_MIX_DEST_B1]));
+			float sampleL = 0.333f * (mixA0 + mixB0);
+			float sampleR = 0.333f * (mixA1 + mixB1);
+
+			{
+				int16* output = samples + 0;
+				int32 resultSample = static_cast<int32>(sampleL) + static_cast<int32>(*output);
+				resultSample = std::max<int32>(resultSample, SHRT_MIN);
+				resultSample = std::min<int32>(resultSample, SHRT_MAX);
+				*output = static_cast<int16>(resultSample);
+			}
+
+			{
+				int16* output = samples + 1;
+				int32 resultSample = static_cast<int32>(sampleR) + static_cast<int32>(*output);
+				resultSample = std::max<int32>(resultSample, SHRT_MIN);
+				resultSample = std::min<int32>(resultSample, SHRT_MAX);
+				*output = static_cast<int16>(resultSample);
+			}
 		}
-	}
 
-	m_reverbTicks++;
+		samples += 2;
+		m_reverbTicks++;
+	}
 }
 
 ///////////////////////////////////////////////////////
 // CSpuSampleCache
 ///////////////////////////////////////////////////////
 
+CSpuSampleCache::CSpuSampleCache()
+    : m_slots(SLOT_COUNT)
+    , m_pageGenerations(PAGE_COUNT)
+{
+	Clear();
+}
+
 const CSpuSampleCache::ITEM* CSpuSampleCache::GetItem(const KEY& key) const
 {
-	auto range = m_cache.equal_range(key.address);
-	for(auto itemIterator = range.first; itemIterator != range.second; itemIterator++)
+	uint32 slotIndex = GetSlotIndex(key);
+	for(unsigned int i = 0; i < MAX_PROBE; i++)
 	{
-		const auto& item = itemIterator->second;
-		if((item.inS1 == key.s1) && (item.inS2 == key.s2))
+		const auto& slot = m_slots[(slotIndex + i) & (SLOT_COUNT - 1)];
+		if(slot.generation == 0) break;
+		if(
+		    (slot.address == key.address) &&
+		    (slot.item.inS1 == key.s1) &&
+		    (slot.item.inS2 == key.s2) &&
+		    IsSlotLive(slot))
 		{
-			return &item;
+			return &slot.item;
 		}
 	}
 	return nullptr;
@@ -1152,8 +1362,21 @@ const CSpuSampleCache::ITEM* CSpuSampleCache::GetItem(const KEY& key) const
 
 CSpuSampleCache::ITEM& CSpuSampleCache::RegisterItem(const KEY& key)
 {
-	auto result = m_cache.emplace(std::make_pair(key.address, ITEM()));
-	auto& item = result->second;
+	//Reuse the first free or invalidated slot, evict the home slot if the probe sequence is full
+	uint32 slotIndex = GetSlotIndex(key);
+	auto* targetSlot = &m_slots[slotIndex];
+	for(unsigned int i = 0; i < MAX_PROBE; i++)
+	{
+		auto& slot = m_slots[(slotIndex + i) & (SLOT_COUNT - 1)];
+		if(!IsSlotLive(slot))
+		{
+			targetSlot = &slot;
+			break;
+		}
+	}
+	targetSlot->address = key.address;
+	targetSlot->generation = m_pageGenerations[GetPageIndex(key.address)];
+	auto& item = targetSlot->item;
 	item.inS1 = key.s1;
 	item.inS2 = key.s2;
 	return item;
@@ -1161,14 +1384,48 @@ CSpuSampleCache::ITEM& CSpuSampleCache::RegisterItem(const KEY& key)
 
 void CSpuSampleCache::Clear()
 {
-	m_cache.clear();
+	for(auto& slot : m_slots)
+	{
+		slot.generation = 0;
+	}
+	std::fill(m_pageGenerations.begin(), m_pageGenerations.end(), 1);
 }
 
 void CSpuSampleCache::ClearRange(uint32 address, uint32 size)
 {
-	auto lowerBound = m_cache.lower_bound(address);
-	auto upperBound = m_cache.upper_bound(address + size);
-	m_cache.erase(lowerBound, upperBound);
+	if(size == 0) return;
+	uint32 firstPage = address >> PAGE_SHIFT;
+	uint32 lastPage = (address + size - 1) >> PAGE_SHIFT;
+	uint32 pageCount = std::min<uint32>(lastPage - firstPage + 1, PAGE_COUNT);
+	for(uint32 i = 0; i < pageCount; i++)
+	{
+		auto& generation = m_pageGenerations[(firstPage + i) & (PAGE_COUNT - 1)];
+		generation++;
+		//Skip the generation reserved for unused slots
+		if(generation == 0)
+		{
+			generation = 1;
+		}
+	}
+}
+
+uint32 CSpuSampleCache::GetSlotIndex(const KEY& key)
+{
+	uint32 hash = (key.address >> 4) * 0x9E3779B1;
+	hash ^= static_cast<uint32>(key.s1) * 0x85EBCA6B;
+	hash ^= static_cast<uint32>(key.s2) * 0xC2B2AE35;
+	hash ^= hash >> 15;
+	return hash & (SLOT_COUNT - 1);
+}
+
+uint32 CSpuSampleCache::GetPageIndex(uint32 address)
+{
+	return (address >> PAGE_SHIFT) & (PAGE_COUNT - 1);
+}
+
+bool CSpuSampleCache::IsSlotLive(const SLOT& slot) const
+{
+	return (slot.generation != 0) && (slot.generation == m_pageGenerations[GetPageIndex(slot.address)]);
 }
 
 ///////////////////////////////////////////////////////
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <map>
+#include <vector>
 #include "Types.h"
 #include "BasicUnion.h"
 #include "Convertible.h"
@@ -32,13 +32,40 @@ namespace Iop
 			int32 outS2;
 		};
 
+		CSpuSampleCache();
+
 		const ITEM* GetItem(const KEY&) const;
 		ITEM& RegisterItem(const KEY&);
 		void Clear();
 		void ClearRange(uint32 address, uint32 size);
 
 	private:
-		std::multimap<uint32, ITEM> m_cache;
+		enum
+		{
+			SLOT_COUNT = 0x8000,
+			MAX_PROBE = 8,
+			PAGE_SHIFT = 10,
+			PAGE_COUNT = 0x1000,
+		};
+		static_assert((SLOT_COUNT & (SLOT_COUNT - 1)) == 0, "SLOT_COUNT must be a power of 2.");
+		static_assert((PAGE_COUNT & (PAGE_COUNT - 1)) == 0, "PAGE_COUNT must be a power of 2.");
+
+		//Items are only valid while their generation matches the one of the page they
+		//were decoded from, ClearRange invalidates items by bumping page generations.
+		//A null generation marks a slot that was never used.
+		struct SLOT
+		{
+			uint32 address = 0;
+			uint32 generation = 0;
+			ITEM item;
+		};
+
+		static uint32 GetSlotIndex(const KEY&);
+		static uint32 GetPageIndex(uint32);
+		bool IsSlotLive(const SLOT&) const;
+
+		std::vector<SLOT> m_slots;
+		std::vector<uint32> m_pageGenerations;
 	};
 
 	class CSpuIrqWatcher
@@ -389,11 +416,54 @@ namespace Iop
 			MAX_ADSR_VOLUME = 0x7FFFFFFF,
 		};
 
+		enum
+		{
+			//Number of output ticks a voice is rendered for before moving to the next one
+			RENDER_BLOCK_TICKS = 64,
+		};
+		static_assert((RENDER_BLOCK_TICKS % 8) == 0, "RENDER_BLOCK_TICKS must be a multiple of 8.");
+
+		//Work area locations accessed by the reverb, grouped by 4 to match processing lanes
+		enum REVERB_TAP
+		{
+			REVERB_TAP_IIR_SRC_A0,
+			REVERB_TAP_IIR_SRC_A1,
+			REVERB_TAP_IIR_SRC_B1,
+			REVERB_TAP_IIR_SRC_B0,
+			REVERB_TAP_IIR_DEST_A0,
+			REVERB_TAP_IIR_DEST_A1,
+			REVERB_TAP_IIR_DEST_B0,
+			REVERB_TAP_IIR_DEST_B1,
+			REVERB_TAP_IIR_NEXT_A0,
+			REVERB_TAP_IIR_NEXT_A1,
+			REVERB_TAP_IIR_NEXT_B0,
+			REVERB_TAP_IIR_NEXT_B1,
+			REVERB_TAP_ACC_SRC_A0,
+			REVERB_TAP_ACC_SRC_A1,
+			REVERB_TAP_ACC_SRC_B0,
+			REVERB_TAP_ACC_SRC_B1,
+			REVERB_TAP_ACC_SRC_C0,
+			REVERB_TAP_ACC_SRC_C1,
+			REVERB_TAP_ACC_SRC_D0,
+			REVERB_TAP_ACC_SRC_D1,
+			REVERB_TAP_FB_A0,
+			REVERB_TAP_FB_A1,
+			REVERB_TAP_FB_B0,
+			REVERB_TAP_FB_B1,
+			REVERB_TAP_MIX_DEST_A0,
+			REVERB_TAP_MIX_DEST_A1,
+			REVERB_TAP_MIX_DEST_B0,
+			REVERB_TAP_MIX_DEST_B1,
+			REVERB_TAP_COUNT,
+		};
+
+		void RenderVoiceBlock(unsigned int, unsigned int, int16*, int16*);
 		void UpdateAdsr(CHANNEL&);
-		void UpdateReverb(int16[2], int16*);
+		void UpdateReverb(const int16*, int16*, unsigned int);
 		uint32 GetAdsrDelta(unsigned int) const;
+		uint32 GetReverbAddress(uint32) const;
 		float GetReverbSample(uint32) const;
-		void SetReverbSample(uint32, float);
+		void SetReverbSamples(const uint32*, const float*);
 		uint32 GetReverbOffset(unsigned int) const;
 		float GetReverbCoef(unsigned int) const;
 
@@ -1,6 +1,6 @@
 #include "Iop_SubSystem.h"
 #include "IopBios.h"
-#include "GenericMipsExecutor.h"
+#include "IopExecutor.h"
 #include "../psx/PsxBios.h"
 #include "../states/MemoryStateFile.h"
 #include "../states/RegisterStateFile.h"
@@ -50,7 +50,7 @@ CSubSystem::CSubSystem(bool ps2Mode)
 		m_bios = std::make_shared<CPsxBios>(m_cpu, m_ram, PS2::IOP_BASE_RAM_SIZE);
 	}
 
-	m_cpu.m_executor = std::make_unique<CGenericMipsExecutor<BlockLookupOneWay>>(m_cpu, (IOP_RAM_SIZE * 4), BLOCK_CATEGORY_PS2_IOP);
+	m_cpu.m_executor = std::make_unique<CIopExecutor>(m_cpu, (IOP_RAM_SIZE * 4));
 
 	//Read memory map
 	m_cpu.m_pMemoryMap->InsertReadMap((0 * IOP_RAM_SIZE), (0 * IOP_RAM_SIZE) + IOP_RAM_SIZE - 1, m_ram, 0x01);
@@ -400,6 +400,12 @@ void CSubSystem::CountTicks(int ticks)
 
 int CSubSystem::ExecuteCpu(int quota)
 {
+	//Idle loop would only reschedule to itself, wait for an interrupt or a thread to wake up instead
+	if(!m_cpu.m_State.nHasException && !m_intc.HasPendingInterrupt() && m_bios->CanSkipIdleLoop())
+	{
+		return 0;
+	}
+
 	int executed = 0;
 	CheckPendingInterrupts();
 	if(!m_cpu.m_State.nHasException)
@@ -1,6 +1,7 @@
 #include "SH_OpenAL.h"
 #include "alloca_def.h"
 #include <assert.h>
+#include <algorithm>
 
 //#define LOGGING
 #define SAMPLE_RATE 44100
@@ -47,6 +48,8 @@ void CSH_OpenAL::Reset()
 	CHECK_AL_ERROR();
 	m_availableBuffers.clear();
 	m_availableBuffers.insert(m_availableBuffers.begin(), m_bufferNames, m_bufferNames + MAX_BUFFERS);
+	m_queuedSampleCount = 0;
+	m_isPlaying = false;
 }
 
 void CSH_OpenAL::RecycleBuffers()
@@ -58,6 +61,14 @@ void CSH_OpenAL::RecycleBuffers()
 		ALuint* bufferNames = reinterpret_cast<ALuint*>(alloca(sizeof(ALuint) * bufferCount));
 		alSourceUnqueueBuffers(m_source, bufferCount, bufferNames);
 		CHECK_AL_ERROR();
+		for(unsigned int i = 0; i < bufferCount; i++)
+		{
+			ALint bufferSize = 0;
+			alGetBufferi(bufferNames[i], AL_SIZE, &bufferSize);
+			unsigned int bufferSampleCount = bufferSize / sizeof(int16);
+			assert(bufferSampleCount <= m_queuedSampleCount);
+			m_queuedSampleCount -= std::min(bufferSampleCount, m_queuedSampleCount);
+		}
 		m_availableBuffers.insert(m_availableBuffers.begin(), bufferNames, bufferNames + bufferCount);
 	}
 }
@@ -67,6 +78,13 @@ bool CSH_OpenAL::HasFreeBuffers()
 	return m_availableBuffers.size() != 0;
 }
 
+bool CSH_OpenAL::GetQueueStatus(QUEUE_STATUS& status)
+{
+	status.queuedSamples = m_queuedSampleCount;
+	status.underrunCount = m_underrunCount;
+	return true;
+}
+
 uint32 CSH_OpenAL::GetFreeBufferCount() const
 {
 	return m_availableBuffers.size();
@@ -84,10 +102,17 @@ void CSH_OpenAL::Write(int16* samples, unsigned int sampleCount, unsigned int sa
 
 	alSourceQueueBuffers(m_source, 1, &buffer);
 	CHECK_AL_ERROR();
+	m_queuedSampleCount += sampleCount;
 
 	ALint sourceState = m_source.GetState();
 	if(sourceState != AL_PLAYING)
 	{
+		//Source stops by itself when it runs out of buffers
+		if(m_isPlaying)
+		{
+			m_underrunCount++;
+		}
+		m_isPlaying = true;
 		m_source.Play();
 		assert(m_source.GetState() == AL_PLAYING);
 	}
@@ -24,6 +24,7 @@ public:
 	void Write(int16*, unsigned int, unsigned int) override;
 	bool HasFreeBuffers() override;
 	void RecycleBuffers() override;
+	bool GetQueueStatus(QUEUE_STATUS&) override;
 
 	uint32 GetFreeBufferCount() const;
 
@@ -37,5 +38,8 @@ private:
 	BufferList m_availableBuffers;
 	uint64 m_lastUpdateTime;
 	bool m_mustSync;
+	bool m_isPlaying = false;
+	unsigned int m_queuedSampleCount = 0;
+	unsigned int m_underrunCount = 0;
 	ALuint m_bufferNames[MAX_BUFFERS];
 };
@@ -8,11 +8,24 @@ class CSoundHandler
 public:
 	typedef std::function<CSoundHandler*(void)> FactoryFunction;
 
+	struct QUEUE_STATUS
+	{
+		unsigned int queuedSamples = 0;
+		unsigned int underrunCount = 0;
+	};
+
 	virtual ~CSoundHandler() = default;
 	virtual void Reset() = 0;
 	virtual void Write(int16*, unsigned int, unsigned int) = 0;
 	virtual bool HasFreeBuffers() = 0;
 	virtual void RecycleBuffers() = 0;
 
+	//Reports how much audio is waiting to be played and how many times playback ran dry.
+	//Handlers that can't tell return false and are fed with a fixed block count.
+	virtual bool GetQueueStatus(QUEUE_STATUS&)
+	{
+		return false;
+	}
+
 private:
 };
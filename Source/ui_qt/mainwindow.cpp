@@ -1100,6 +1100,41 @@ void MainWindow::ToggleGsDraw()
 	m_msgLabel->setText(newState ? QString("GS Draw Enabled") : QString("GS Draw Disabled"));
 }
 
+fs::path MainWindow::GetSpuCaptureDirectoryPath()
+{
+	return CAppConfig::GetInstance().GetBasePath() / fs::path("spucaptures/");
+}
+
+void MainWindow::ToggleSpuCapture()
+{
+	if(debugMenuUi->actionCaptureSpu->isChecked())
+	{
+		m_virtualMachine->StartSpuCapture();
+		m_msgLabel->setText(QString("Started SPU capture."));
+		return;
+	}
+	try
+	{
+		auto captureDirectoryPath = GetSpuCaptureDirectoryPath();
+		Framework::PathUtils::EnsurePathExists(captureDirectoryPath);
+		for(unsigned int i = 0; i < UINT_MAX; i++)
+		{
+			auto captureName = string_format("spucapture_%08d", i);
+			auto capturePath = captureDirectoryPath / fs::path(captureName + ".spuscript");
+			if(!fs::exists(capturePath))
+			{
+				m_virtualMachine->StopSpuCapture(capturePath);
+				m_msgLabel->setText(QString("Saved SPU capture to '%1'.").arg(captureName.c_str()));
+				return;
+			}
+		}
+	}
+	catch(...)
+	{
+	}
+	m_msgLabel->setText(QString("Failed to save SPU capture."));
+}
+
 #endif
 
 void MainWindow::on_actionPause_when_focus_is_lost_triggered(bool checked)
@@ -1252,6 +1287,7 @@ void MainWindow::SetupDebugger()
 		connect(debugMenuUi->actionShowFrameDebugger, &QAction::triggered, this, std::bind(&MainWindow::ShowFrameDebugger, this));
 		connect(debugMenuUi->actionDumpNextFrame, &QAction::triggered, this, std::bind(&MainWindow::DumpNextFrame, this));
 		connect(debugMenuUi->actionGsDrawEnabled, &QAction::triggered, this, std::bind(&MainWindow::ToggleGsDraw, this));
+		connect(debugMenuUi->actionCaptureSpu, &QAction::triggered, this, std::bind(&MainWindow::ToggleSpuCapture, this));
 	}
 
 #if defined(__APPLE__)
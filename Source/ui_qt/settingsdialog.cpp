@@ -99,6 +99,7 @@ void SettingsDialog::LoadPreferences()
 
 	ui->checkBox_enable_audio->setChecked(CAppConfig::GetInstance().GetPreferenceBoolean(PREFERENCE_AUDIO_ENABLEOUTPUT));
 	ui->spinBox_spuBlockCount->setValue(CAppConfig::GetInstance().GetPreferenceInteger(PREF_AUDIO_SPUBLOCKCOUNT));
+	ui->checkBox_adaptiveAudioLatency->setChecked(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_AUDIO_ADAPTIVELATENCY));
 	ui->comboBox_presentation_mode->setCurrentIndex(CAppConfig::GetInstance().GetPreferenceInteger(PREF_CGSHANDLER_PRESENTATION_MODE));
 }
 
@@ -203,3 +204,8 @@ void SettingsDialog::on_spinBox_spuBlockCount_valueChanged(int value)
 {
 	CAppConfig::GetInstance().SetPreferenceInteger(PREF_AUDIO_SPUBLOCKCOUNT, value);
 }
+
+void SettingsDialog::on_checkBox_adaptiveAudioLatency_clicked(bool checked)
+{
+	CAppConfig::GetInstance().SetPreferenceBoolean(PREF_AUDIO_ADAPTIVELATENCY, checked);
+}
@@ -52,6 +52,7 @@ private slots:
 	//Audio Page
 	void on_checkBox_enable_audio_clicked(bool checked);
 	void on_spinBox_spuBlockCount_valueChanged(int value);
+	void on_checkBox_adaptiveAudioLatency_clicked(bool checked);
 
 private:
 	Ui::SettingsDialog* ui;
@@ -0,0 +1,297 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include "HleFunctionsTest.h"
+#include "AlignedAlloc.h"
+#include "COP_SCU.h"
+#include "Ps2Const.h"
+#include "ee/EeExecutor.h"
+#include "ee/Ee_HleFunctions.h"
+
+#define EXECUTE_CYCLES (0x100000)
+#define SYSCALL_OPCODE (0x0000000C)
+
+// clang-format off
+static const uint32 g_memcpyCode[] =
+{
+	0x0080402D,    //DADDU          T0, A0, R0
+	0x2CC20020,    //SLTIU          V0, A2, $0020
+	0x1440001C,    //BNE            V0, R0, $+0x1C
+	0x0100182D,    //DADDU          V1, T0, R0
+	0x00A81025,    //OR             V0, A1, T0
+	0x3042000F,    //ANDI           V0, V0, $000F
+	0x54400019,    //BNEL           V0, R0, $+0x19
+	0x24C6FFFF,    //ADDIU          A2, A2, $FFFF
+	0x0100382D,    //DADDU          A3, T0, R0
+	0x78A30000,    //LQ             V1, $0000(A1)
+	0x24C6FFE0,    //ADDIU          A2, A2, $FFE0
+	0x24A50010,    //ADDIU          A1, A1, $0010
+	0x2CC40020,    //SLTIU          A0, A2, $0020
+	0x7CE30000,    //SQ             V1, $0000(A3)
+	0x24E70010,    //ADDIU          A3, A3, $0010
+	0x78A20000,    //LQ             V0, $0000(A1)
+	0x24A50010,    //ADDIU          A1, A1, $0010
+	0x7CE20000,    //SQ             V0, $0000(A3)
+	0x1080FFF6,    //BEQ            A0, R0, $-0x0A
+	0x24E70010,    //ADDIU          A3, A3, $0010
+	0x2CC20008,    //SLTIU          V0, A2, $0008
+	0x14400009,    //BNE            V0, R0, $+0x09
+	0x00E0182D,    //DADDU          V1, A3, R0
+	0xDCA30000,    //LD             V1, $0000(A1)
+	0x24C6FFF8,    //ADDIU          A2, A2, $FFF8
+	0x24A50008,    //ADDIU          A1, A1, $0008
+	0x2CC20008,    //SLTIU          V0, A2, $0008
+	0xFCE30000,    //SD             V1, $0000(A3)
+	0x1040FFFA,    //BEQ            V0, R0, $-0x06
+	0x24E70008,    //ADDIU          A3, A3, $0008
+	0x00E0182D,    //DADDU          V1, A3, R0
+	0x24C6FFFF,    //ADDIU          A2, A2, $FFFF
+	0x2402FFFF,    //ADDIU          V0, R0, $FFFF
+	0x10C20008,    //BEQ            A2, V0, $+0x08
+	0x0040202D,    //DADDU          A0, V0, R0
+	0x90A20000,    //LBU            V0, $0000(A1)
+	0x24C6FFFF,    //ADDIU          A2, A2, $FFFF
+	0x24A50001,    //ADDIU          A1, A1, $0001
+	0xA0620000,    //SB             V0, $0000(V1)
+	0x24630001,    //ADDIU          V1, V1, $0001
+	0x14C4FFFA,    //BNE            A2, A0, $-0x06
+	0x00000000,    //NOP
+	0x03E00008,    //JR             RA
+	0x0100102D,    //DADDU          V0, T0, R0
+};
+
+static const uint32 g_memsetCode[] =
+{
+	0x2CC20008,    //SLTIU          V0, A2, $0008
+	0x1440001E,    //BNE            V0, R0, $+0x1E
+	0x0080182D,    //DADDU          V1, A0, R0
+	0x3082000F,    //ANDI           V0, A0, $000F
+	0x1440001B,    //BNE            V0, R0, $+0x1B
+	0x0080382D,    //DADDU          A3, A0, R0
+	0x30A900FF,    //ANDI           T1, A1, $00FF
+	0x2CCA0020,    //SLTIU          T2, A2, $0020
+	0x0120402D,    //DADDU          T0, T1, R0
+	0x00081A38,    //DSLL           V1, T0, 8
+	0x00694025,    //OR             T0, V1, T1
+	0x70081EE9,    //PCPYH          V1, T0
+	0x15400010,    //BNE            T2, R0, $+0x10
+	0x2CC20008,    //SLTIU          V0, A2, $0008
+	0x70634389,    //PCPYLD         T0, V1, V1
+	0x7CE80000,    //SQ             T0, $0000(A3)
+	0x24C6FFE0,    //ADDIU          A2, A2, $FFE0
+	0x24E70010,    //ADDIU          A3, A3, $0010
+	0x2CC20020,    //SLTIU          V0, A2, $0020
+	0x7CE80000,    //SQ             T0, $0000(A3)
+	0x1040FFFA,    //BEQ            V0, R0, $-0x06
+	0x24E70010,    //ADDIU          A3, A3, $0010
+	0x10000006,    //BEQ            R0, R0, $+0x06
+	0x2CC20008,    //SLTIU          V0, A2, $0008
+	0x24C6FFF8,    //ADDIU          A2, A2, $FFF8
+	0x24E70008,    //ADDIU          A3, A3, $0008
+	0x2CC20008,    //SLTIU          V0, A2, $0008
+	0x00000000,    //NOP
+	0x00000000,    //NOP
+	0x5040FFFA,    //BEQL           V0, R0, $-0x06
+	0xFCE30000,    //SD             V1, $0000(A3)
+	0x00E0182D,    //DADDU          V1, A3, R0
+	0x3C02FFFF,    //LUI            V0, $FFFF
+	0x24C6FFFF,    //ADDIU          A2, A2, $FFFF
+	0x3442FFFF,    //ORI            V0, V0, $FFFF
+	0x10C2000A,    //BEQ            A2, V0, $+0x0A
+	0x00000000,    //NOP
+	0x3C02FFFF,    //LUI            V0, $FFFF
+	0x3442FFFF,    //ORI            V0, V0, $FFFF
+	0xA0650000,    //SB             A1, $0000(V1)
+	0x24C6FFFF,    //ADDIU          A2, A2, $FFFF
+	0x00000000,    //NOP
+	0x00000000,    //NOP
+	0x00000000,    //NOP
+	0x14C2FFFA,    //BNE            A2, V0, $-0x06
+	0x24630001,    //ADDIU          V1, V1, $0001
+	0x03E00008,    //JR             RA
+	0x0080102D,    //DADDU          V0, A0, R0
+};
+// clang-format on
+
+CHleFunctionsTest::CHleFunctionsTest()
+    : m_context(MEMORYMAP_ENDIAN_LSBF, true)
+    , m_ram(reinterpret_cast<uint8*>(framework_aligned_alloc(PS2::EE_RAM_SIZE, framework_getpagesize())))
+{
+	memset(m_ram, 0, PS2::EE_RAM_SIZE);
+
+	m_context.m_executor = std::make_unique<CEeExecutor>(m_context, m_ram);
+
+	m_context.m_pMemoryMap->InsertReadMap(0x00000000, PS2::EE_RAM_SIZE - 1, m_ram, 0x00);
+	m_context.m_pMemoryMap->InsertWriteMap(0x00000000, PS2::EE_RAM_SIZE - 1, m_ram, 0x00);
+	m_context.m_pMemoryMap->InsertInstructionMap(0x00000000, PS2::EE_RAM_SIZE - 1, m_ram, 0x00);
+
+	m_context.m_pArch = &m_arch;
+	m_context.m_pAddrTranslator = CMIPS::TranslateAddress64;
+
+	m_context.MapPages(0x00000000, PS2::EE_RAM_SIZE, m_ram);
+}
+
+CHleFunctionsTest::~CHleFunctionsTest()
+{
+	m_context.m_executor->Reset();
+	framework_aligned_free(m_ram);
+}
+
+void CHleFunctionsTest::Execute()
+{
+	CheckPatternMatching();
+	CheckMemcpy();
+	CheckMemset();
+}
+
+void CHleFunctionsTest::CheckPatternMatching()
+{
+	Code memcpyCode(std::begin(g_memcpyCode), std::end(g_memcpyCode));
+	Code memsetCode(std::begin(g_memsetCode), std::end(g_memsetCode));
+
+	TEST_VERIFY(IsFunctionFound(memcpyCode));
+	TEST_VERIFY(IsFunctionFound(memsetCode));
+
+	//Other known layouts, loop increment moved in or out of the branch's delay slot
+	{
+		auto code = memcpyCode;
+		std::swap(code[39], code[41]);
+		TEST_VERIFY(IsFunctionFound(code));
+	}
+
+	{
+		auto code = memsetCode;
+		code[41] = 0x24630001;
+		code[42] = 0x00000000;
+		code[43] = 0x00000000;
+		code[44] = 0x14C2FFFA;
+		code[45] = 0x00000000;
+		TEST_VERIFY(IsFunctionFound(code));
+	}
+
+	//NOP moved before the branch, the delay slot now holds the return
+	{
+		auto code = memcpyCode;
+		code[40] = 0x00000000;
+		code[41] = 0x14C4FFF9;
+		TEST_VERIFY(!IsFunctionFound(code));
+	}
+
+	//Branch leaving the function
+	{
+		auto code = memsetCode;
+		code[35] = 0x10C20100;
+		TEST_VERIFY(!IsFunctionFound(code));
+	}
+}
+
+void CHleFunctionsTest::CheckMemcpy()
+{
+	Code code(std::begin(g_memcpyCode), std::end(g_memcpyCode));
+
+	//Aligned
+	CompareCalls(code, BUFFER_ADDRESS + 0x1000, BUFFER_ADDRESS, 0x100, true);
+	CompareCalls(code, BUFFER_ADDRESS + 0x1000, BUFFER_ADDRESS, 0x10B, true);
+
+	//Unaligned
+	CompareCalls(code, BUFFER_ADDRESS + 0x1003, BUFFER_ADDRESS + 0x11, 0x75, true);
+	CompareCalls(code, BUFFER_ADDRESS + 0x1000, BUFFER_ADDRESS + 0x08, 0x40, true);
+
+	//Small
+	CompareCalls(code, BUFFER_ADDRESS + 0x1000, BUFFER_ADDRESS, 0x05, true);
+	CompareCalls(code, BUFFER_ADDRESS + 0x1001, BUFFER_ADDRESS + 0x02, 0x01, true);
+
+	//Zero
+	CompareCalls(code, BUFFER_ADDRESS + 0x1000, BUFFER_ADDRESS, 0, true);
+
+	//Overlapping, falls back to the guest code
+	CompareCalls(code, BUFFER_ADDRESS + 0x10, BUFFER_ADDRESS, 0x80, false);
+}
+
+void CHleFunctionsTest::CheckMemset()
+{
+	Code code(std::begin(g_memsetCode), std::end(g_memsetCode));
+
+	//Aligned
+	CompareCalls(code, BUFFER_ADDRESS + 0x100, 0x5A, 0x200, true);
+	CompareCalls(code, BUFFER_ADDRESS + 0x100, 0x1234A5, 0x4D, true);
+
+	//Unaligned
+	CompareCalls(code, BUFFER_ADDRESS + 0x103, 0xC3, 0x40, true);
+
+	//Small
+	CompareCalls(code, BUFFER_ADDRESS + 0x100, 0xFF, 0x07, true);
+	CompareCalls(code, BUFFER_ADDRESS + 0x105, 0x01, 0x03, true);
+
+	//Zero
+	CompareCalls(code, BUFFER_ADDRESS + 0x100, 0x77, 0, true);
+}
+
+bool CHleFunctionsTest::IsFunctionFound(const Code& code)
+{
+	LoadCode(code);
+	auto functions = Ee::CHleFunctions::FindFunctions(m_ram, PS2::EE_RAM_SIZE, FUNCTION_ADDRESS, FUNCTION_ADDRESS + CODE_AREA_SIZE);
+	return (functions.size() == 1) && (functions.count(FUNCTION_ADDRESS) == 1);
+}
+
+void CHleFunctionsTest::CompareCalls(const Code& code, uint32 a0, uint32 a1, uint32 a2, bool handledNatively)
+{
+	auto guestResult = Call(code, false, a0, a1, a2);
+	auto nativeResult = Call(code, true, a0, a1, a2);
+
+	TEST_VERIFY(!guestResult.handledNatively);
+	TEST_VERIFY(nativeResult.handledNatively == handledNatively);
+	TEST_VERIFY(guestResult.returnValue == nativeResult.returnValue);
+	TEST_VERIFY(guestResult.buffer == nativeResult.buffer);
+}
+
+CHleFunctionsTest::CALL_RESULT CHleFunctionsTest::Call(const Code& code, bool native, uint32 a0, uint32 a1, uint32 a2)
+{
+	auto executor = static_cast<CEeExecutor*>(m_context.m_executor.get());
+	executor->Reset();
+
+	TEST_VERIFY(IsFunctionFound(code));
+	FillBuffer();
+
+	if(native)
+	{
+		executor->SetHleFunctionBlocks(Ee::CHleFunctions::FindFunctions(m_ram, PS2::EE_RAM_SIZE, FUNCTION_ADDRESS, FUNCTION_ADDRESS + CODE_AREA_SIZE));
+	}
+
+	auto& state = m_context.m_State;
+	state.nPC = FUNCTION_ADDRESS;
+	state.nDelayedJumpAddr = MIPS_INVALID_PC;
+	state.nHasException = MIPS_EXCEPTION_NONE;
+	state.nGPR[CMIPS::A0].nD0 = a0;
+	state.nGPR[CMIPS::A1].nD0 = a1;
+	state.nGPR[CMIPS::A2].nD0 = a2;
+	state.nGPR[CMIPS::V0].nD0 = 0;
+	state.nGPR[CMIPS::RA].nD0 = RETURN_ADDRESS;
+
+	executor->Execute(EXECUTE_CYCLES);
+	TEST_VERIFY(state.nHasException == MIPS_EXCEPTION_SYSCALL);
+	TEST_VERIFY(state.nCOP0[CCOP_SCU::EPC] == RETURN_ADDRESS);
+
+	CALL_RESULT result;
+	result.buffer = std::vector<uint8>(m_ram + BUFFER_ADDRESS, m_ram + BUFFER_ADDRESS + BUFFER_SIZE);
+	result.returnValue = state.nGPR[CMIPS::V0].nD0;
+	//Guest code always consumes the size register, the native implementation leaves it alone
+	result.handledNatively = (state.nGPR[CMIPS::A2].nD0 == a2);
+	return result;
+}
+
+void CHleFunctionsTest::LoadCode(const Code& code)
+{
+	assert((code.size() * 4) <= CODE_AREA_SIZE);
+	memset(m_ram + FUNCTION_ADDRESS, 0, CODE_AREA_SIZE);
+	memcpy(m_ram + FUNCTION_ADDRESS, code.data(), code.size() * 4);
+	*reinterpret_cast<uint32*>(m_ram + RETURN_ADDRESS) = SYSCALL_OPCODE;
+}
+
+void CHleFunctionsTest::FillBuffer()
+{
+	for(uint32 i = 0; i < BUFFER_SIZE; i++)
+	{
+		m_ram[BUFFER_ADDRESS + i] = static_cast<uint8>((i * 0x1F) + 0x35);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+#include "MIPS.h"
+#include "ee/MA_EE.h"
+
+//Runs the guest memcpy/memset and their native implementations on the same inputs and compares the results
+class CHleFunctionsTest : public CTest
+{
+public:
+	CHleFunctionsTest();
+	virtual ~CHleFunctionsTest();
+
+	void Execute() override;
+
+private:
+	enum
+	{
+		FUNCTION_ADDRESS = 0x10000,
+		RETURN_ADDRESS = 0x11000,
+		BUFFER_ADDRESS = 0x20000,
+		BUFFER_SIZE = 0x2000,
+		CODE_AREA_SIZE = 0x1000,
+	};
+
+	typedef std::vector<uint32> Code;
+
+	struct CALL_RESULT
+	{
+		std::vector<uint8> buffer;
+		uint64 returnValue = 0;
+		bool handledNatively = false;
+	};
+
+	void CheckPatternMatching();
+	void CheckMemcpy();
+	void CheckMemset();
+
+	bool IsFunctionFound(const Code&);
+	void CompareCalls(const Code&, uint32, uint32, uint32, bool);
+	CALL_RESULT Call(const Code&, bool, uint32, uint32, uint32);
+
+	void LoadCode(const Code&);
+	void FillBuffer();
+
+	CMIPS m_context;
+	CMA_EE m_arch;
+	uint8* m_ram = nullptr;
+};
@@ -1,3 +1,4 @@
+#include <vector>
 #include "GsCachedAreaTest.h"
 #include "gs/GsCachedArea.h"
 #include "gs/GSHandler.h"
@@ -9,6 +10,7 @@ void CGsCachedAreaTest::Execute()
 	CheckDirtyRect();
 	CheckClearDirtyPages();
 	CheckInvalidate();
+	CheckContentHash();
 }
 
 void CGsCachedAreaTest::CheckEmptyArea()
@@ -154,3 +156,75 @@ void CGsCachedAreaTest::CheckInvalidate()
 		TEST_VERIFY(dirtyRect.height == 2);
 	}
 }
+
+void CGsCachedAreaTest::CheckContentHash()
+{
+	auto pixelFormat = CGSHandler::PSMCT32;
+	uint32 areaWidth = 256;
+	uint32 areaHeight = 256;
+
+	std::vector<uint8> ram(CGSHandler::RAMSIZE, 0);
+
+	CGsCachedArea area1;
+	area1.SetArea(pixelFormat, 0, areaWidth, areaHeight);
+	uint32 areaSize = area1.GetSize();
+
+	CGsCachedArea area2;
+	area2.SetArea(pixelFormat, areaSize, areaWidth, areaHeight);
+
+	for(uint32 i = 0; i < areaSize; i++)
+	{
+		ram[i] = static_cast<uint8>(i * 7);
+		ram[areaSize + i] = static_cast<uint8>(i * 7);
+	}
+
+	//Freshly set areas need to be hashed
+	TEST_VERIFY(!area1.IsContentHashValid());
+	TEST_VERIFY(!area2.IsContentHashValid());
+
+	area1.UpdateContentHash(ram.data());
+	area2.UpdateContentHash(ram.data());
+	TEST_VERIFY(area1.IsContentHashValid());
+	TEST_VERIFY(area2.IsContentHashValid());
+	TEST_VERIFY(area1.GetContentHash() == area2.GetContentHash());
+
+	//Modify a page in the second area
+	uint32 pageOffset = CGsPixelFormats::PAGESIZE * 2;
+	ram[areaSize + pageOffset] ^= 0xFF;
+	area2.Invalidate(areaSize + pageOffset, 1);
+	TEST_VERIFY(!area2.IsContentHashValid());
+
+	area2.UpdateContentHash(ram.data());
+	TEST_VERIFY(area1.GetContentHash() != area2.GetContentHash());
+
+	//Restore the page, hash should match again
+	ram[areaSize + pageOffset] ^= 0xFF;
+	area2.Invalidate(areaSize + pageOffset, 1);
+	area2.UpdateContentHash(ram.data());
+	TEST_VERIFY(area1.GetContentHash() == area2.GetContentHash());
+
+	//Area wrapping around the end of GS memory should hash like the same data stored contiguously
+	{
+		uint32 wrapAreaStart = CGSHandler::RAMSIZE - CGsPixelFormats::PAGESIZE / 2;
+		for(uint32 i = 0; i < areaSize; i++)
+		{
+			ram[(wrapAreaStart + i) & (CGSHandler::RAMSIZE - 1)] = static_cast<uint8>(i * 13);
+		}
+
+		CGsCachedArea wrapArea;
+		wrapArea.SetArea(pixelFormat, wrapAreaStart, areaWidth, areaHeight);
+		wrapArea.UpdateContentHash(ram.data());
+		TEST_VERIFY(wrapArea.IsContentHashValid());
+
+		std::vector<uint8> linearRam(CGSHandler::RAMSIZE, 0);
+		for(uint32 i = 0; i < areaSize; i++)
+		{
+			linearRam[i] = static_cast<uint8>(i * 13);
+		}
+
+		CGsCachedArea linearArea;
+		linearArea.SetArea(pixelFormat, 0, areaWidth, areaHeight);
+		linearArea.UpdateContentHash(linearRam.data());
+		TEST_VERIFY(wrapArea.GetContentHash() == linearArea.GetContentHash());
+	}
+}
@@ -12,4 +12,5 @@ private:
 	void CheckDirtyRect();
 	void CheckClearDirtyPages();
 	void CheckInvalidate();
+	void CheckContentHash();
 };
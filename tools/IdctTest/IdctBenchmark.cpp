@@ -0,0 +1,44 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+#include "IdctBenchmark.h"
+#include "ee/IPU_FastIdct.h"
+#include "idct/IEEE1180.h"
+
+void CIdctBenchmark::Execute()
+{
+	std::vector<int16> blocks(BLOCK_COUNT * 0x40);
+	CIeee1180Test::CRandom random;
+	for(unsigned int blockIndex = 0; blockIndex < BLOCK_COUNT; blockIndex++)
+	{
+		CIeee1180Test::GenerateInput(random, 256, 255, 1, blocks.data() + (blockIndex * 0x40));
+	}
+
+	Run("IEEE1180", [](const int16* input, int16* output) { IDCT::CIEEE1180::GetInstance()->Transform(input, output); }, blocks.data());
+	Run("FastIdct Scalar", &IPU::CFastIdct::TransformScalar, blocks.data());
+#ifdef FRAMEWORK_SIMD_USE_SSE
+	Run("FastIdct SSE", &IPU::CFastIdct::TransformSse, blocks.data());
+#endif
+}
+
+void CIdctBenchmark::Run(const char* name, CIeee1180Test::TransformFunction transform, const int16* blocks)
+{
+	int16 output[0x40];
+	int32 checksum = 0;
+	auto startTime = std::chrono::steady_clock::now();
+	for(unsigned int iteration = 0; iteration < ITERATION_COUNT; iteration++)
+	{
+		for(unsigned int blockIndex = 0; blockIndex < BLOCK_COUNT; blockIndex++)
+		{
+			transform(blocks + (blockIndex * 0x40), output);
+			//Keeps the transform from being optimized away
+			checksum += output[blockIndex & 0x3F];
+		}
+	}
+	auto endTime = std::chrono::steady_clock::now();
+	auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+
+	uint32 transformCount = BLOCK_COUNT * ITERATION_COUNT;
+	printf("%s: %u blocks, %.2f ns per block (checksum %d).\r\n",
+	       name, transformCount, static_cast<double>(duration) / static_cast<double>(transformCount), checksum);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Test.h"
+#include "Ieee1180Test.h"
+
+//Compares the speed of the fast IDCT implementations with the reference IEEE 1180 IDCT.
+//Only run in benchmark mode, timings are not meaningful as part of regular tests.
+class CIdctBenchmark : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	enum
+	{
+		BLOCK_COUNT = 4096,
+		ITERATION_COUNT = 100,
+	};
+
+	void Run(const char*, CIeee1180Test::TransformFunction, const int16*);
+};
@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include "Ieee1180Test.h"
+
+static const double g_pi = 3.14159265358979323846;
+
+//Basis values indexed by [position][frequency]
+struct COSINE_TABLE
+{
+	COSINE_TABLE()
+	{
+		for(unsigned int position = 0; position < 8; position++)
+		{
+			for(unsigned int frequency = 0; frequency < 8; frequency++)
+			{
+				double scale = (frequency == 0) ? std::sqrt(0.5) : 1.0;
+				values[position][frequency] = scale * std::cos(static_cast<double>((2 * position + 1) * frequency) * g_pi / 16.0);
+			}
+		}
+	}
+
+	double values[8][8];
+};
+
+static double GetCosine(unsigned int position, unsigned int frequency)
+{
+	static const COSINE_TABLE table;
+	return table.values[position][frequency];
+}
+
+static int32 Round(double value)
+{
+	return static_cast<int32>(std::floor(value + 0.5));
+}
+
+CIeee1180Test::CIeee1180Test(const char* name, TransformFunction transform)
+    : m_name(name)
+    , m_transform(transform)
+{
+}
+
+void CIeee1180Test::Execute()
+{
+	//Ranges and signs specified by the standard
+	TestRange(256, 255, 1);
+	TestRange(5, 5, 1);
+	TestRange(300, 300, 1);
+	TestRange(256, 255, -1);
+	TestRange(5, 5, -1);
+	TestRange(300, 300, -1);
+	TestZero();
+}
+
+int32 CIeee1180Test::CRandom::Next(int32 low, int32 high)
+{
+	m_state = (m_state * 1103515245) + 12345;
+	double value = static_cast<double>(m_state & 0x7FFFFFFE) / static_cast<double>(0x7FFFFFFF);
+	value *= static_cast<double>(low + high + 1);
+	return static_cast<int32>(value) - low;
+}
+
+void CIeee1180Test::GenerateInput(CRandom& random, int32 low, int32 high, int32 sign, int16* block)
+{
+	double pixels[0x40];
+	for(unsigned int i = 0; i < 0x40; i++)
+	{
+		pixels[i] = static_cast<double>(random.Next(low, high) * sign);
+	}
+
+	//Separable transform, rows first then columns
+	double rows[0x40];
+	for(unsigned int y = 0; y < 8; y++)
+	{
+		for(unsigned int u = 0; u < 8; u++)
+		{
+			double sum = 0;
+			for(unsigned int x = 0; x < 8; x++)
+			{
+				sum += pixels[(y * 8) + x] * GetCosine(x, u);
+			}
+			rows[(y * 8) + u] = sum;
+		}
+	}
+
+	for(unsigned int v = 0; v < 8; v++)
+	{
+		for(unsigned int u = 0; u < 8; u++)
+		{
+			double sum = 0;
+			for(unsigned int y = 0; y < 8; y++)
+			{
+				sum += rows[(y * 8) + u] * GetCosine(y, v);
+			}
+			block[(v * 8) + u] = static_cast<int16>(std::clamp(Round(sum / 4.0), -2048, 2047));
+		}
+	}
+}
+
+void CIeee1180Test::ReferenceTransform(const int16* input, int16* output)
+{
+	double rows[0x40];
+	for(unsigned int v = 0; v < 8; v++)
+	{
+		for(unsigned int x = 0; x < 8; x++)
+		{
+			double sum = 0;
+			for(unsigned int u = 0; u < 8; u++)
+			{
+				sum += static_cast<double>(input[(v * 8) + u]) * GetCosine(x, u);
+			}
+			rows[(v * 8) + x] = sum;
+		}
+	}
+
+	for(unsigned int y = 0; y < 8; y++)
+	{
+		for(unsigned int x = 0; x < 8; x++)
+		{
+			double sum = 0;
+			for(unsigned int v = 0; v < 8; v++)
+			{
+				sum += rows[(v * 8) + x] * GetCosine(y, v);
+			}
+			output[(y * 8) + x] = static_cast<int16>(std::clamp(Round(sum / 4.0), -256, 255));
+		}
+	}
+}
+
+void CIeee1180Test::TestRange(int32 low, int32 high, int32 sign)
+{
+	CRandom random;
+	int32 peakError = 0;
+	int64 errorSums[0x40] = {};
+	int64 squaredErrorSums[0x40] = {};
+
+	for(unsigned int blockIndex = 0; blockIndex < BLOCK_COUNT; blockIndex++)
+	{
+		int16 input[0x40];
+		int16 referenceOutput[0x40];
+		int16 output[0x40];
+		GenerateInput(random, low, high, sign, input);
+		ReferenceTransform(input, referenceOutput);
+		m_transform(input, output);
+
+		for(unsigned int i = 0; i < 0x40; i++)
+		{
+			int32 error = static_cast<int32>(output[i]) - static_cast<int32>(referenceOutput[i]);
+			peakError = std::max(peakError, std::abs(error));
+			errorSums[i] += error;
+			squaredErrorSums[i] += error * error;
+		}
+	}
+
+	double peakMeanSquaredError = 0;
+	double peakMeanError = 0;
+	double totalSquaredError = 0;
+	double totalError = 0;
+	for(unsigned int i = 0; i < 0x40; i++)
+	{
+		double meanSquaredError = static_cast<double>(squaredErrorSums[i]) / static_cast<double>(BLOCK_COUNT);
+		double meanError = static_cast<double>(errorSums[i]) / static_cast<double>(BLOCK_COUNT);
+		peakMeanSquaredError = std::max(peakMeanSquaredError, meanSquaredError);
+		peakMeanError = std::max(peakMeanError, std::abs(meanError));
+		totalSquaredError += static_cast<double>(squaredErrorSums[i]);
+		totalError += static_cast<double>(errorSums[i]);
+	}
+	double overallMeanSquaredError = totalSquaredError / (64.0 * static_cast<double>(BLOCK_COUNT));
+	double overallMeanError = totalError / (64.0 * static_cast<double>(BLOCK_COUNT));
+
+	printf("%s [-%d, %d] x %d: peak error %d, peak mse %.4f, overall mse %.4f, peak mean error %.4f, overall mean error %.5f.\r\n",
+	       m_name, low, high, sign, peakError, peakMeanSquaredError, overallMeanSquaredError, peakMeanError, overallMeanError);
+
+	TEST_VERIFY(peakError <= 1);
+	TEST_VERIFY(peakMeanSquaredError <= 0.06);
+	TEST_VERIFY(overallMeanSquaredError <= 0.02);
+	TEST_VERIFY(peakMeanError <= 0.015);
+	TEST_VERIFY(std::abs(overallMeanError) <= 0.0015);
+}
+
+void CIeee1180Test::TestZero()
+{
+	int16 input[0x40] = {};
+	int16 output[0x40];
+	std::fill(std::begin(output), std::end(output), 1);
+	m_transform(input, output);
+	for(unsigned int i = 0; i < 0x40; i++)
+	{
+		TEST_VERIFY(output[i] == 0);
+	}
+}
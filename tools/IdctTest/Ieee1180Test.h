@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Test.h"
+#include "Types.h"
+
+//Runs the IEEE 1180-1990 accuracy procedure against an 8x8 IDCT implementation
+class CIeee1180Test : public CTest
+{
+public:
+	typedef void (*TransformFunction)(const int16*, int16*);
+
+	CIeee1180Test(const char*, TransformFunction);
+
+	void Execute() override;
+
+	//Random number generator specified by the standard, returns values in [-low, high]
+	class CRandom
+	{
+	public:
+		int32 Next(int32, int32);
+
+	private:
+		uint32 m_state = 1;
+	};
+
+	//Fills a coefficient block from random pixel values the way the standard does (forward DCT, rounding and clamping)
+	static void GenerateInput(CRandom&, int32, int32, int32, int16*);
+
+private:
+	enum
+	{
+		BLOCK_COUNT = 10000,
+	};
+
+	void TestRange(int32, int32, int32);
+	void TestZero();
+
+	static void ReferenceTransform(const int16*, int16*);
+
+	const char* m_name = nullptr;
+	TransformFunction m_transform = nullptr;
+};
@@ -0,0 +1,36 @@
+#include <cstring>
+#include <functional>
+#include "IdctBenchmark.h"
+#include "Ieee1180Test.h"
+#include "ee/IPU_FastIdct.h"
+
+typedef std::function<CTest*()> TestFactoryFunction;
+
+// clang-format off
+static const TestFactoryFunction s_factories[] =
+{
+	[]() { return new CIeee1180Test("FastIdct Scalar", &IPU::CFastIdct::TransformScalar); },
+#ifdef FRAMEWORK_SIMD_USE_SSE
+	[]() { return new CIeee1180Test("FastIdct SSE", &IPU::CFastIdct::TransformSse); },
+#endif
+};
+// clang-format on
+
+int main(int argc, const char** argv)
+{
+	//Usage: IdctTest [--benchmark]
+	if((argc >= 2) && !strcmp(argv[1], "--benchmark"))
+	{
+		CIdctBenchmark benchmark;
+		benchmark.Execute();
+		return 0;
+	}
+
+	for(const auto& factory : s_factories)
+	{
+		auto test = factory();
+		test->Execute();
+		delete test;
+	}
+	return 0;
+}
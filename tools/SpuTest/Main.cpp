@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <functional>
+#include <vector>
 #include "DefaultAppConfig.h"
 #include "KeyOnOffTest.h"
 #include "MultiCoreIrqTest.h"
+#include "RenderBenchmark.h"
+#include "SampleCacheTest.h"
 #include "SetRepeatTest.h"
 #include "SetRepeatTest2.h"
 #include "SimpleIrqTest.h"
@@ -14,6 +20,7 @@ static const TestFactoryFunction s_factories[] =
 {
 	[]() { return new CKeyOnOffTest(); },
 	[]() { return new CMultiCoreIrqTest(); },
+	[]() { return new CSampleCacheTest(); },
 	[]() { return new CSetRepeatTest(); },
 	[]() { return new CSetRepeatTest2(); },
 	[]() { return new CSimpleIrqTest(); },
@@ -21,8 +28,81 @@ static const TestFactoryFunction s_factories[] =
 };
 // clang-format on
 
+static int RunCaptures(const fs::path& capturePath)
+{
+	std::vector<fs::path> capturePaths;
+	if(fs::is_directory(capturePath))
+	{
+		for(const auto& entry : fs::directory_iterator(capturePath))
+		{
+			if(entry.path().extension() == ".spuscript")
+			{
+				capturePaths.push_back(entry.path());
+			}
+		}
+		std::sort(capturePaths.begin(), capturePaths.end());
+	}
+	else
+	{
+		capturePaths.push_back(capturePath);
+	}
+
+	int result = 0;
+	for(const auto& path : capturePaths)
+	{
+		try
+		{
+			CRenderBenchmark benchmark;
+			if(!benchmark.RunCapture(path))
+			{
+				result = -1;
+			}
+		}
+		catch(const std::exception& exception)
+		{
+			printf("Error: Failed to run capture '%s': %s\r\n", path.string().c_str(), exception.what());
+			result = -1;
+		}
+	}
+	return result;
+}
+
+static int RunBenchmarks(int argc, const char** argv)
+{
+	int result = 0;
+
+	{
+		CSampleCacheTest sampleCacheTest;
+		sampleCacheTest.Benchmark();
+	}
+
+	{
+		CRenderBenchmark renderBenchmark;
+		renderBenchmark.Execute();
+		if(!renderBenchmark.HasSucceeded())
+		{
+			result = -1;
+		}
+	}
+
+	if(argc >= 3)
+	{
+		if(RunCaptures(fs::path(argv[2])) != 0)
+		{
+			result = -1;
+		}
+	}
+	return result;
+}
+
 int main(int argc, const char** argv)
 {
+	//Usage: SpuTest --benchmark [capture directory or path]
+	if((argc >= 2) && !strcmp(argv[1], "--benchmark"))
+	{
+		return RunBenchmarks(argc, argv);
+	}
+
 	for(const auto& factory : s_factories)
 	{
 		auto test = factory();
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "RenderBenchmark.h"
+#include "Ps2Const.h"
+#include "StdStream.h"
+#include "StdStreamUtils.h"
+#include "string_format.h"
+
+//Reference hash of the synthetic scene's output, might not match on hosts with different floating point behavior
+#define SCENE_EXPECTED_HASH (0xD112A600DECCEF57ULL)
+#define SCENE_TICK_COUNT (44100 * 5)
+
+void CRenderBenchmark::Execute()
+{
+	auto script = GenerateScene();
+	auto result = Render(script, SCENE_TICK_COUNT);
+	PrintResult("Synthetic scene", result);
+	m_succeeded = (result.hash == SCENE_EXPECTED_HASH);
+	if(!m_succeeded)
+	{
+		printf("Hash mismatch for synthetic scene: expected %016llX, got %016llX.\r\n",
+		       SCENE_EXPECTED_HASH, static_cast<unsigned long long>(result.hash));
+	}
+}
+
+bool CRenderBenchmark::HasSucceeded() const
+{
+	return m_succeeded;
+}
+
+bool CRenderBenchmark::RunCapture(const fs::path& capturePath)
+{
+	auto ramPath = capturePath;
+	ramPath.replace_extension(".spuram");
+	auto scriptPath = capturePath;
+	scriptPath.replace_extension(".spuscript");
+	auto resultPath = capturePath;
+	resultPath.replace_extension(".result");
+	auto expectedPath = capturePath;
+	expectedPath.replace_extension(".expected");
+
+	{
+		auto ramStream = Framework::CreateInputStdStream(ramPath.native());
+		uint64 ramSize = std::min<uint64>(ramStream.GetLength(), PS2::SPU_RAM_SIZE);
+		ramStream.Read(m_ram, ramSize);
+	}
+
+	uint32 tickCount = 0;
+	auto script = LoadScript(scriptPath, tickCount);
+	auto result = Render(script, tickCount);
+	PrintResult(capturePath.stem().string(), result);
+
+	auto hashString = string_format("%016llX", static_cast<unsigned long long>(result.hash));
+	{
+		auto resultStream = Framework::CreateOutputStdStream(resultPath.native());
+		resultStream.Write(hashString.c_str(), hashString.size());
+	}
+
+	if(!fs::exists(expectedPath))
+	{
+		return true;
+	}
+
+	auto expectedStream = Framework::CreateInputStdStream(expectedPath.native());
+	auto expectedString = expectedStream.ReadLine();
+	bool succeeded = (expectedString == hashString);
+	if(!succeeded)
+	{
+		printf("Hash mismatch for '%s': expected %s, got %s.\r\n",
+		       capturePath.stem().string().c_str(), expectedString.c_str(), hashString.c_str());
+	}
+	return succeeded;
+}
+
+CRenderBenchmark::RESULT CRenderBenchmark::Render(const RegisterScript& script, uint32 tickCount)
+{
+	RESULT result;
+	result.hash = 0xCBF29CE484222325ULL;
+	result.tickCount = tickCount;
+
+	Iop::CSpuBase* cores[CORE_COUNT] = {&m_spuCore0, &m_spuCore1};
+	std::vector<int16> samples(RENDER_CHUNK_TICKS * 2);
+	auto scriptIterator = std::begin(script);
+	uint32 currentTick = 0;
+	while(currentTick < tickCount)
+	{
+		while((scriptIterator != std::end(script)) && (scriptIterator->tick <= currentTick))
+		{
+			m_spu.WriteRegister(scriptIterator->address, scriptIterator->value);
+			scriptIterator++;
+		}
+
+		uint32 chunkEnd = std::min<uint32>(currentTick + RENDER_CHUNK_TICKS, tickCount);
+		if(scriptIterator != std::end(script))
+		{
+			chunkEnd = std::min<uint32>(chunkEnd, scriptIterator->tick);
+		}
+		uint32 chunkTicks = chunkEnd - currentTick;
+
+		for(unsigned int coreIndex = 0; coreIndex < CORE_COUNT; coreIndex++)
+		{
+			memset(samples.data(), 0, chunkTicks * 2 * sizeof(int16));
+			auto startTime = std::chrono::steady_clock::now();
+			cores[coreIndex]->Render(samples.data(), chunkTicks * 2);
+			auto endTime = std::chrono::steady_clock::now();
+			result.coreSeconds[coreIndex] += std::chrono::duration<double>(endTime - startTime).count();
+
+			for(unsigned int i = 0; i < chunkTicks * 2; i++)
+			{
+				result.hash ^= static_cast<uint16>(samples[i]);
+				result.hash *= 0x100000001B3ULL;
+			}
+		}
+
+		currentTick = chunkEnd;
+	}
+
+	return result;
+}
+
+CRenderBenchmark::RegisterScript CRenderBenchmark::GenerateScene()
+{
+	//Deterministic mix of looping and one-shot voices on both cores, with reverb on CORE0
+	static const uint32 sampleAreaStart = 0x10000;
+	static const uint32 sampleAreaSize = 0x80000;
+	static const uint32 reverbAreaStart = 0x1C0000;
+
+	uint32 randomState = 0x12345678;
+	auto nextRandom = [&randomState]() {
+		randomState = (randomState * 1103515245) + 12345;
+		return randomState >> 8;
+	};
+
+	static const uint8 flagsTable[] = {0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x04, 0x06, 0x03, 0x07};
+	for(uint32 address = sampleAreaStart; address < (sampleAreaStart + sampleAreaSize); address += 0x10)
+	{
+		m_ram[address + 0] = (nextRandom() % 13) | ((nextRandom() % 5) << 4);
+		m_ram[address + 1] = flagsTable[nextRandom() % sizeof(flagsTable)];
+		for(unsigned int i = 2; i < 0x10; i++)
+		{
+			m_ram[address + i] = static_cast<uint8>(nextRandom());
+		}
+	}
+
+	RegisterScript script;
+	auto addWrite = [&](uint32 tick, unsigned int coreIndex, uint32 address, uint32 value) {
+		REGISTER_WRITE write;
+		write.tick = tick;
+		write.address = GetCoreRegisterAddress(coreIndex, address);
+		write.value = value;
+		script.push_back(write);
+	};
+	auto addAddressWrite = [&](uint32 tick, unsigned int coreIndex, uint32 address, uint32 value) {
+		addWrite(tick, coreIndex, address + 0, (value >> 17) & 0xFFFF);
+		addWrite(tick, coreIndex, address + 2, (value >> 1) & 0xFFFF);
+	};
+
+	addWrite(0, 0, Iop::Spu2::CCore::CORE_ATTR, Iop::CSpuBase::CONTROL_REVERB);
+	addWrite(0, 1, Iop::Spu2::CCore::CORE_ATTR, 0);
+	addAddressWrite(0, 0, Iop::Spu2::CCore::A_ESA_HI, reverbAreaStart);
+	addWrite(0, 0, Iop::Spu2::CCore::A_EEA_HI, (PS2::SPU_RAM_SIZE - 1) >> 17);
+	for(uint32 i = 0; i < 22; i++)
+	{
+		addAddressWrite(0, 0, Iop::Spu2::CCore::RVB_A_REG_BASE + (i * 4), (nextRandom() % 0x4000) * 8);
+	}
+	for(uint32 i = 0; i < 10; i++)
+	{
+		addWrite(0, 0, Iop::Spu2::CCore::RVB_C_REG_BASE + (i * 2), nextRandom() & 0x7FFF);
+	}
+	addWrite(0, 0, Iop::Spu2::CCore::S_VMIXER_HI, 0xFFFF);
+	addWrite(0, 0, Iop::Spu2::CCore::S_VMIXER_LO, 0xFF);
+
+	for(uint32 tick = 0; tick < SCENE_TICK_COUNT; tick += 0x1000)
+	{
+		for(unsigned int coreIndex = 0; coreIndex < CORE_COUNT; coreIndex++)
+		{
+			uint32 keyOn = 0;
+			for(unsigned int voiceIndex = 0; voiceIndex < VOICE_COUNT; voiceIndex++)
+			{
+				if(nextRandom() % 3) continue;
+				uint32 voiceOffset = voiceIndex * 0x10;
+				uint32 startAddress = sampleAreaStart + ((nextRandom() % (sampleAreaSize / 0x10)) * 0x10);
+				addWrite(tick, coreIndex, Iop::Spu2::CCore::VP_PITCH + voiceOffset, 0x400 + (nextRandom() % 0x3000));
+				addWrite(tick, coreIndex, Iop::Spu2::CCore::VP_ADSR1 + voiceOffset, nextRandom() & 0xFFFF);
+				addWrite(tick, coreIndex, Iop::Spu2::CCore::VP_ADSR2 + voiceOffset, nextRandom() & 0xFFFF);
+				//Left volume is sometimes a linear increase/decrease or exponential decrease sweep
+				static const uint32 sweepModes[] = {0x8000, 0xA000, 0xE000};
+				uint32 volumeLeft = nextRandom() & 0x3FFF;
+				if((nextRandom() % 4) == 0)
+				{
+					volumeLeft = sweepModes[nextRandom() % 3] | (nextRandom() & 0x7F);
+				}
+				addWrite(tick, coreIndex, Iop::Spu2::CCore::VP_VOLL + voiceOffset, volumeLeft);
+				addWrite(tick, coreIndex, Iop::Spu2::CCore::VP_VOLR + voiceOffset, nextRandom() & 0x3FFF);
+				addAddressWrite(tick, coreIndex, Iop::Spu2::CCore::VA_SSA_HI + (voiceIndex * 12), startAddress);
+				keyOn |= (1 << voiceIndex);
+			}
+			addWrite(tick, coreIndex, Iop::Spu2::CCore::A_KON_HI, keyOn & 0xFFFF);
+			addWrite(tick, coreIndex, Iop::Spu2::CCore::A_KON_LO, keyOn >> 16);
+
+			uint32 keyOff = nextRandom() & 0xFFFFFF;
+			addWrite(tick + 0x800, coreIndex, Iop::Spu2::CCore::A_KOFF_HI, keyOff & 0xFFFF);
+			addWrite(tick + 0x800, coreIndex, Iop::Spu2::CCore::A_KOFF_LO, keyOff >> 16);
+		}
+	}
+
+	std::stable_sort(std::begin(script), std::end(script),
+	                 [](const REGISTER_WRITE& write1, const REGISTER_WRITE& write2) { return write1.tick < write2.tick; });
+	return script;
+}
+
+CRenderBenchmark::RegisterScript CRenderBenchmark::LoadScript(const fs::path& scriptPath, uint32& tickCount)
+{
+	//Each line is '<tick> <register address> <value>' (address and value in hex), ticks are
+	//at the output sampling rate. A line with only a tick marks the end of the capture.
+	RegisterScript script;
+	tickCount = 0;
+	auto scriptStream = Framework::CreateInputStdStream(scriptPath.native());
+	while(!scriptStream.IsEOF())
+	{
+		auto line = scriptStream.ReadLine();
+		if(line.empty() || (line[0] == '#')) continue;
+		REGISTER_WRITE write;
+		int itemCount = sscanf(line.c_str(), "%u %x %x", &write.tick, &write.address, &write.value);
+		if(itemCount == 3)
+		{
+			assert(script.empty() || (script.back().tick <= write.tick));
+			script.push_back(write);
+			tickCount = std::max<uint32>(tickCount, write.tick);
+		}
+		else if(itemCount == 1)
+		{
+			tickCount = std::max<uint32>(tickCount, write.tick);
+		}
+	}
+	return script;
+}
+
+void CRenderBenchmark::PrintResult(const std::string& name, const RESULT& result)
+{
+	printf("%s: %u ticks, hash %016llX.\r\n", name.c_str(), result.tickCount, static_cast<unsigned long long>(result.hash));
+	for(unsigned int coreIndex = 0; coreIndex < CORE_COUNT; coreIndex++)
+	{
+		double samplesPerSecond = (result.coreSeconds[coreIndex] != 0) ? (static_cast<double>(result.tickCount) / result.coreSeconds[coreIndex]) : 0;
+		printf("\tCORE%u: %.0f samples/s (%.1fx realtime).\r\n", coreIndex, samplesPerSecond, samplesPerSecond / 44100.0);
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include "filesystem_def.h"
+#include "Test.h"
+
+//Renders register scripts through both SPU cores, hashes the output and measures throughput.
+//Execute renders a synthetic scene and compares with a reference hash, RunCapture replays a RAM snapshot
+//and register script captured from a game. Only used in benchmark mode since hashes depend on the
+//host's floating point behavior.
+class CRenderBenchmark : public CTest
+{
+public:
+	void Execute() override;
+	bool HasSucceeded() const;
+
+	//Capture is made of '<name>.spuram' (raw SPU RAM) and '<name>.spuscript' (register writes).
+	//Hash is written to '<name>.result' and compared with '<name>.expected' if it exists.
+	//Captures are made with 'Debug > Capture SPU' in debugger builds and saved in the 'spucaptures' directory.
+	bool RunCapture(const fs::path&);
+
+private:
+	struct REGISTER_WRITE
+	{
+		uint32 tick = 0;
+		uint32 address = 0;
+		uint32 value = 0;
+	};
+	typedef std::vector<REGISTER_WRITE> RegisterScript;
+
+	struct RESULT
+	{
+		uint64 hash = 0;
+		uint32 tickCount = 0;
+		double coreSeconds[CORE_COUNT] = {};
+	};
+
+	enum
+	{
+		RENDER_CHUNK_TICKS = 0x200,
+	};
+
+	RESULT Render(const RegisterScript&, uint32);
+	RegisterScript GenerateScene();
+
+	static RegisterScript LoadScript(const fs::path&, uint32&);
+	static void PrintResult(const std::string&, const RESULT&);
+
+	bool m_succeeded = false;
+};
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstdio>
+#include "SampleCacheTest.h"
+
+void CSampleCacheTest::Execute()
+{
+	TestLookup();
+	TestInvalidation();
+	TestOverflow();
+}
+
+void CSampleCacheTest::TestLookup()
+{
+	m_spuSampleCache.Clear();
+
+	auto key = Iop::CSpuSampleCache::KEY{0x5000, 100, -200};
+	TEST_VERIFY(m_spuSampleCache.GetItem(key) == nullptr);
+
+	auto& item = m_spuSampleCache.RegisterItem(key);
+	item.samples[0] = 0x1234;
+	item.outS1 = 300;
+	item.outS2 = -400;
+
+	auto cachedItem = m_spuSampleCache.GetItem(key);
+	TEST_VERIFY(cachedItem != nullptr);
+	TEST_VERIFY(cachedItem->samples[0] == 0x1234);
+	TEST_VERIFY(cachedItem->outS1 == 300);
+	TEST_VERIFY(cachedItem->outS2 == -400);
+
+	//Same block decoded with different predictor state is a different item
+	TEST_VERIFY(m_spuSampleCache.GetItem(Iop::CSpuSampleCache::KEY{0x5000, 100, 0}) == nullptr);
+	TEST_VERIFY(m_spuSampleCache.GetItem(Iop::CSpuSampleCache::KEY{0x5010, 100, -200}) == nullptr);
+
+	m_spuSampleCache.Clear();
+	TEST_VERIFY(m_spuSampleCache.GetItem(key) == nullptr);
+}
+
+void CSampleCacheTest::TestInvalidation()
+{
+	m_spuSampleCache.Clear();
+
+	auto key1 = Iop::CSpuSampleCache::KEY{0x5000, 0, 0};
+	auto key2 = Iop::CSpuSampleCache::KEY{0x9000, 0, 0};
+	m_spuSampleCache.RegisterItem(key1);
+	m_spuSampleCache.RegisterItem(key2);
+
+	//Writing anywhere in the block must invalidate it
+	m_spuSampleCache.ClearRange(0x500E, 2);
+	TEST_VERIFY(m_spuSampleCache.GetItem(key1) == nullptr);
+	TEST_VERIFY(m_spuSampleCache.GetItem(key2) != nullptr);
+
+	//Block can be cached again after being invalidated
+	m_spuSampleCache.RegisterItem(key1);
+	TEST_VERIFY(m_spuSampleCache.GetItem(key1) != nullptr);
+
+	m_spuSampleCache.ClearRange(0x8000, 0x2000);
+	TEST_VERIFY(m_spuSampleCache.GetItem(key1) != nullptr);
+	TEST_VERIFY(m_spuSampleCache.GetItem(key2) == nullptr);
+}
+
+void CSampleCacheTest::TestOverflow()
+{
+	m_spuSampleCache.Clear();
+
+	//Register a lot more items than the cache can hold, most recent item must always be available
+	for(uint32 i = 0; i < 0x40000; i++)
+	{
+		auto key = Iop::CSpuSampleCache::KEY{(i * 0x10) & 0x1FFFF0, static_cast<int32>(i >> 17), 0};
+		auto& item = m_spuSampleCache.RegisterItem(key);
+		item.outS1 = i;
+		auto cachedItem = m_spuSampleCache.GetItem(key);
+		TEST_VERIFY(cachedItem != nullptr);
+		TEST_VERIFY(cachedItem->outS1 == static_cast<int32>(i));
+	}
+}
+
+void CSampleCacheTest::Benchmark()
+{
+	//Simulates looping voices going through their samples while a streaming voice keeps
+	//having its buffer rewritten through DMA.
+	enum
+	{
+		LOOP_VOICE_COUNT = 23,
+		LOOP_BLOCK_COUNT = 256,
+		STREAM_ADDRESS = 0x180000,
+		STREAM_BLOCK_COUNT = 64,
+		ITERATION_COUNT = 2000,
+	};
+
+	m_spuSampleCache.Clear();
+
+	uint64 hitCount = 0;
+	uint64 lookupCount = 0;
+	auto startTime = std::chrono::steady_clock::now();
+	for(unsigned int iteration = 0; iteration < ITERATION_COUNT; iteration++)
+	{
+		for(unsigned int voice = 0; voice < LOOP_VOICE_COUNT; voice++)
+		{
+			uint32 voiceAddress = voice * LOOP_BLOCK_COUNT * 0x10;
+			for(unsigned int block = 0; block < LOOP_BLOCK_COUNT; block++)
+			{
+				//Keep a few predictor states per block to exercise the key comparison
+				auto key = Iop::CSpuSampleCache::KEY{voiceAddress + (block * 0x10), static_cast<int32>(block & 3), 0};
+				if(m_spuSampleCache.GetItem(key))
+				{
+					hitCount++;
+				}
+				else
+				{
+					m_spuSampleCache.RegisterItem(key);
+				}
+				lookupCount++;
+			}
+		}
+		m_spuSampleCache.ClearRange(STREAM_ADDRESS, STREAM_BLOCK_COUNT * 0x10);
+		for(unsigned int block = 0; block < STREAM_BLOCK_COUNT; block++)
+		{
+			auto key = Iop::CSpuSampleCache::KEY{STREAM_ADDRESS + (block * 0x10), static_cast<int32>(iteration), 0};
+			if(!m_spuSampleCache.GetItem(key))
+			{
+				m_spuSampleCache.RegisterItem(key);
+			}
+			lookupCount++;
+		}
+	}
+	auto endTime = std::chrono::steady_clock::now();
+	auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+
+	//All looping voice blocks fit in the cache and should only miss on their first pass
+	TEST_VERIFY(hitCount == static_cast<uint64>(LOOP_VOICE_COUNT * LOOP_BLOCK_COUNT) * (ITERATION_COUNT - 1));
+
+	printf("Sample cache: %llu lookups, %.2f ns per lookup.\r\n",
+	       static_cast<unsigned long long>(lookupCount), static_cast<double>(duration) / static_cast<double>(lookupCount));
+}
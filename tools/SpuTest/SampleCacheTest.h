@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Test.h"
+
+class CSampleCacheTest : public CTest
+{
+public:
+	void Execute() override;
+
+	//Only run in benchmark mode, timings are not meaningful as part of regular tests
+	void Benchmark();
+
+private:
+	void TestLookup();
+	void TestInvalidation();
+	void TestOverflow();
+};